@@ -0,0 +1,93 @@
+#ifndef BENCH_ARRAY_H
+#define BENCH_ARRAY_H
+
+/*
+ * Baseline for the container benchmarks: a bare malloc'd array of
+ * data_size-byte elements that grows by doubling with realloc and shifts
+ * with memmove. Its function names mirror the vector_* ones so that the
+ * same benchmark body can be instantiated for both.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    char* data;
+    size_t size;
+    size_t capacity;
+    size_t data_size;
+} Array;
+
+static inline void array_create(Array* a, size_t data_size)
+{
+    a->data_size = data_size;
+    a->size = 0;
+    a->capacity = 4;
+    a->data = malloc(a->capacity * data_size);
+    assert(a->data);
+}
+
+static inline void array_free(Array* a)
+{
+    free(a->data);
+}
+
+static inline void array_reserve(Array* a, size_t capacity)
+{
+    if (capacity <= a->capacity)
+        return;
+    while (a->capacity < capacity)
+        a->capacity *= 2;
+    a->data = realloc(a->data, a->capacity * a->data_size);
+    assert(a->data);
+}
+
+static inline void* array_get(const Array* a, size_t pos)
+{
+    return a->data + pos * a->data_size;
+}
+
+static inline void array_push_back(Array* a, const void* data_ptr)
+{
+    array_reserve(a, a->size + 1);
+    memcpy(array_get(a, a->size++), data_ptr, a->data_size);
+}
+
+static inline void array_insert(Array* a, size_t pos, const void* data_ptr)
+{
+    array_reserve(a, a->size + 1);
+    memmove(array_get(a, pos + 1), array_get(a, pos),
+            (a->size - pos) * a->data_size);
+    memcpy(array_get(a, pos), data_ptr, a->data_size);
+    ++a->size;
+}
+
+static inline void array_erase(Array* a, size_t pos)
+{
+    memmove(array_get(a, pos), array_get(a, pos + 1),
+            (a->size - pos - 1) * a->data_size);
+    --a->size;
+}
+
+static inline void array_concat(Array* dest, const Array* src)
+{
+    array_reserve(dest, dest->size + src->size);
+    memcpy(array_get(dest, dest->size), src->data,
+           src->size * dest->data_size);
+    dest->size += src->size;
+}
+
+static inline void array_reverse(Array* a)
+{
+    char temp[a->data_size];
+    for (size_t i = 0; i < a->size / 2; ++i) {
+        char* x = array_get(a, i);
+        char* y = array_get(a, a->size - i - 1);
+        memcpy(temp, x, a->data_size);
+        memcpy(x, y, a->data_size);
+        memcpy(y, temp, a->data_size);
+    }
+}
+
+#endif /* BENCH_ARRAY_H */
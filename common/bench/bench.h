@@ -0,0 +1,103 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/*
+ * Helpers shared by the container benchmarks. Every benchmark takes
+ * BENCH_SAMPLES samples; a sample times a batch of operations and yields
+ * one ns/op figure, and the report gives the mean, p50, p90 and max of
+ * those figures (at this sample count a "p99" would be the second
+ * largest). Rows go to stdout as a table and, when a CSV stream is given,
+ * as one machine-readable line each, so that runs can be diffed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_SAMPLES  21
+
+typedef struct {
+    double mean;
+    double p50;
+    double p90;
+    double max;
+} BenchResult;
+
+static inline double bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static inline int bench_double_cmp(const void* a_ptr, const void* b_ptr)
+{
+    double a = *(const double*) a_ptr, b = *(const double*) b_ptr;
+    return (a > b) - (a < b);
+}
+
+/*
+ * Sorts samples in place; percentiles are nearest-rank.
+ */
+static inline BenchResult bench_summarize(double* samples, size_t n)
+{
+    BenchResult result;
+    double sum = 0;
+
+    qsort(samples, n, sizeof(double), bench_double_cmp);
+    for (size_t i = 0; i < n; ++i)
+        sum += samples[i];
+
+    result.mean = sum / n;
+    result.p50 = samples[(n - 1) * 50 / 100];
+    result.p90 = samples[(n - 1) * 90 / 100];
+    result.max = samples[n - 1];
+
+    return result;
+}
+
+static inline void bench_print_header(FILE* csv)
+{
+    printf("%-13s %-14s %9s %8s %12s %12s %12s %12s %10s\n",
+           "KIND", "OP", "DATA_SIZE", "SIZE", "mean ns", "p50 ns",
+           "p90 ns", "max ns", "vs base");
+    if (csv)
+        fprintf(csv, "kind,op,data_size,size,mean_ns,p50_ns,p90_ns,"
+                     "max_ns,p50_vs_baseline\n");
+}
+
+/*
+ * baseline is the p50 of the baseline row for the same operation (the
+ * plain array, for the sequence containers), or 0 for that row itself.
+ */
+static inline void bench_print_row(FILE* csv, const char* kind,
+                                   const char* op, size_t data_size,
+                                   size_t size, const BenchResult* r,
+                                   double baseline)
+{
+    double ratio = baseline > 0 ? r->p50 / baseline : 1.0;
+
+    printf("%-13s %-14s %9zu %8zu %12.2f %12.2f %12.2f %12.2f %9.2fx\n",
+           kind, op, data_size, size, r->mean, r->p50, r->p90, r->max,
+           ratio);
+    if (csv)
+        fprintf(csv, "%s,%s,%zu,%zu,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                kind, op, data_size, size, r->mean, r->p50, r->p90, r->max,
+                ratio);
+}
+
+/*
+ * Opens the CSV file named on the command line, if any.
+ */
+static inline FILE* bench_open_csv(int argc, char** argv)
+{
+    if (argc < 2)
+        return NULL;
+
+    FILE* csv = fopen(argv[1], "w");
+    if (!csv)
+        perror(argv[1]);
+    return csv;
+}
+
+#endif /* BENCH_H */
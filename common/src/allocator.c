@@ -0,0 +1,82 @@
+#include "allocator.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void* heap_alloc(void* ctx, size_t size);
+static void* heap_realloc(void* ctx, void* ptr,
+                          size_t old_size, size_t new_size);
+static void  heap_free(void* ctx, void* ptr, size_t size);
+
+static void* cache_aligned_alloc(void* ctx, size_t size);
+static void* cache_aligned_realloc(void* ctx, void* ptr,
+                                   size_t old_size, size_t new_size);
+
+const Allocator heap_allocator = {
+    heap_alloc,
+    heap_realloc,
+    heap_free,
+    NULL,
+};
+
+const Allocator cache_aligned_allocator = {
+    cache_aligned_alloc,
+    cache_aligned_realloc,
+    heap_free,
+    NULL,
+};
+
+/*
+ *                                  Internal.
+ */
+
+static void* heap_alloc(void* ctx, size_t size)
+{
+    (void) ctx;
+    return malloc(size);
+}
+
+static void* heap_realloc(void* ctx, void* ptr,
+                          size_t old_size, size_t new_size)
+{
+    (void) ctx;
+    (void) old_size;
+    return realloc(ptr, new_size);
+}
+
+static void heap_free(void* ctx, void* ptr, size_t size)
+{
+    (void) ctx;
+    (void) size;
+    free(ptr);
+}
+
+/*
+ * aligned_alloc() wants a multiple of the alignment.
+ */
+static void* cache_aligned_alloc(void* ctx, size_t size)
+{
+    (void) ctx;
+    size_t rounded = (size + ALLOCATOR_CACHE_LINE - 1) &
+                     ~(size_t) (ALLOCATOR_CACHE_LINE - 1);
+    return aligned_alloc(ALLOCATOR_CACHE_LINE,
+                         rounded ? rounded : ALLOCATOR_CACHE_LINE);
+}
+
+/*
+ * realloc() keeps only malloc's alignment, so move the block by hand.
+ */
+static void* cache_aligned_realloc(void* ctx, void* ptr,
+                                   size_t old_size, size_t new_size)
+{
+    void* fresh = cache_aligned_alloc(ctx, new_size);
+    if (!fresh)
+        return NULL;
+
+    if (ptr) {
+        memcpy(fresh, ptr, (old_size < new_size) ? old_size : new_size);
+        free(ptr);
+    }
+    return fresh;
+}
@@ -0,0 +1,70 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Allocator vtable. Containers route every buffer and node allocation
+ * through one of these, so they can live in arenas, pools or any other
+ * memory the caller manages. Sizes are passed back on realloc/free so that
+ * allocators without per-block headers do not have to remember them.
+ */
+
+typedef void*(*AllocFunc)(void* ctx, size_t size);
+
+typedef void*(*ReallocFunc)(void* ctx, void* ptr,
+                            size_t old_size, size_t new_size);
+
+typedef void(*DeallocFunc)(void* ctx, void* ptr, size_t size);
+
+typedef struct {
+    AllocFunc   alloc_func;
+    ReallocFunc realloc_func;
+    DeallocFunc free_func;
+    void*       ctx;
+} Allocator;
+
+#define ALLOCATOR_CACHE_LINE  64
+
+/*
+ * malloc/realloc/free.
+ */
+
+extern const Allocator heap_allocator;
+
+/*
+ * aligned_alloc/free: every block starts on an ALLOCATOR_CACHE_LINE
+ * boundary. Reallocation always copies.
+ */
+
+extern const Allocator cache_aligned_allocator;
+
+/*
+ * Dispatch.
+ */
+
+static inline void* allocator_alloc(const Allocator* a, size_t size)
+{
+    return a->alloc_func(a->ctx, size);
+}
+
+static inline void* allocator_realloc(const Allocator* a, void* ptr,
+                                      size_t old_size, size_t new_size)
+{
+    return a->realloc_func(a->ctx, ptr, old_size, new_size);
+}
+
+static inline void allocator_free(const Allocator* a, void* ptr, size_t size)
+{
+    a->free_func(a->ctx, ptr, size);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ALLOCATOR_H */
@@ -0,0 +1,162 @@
+#include "arena.h"
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALIGNMENT  alignof(max_align_t)
+
+static ArenaChunk* arenachunk_create(size_t capacity);
+
+static void* arenachunk_data(ArenaChunk*);
+
+static size_t align_up(size_t n);
+
+static void* arena_alloc_func(void* ctx, size_t size);
+static void* arena_realloc_func(void* ctx, void* ptr,
+                                size_t old_size, size_t new_size);
+static void  arena_free_func(void* ctx, void* ptr, size_t size);
+
+/*
+ *                                Construction.
+ */
+
+Arena* arena_create(Arena* arena, size_t chunk_size)
+{
+    arena->head = NULL;
+    arena->chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE;
+    arena->allocator.alloc_func = arena_alloc_func;
+    arena->allocator.realloc_func = arena_realloc_func;
+    arena->allocator.free_func = arena_free_func;
+    arena->allocator.ctx = arena;
+    return arena;
+}
+
+/*
+ *                                Destruction.
+ */
+
+void arena_free(Arena* arena)
+{
+    ArenaChunk* current_chunk;
+
+    while (arena->head) {
+        current_chunk = arena->head;
+        arena->head = arena->head->next;
+        free(current_chunk);
+    }
+}
+
+/*
+ *                                 Allocation.
+ */
+
+void* arena_alloc(Arena* arena, size_t size)
+{
+    size = align_up(size ? size : 1);
+
+    ArenaChunk* chunk = arena->head;
+
+    if (!chunk || chunk->capacity - chunk->used < size) {
+        size_t capacity = (size > arena->chunk_size) ? size : arena->chunk_size;
+        chunk = arenachunk_create(capacity);
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+
+    chunk->last = chunk->used;
+    chunk->used += size;
+
+    return (char*) arenachunk_data(chunk) + chunk->last;
+}
+
+/*
+ * Releases everything allocated so far. The newest chunk is kept for reuse
+ * and all older chunks are returned to the system.
+ */
+void arena_reset(Arena* arena)
+{
+    if (!arena->head)
+        return;
+
+    ArenaChunk* kept_chunk = arena->head;
+    arena->head = kept_chunk->next;
+    arena_free(arena);
+
+    kept_chunk->next = NULL;
+    kept_chunk->used = 0;
+    kept_chunk->last = 0;
+    arena->head = kept_chunk;
+}
+
+/*
+ *                                  Internal.
+ */
+
+static ArenaChunk* arenachunk_create(size_t capacity)
+{
+    ArenaChunk* chunk = malloc(align_up(sizeof(ArenaChunk)) + capacity);
+    assert(chunk);
+
+    chunk->next = NULL;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+    chunk->last = 0;
+
+    return chunk;
+}
+
+static void* arenachunk_data(ArenaChunk* chunk)
+{
+    return (char*) chunk + align_up(sizeof(ArenaChunk));
+}
+
+static size_t align_up(size_t n)
+{
+    return (n + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+static void* arena_alloc_func(void* ctx, size_t size)
+{
+    return arena_alloc(ctx, size);
+}
+
+/*
+ * The most recent block is grown in place when the chunk has room left,
+ * which is the common case for a single vector growing inside an arena.
+ */
+static void* arena_realloc_func(void* ctx, void* ptr,
+                                size_t old_size, size_t new_size)
+{
+    Arena* arena = ctx;
+    ArenaChunk* chunk = arena->head;
+
+    if (!ptr)
+        return arena_alloc(arena, new_size);
+
+    if (chunk && ptr == (char*) arenachunk_data(chunk) + chunk->last &&
+        chunk->capacity - chunk->last >= align_up(new_size)) {
+        chunk->used = chunk->last + align_up(new_size ? new_size : 1);
+        return ptr;
+    }
+
+    if (new_size <= old_size)
+        return ptr;
+
+    void* new_ptr = arena_alloc(arena, new_size);
+    memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+}
+
+static void arena_free_func(void* ctx, void* ptr, size_t size)
+{
+    Arena* arena = ctx;
+    ArenaChunk* chunk = arena->head;
+
+    (void) size;
+
+    if (chunk && ptr == (char*) arenachunk_data(chunk) + chunk->last)
+        chunk->used = chunk->last;
+}
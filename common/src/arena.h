@@ -0,0 +1,66 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "allocator.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ARENA_DEFAULT_CHUNK_SIZE  (64 * 1024)
+
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t capacity;
+    size_t used;
+    size_t last;
+} ArenaChunk;
+
+/*
+ * Bump-pointer arena. Allocation is a pointer increment inside the current
+ * chunk; individual frees are ignored (except for the most recent block),
+ * and everything is released at once by arena_reset() or arena_free().
+ */
+
+typedef struct {
+    ArenaChunk* head;
+    size_t chunk_size;
+    Allocator allocator;
+} Arena;
+
+/*
+ * Construction.
+ */
+
+Arena* arena_create(Arena* arena, size_t chunk_size);
+
+/*
+ * Destruction.
+ */
+
+void arena_free(Arena* arena);
+
+/*
+ * Allocation.
+ */
+
+void* arena_alloc(Arena* arena, size_t size);
+
+void arena_reset(Arena* arena);
+
+/*
+ * Allocator.
+ */
+
+static inline const Allocator* arena_allocator(const Arena* arena)
+{
+    return &arena->allocator;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARENA_H */
@@ -0,0 +1,137 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Byte hashing shared by the containers. Header-only, so that hashing a
+ * short key inlines into the caller's probe loop.
+ */
+
+#define HASH_SECRET0  0xa0761d6478bd642full
+#define HASH_SECRET1  0xe7037ed1a0b428dbull
+#define HASH_SECRET2  0x8ebc6af09c88c6e3ull
+#define HASH_SECRET3  0x589965cc75374cc3ull
+
+static inline uint64_t hash_read64(const unsigned char* p)
+{
+    uint64_t x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+static inline uint64_t hash_read32(const unsigned char* p)
+{
+    uint32_t x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+/*
+ * Full 64x64 -> 128-bit product, low half in a and high half in b. Targets
+ * without __int128 (32-bit ones) build it from four 32x32 -> 64-bit
+ * products; define HASH_NO_INT128 to use that path anywhere. Both give
+ * the same hashes.
+ */
+#if defined(__SIZEOF_INT128__) && !defined(HASH_NO_INT128)
+static inline void hash_multiply(uint64_t* a, uint64_t* b)
+{
+    unsigned __int128 r = (unsigned __int128) *a * *b;
+    *a = (uint64_t) r;
+    *b = (uint64_t) (r >> 64);
+}
+#else
+static inline void hash_multiply(uint64_t* a, uint64_t* b)
+{
+    uint64_t a_lo = (uint32_t) *a, a_hi = *a >> 32;
+    uint64_t b_lo = (uint32_t) *b, b_hi = *b >> 32;
+
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t hi_hi = a_hi * b_hi;
+
+    /* Cannot overflow: three terms below 2^32 each. */
+    uint64_t middle = (lo_lo >> 32) + (uint32_t) lo_hi + (uint32_t) hi_lo;
+
+    *a = (middle << 32) | (uint32_t) lo_lo;
+    *b = hi_hi + (lo_hi >> 32) + (hi_lo >> 32) + (middle >> 32);
+}
+#endif
+
+static inline uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+    hash_multiply(&a, &b);
+    return a ^ b;
+}
+
+/*
+ * wyhash (final version 4): 48-byte stripes go through three independent
+ * multiply-fold lanes, so the loop runs at the throughput of the 64x64
+ * multiplier rather than its latency. Not for untrusted keys.
+ */
+static inline uint64_t hash_bytes(const void* data, size_t len,
+                                  uint64_t seed)
+{
+    const unsigned char* p = (const unsigned char*) data;
+    uint64_t a, b;
+
+    seed ^= hash_mix(seed ^ HASH_SECRET0, HASH_SECRET1);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t shift = (len >> 3) << 2;
+            a = (hash_read32(p) << 32) | hash_read32(p + shift);
+            b = (hash_read32(p + len - 4) << 32) |
+                hash_read32(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = ((uint64_t) p[0] << 16) | ((uint64_t) p[len >> 1] << 8) |
+                p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t seed1 = seed, seed2 = seed;
+            do {
+                seed = hash_mix(hash_read64(p) ^ HASH_SECRET1,
+                                hash_read64(p + 8) ^ seed);
+                seed1 = hash_mix(hash_read64(p + 16) ^ HASH_SECRET2,
+                                 hash_read64(p + 24) ^ seed1);
+                seed2 = hash_mix(hash_read64(p + 32) ^ HASH_SECRET3,
+                                 hash_read64(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = hash_mix(hash_read64(p) ^ HASH_SECRET1,
+                            hash_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        /* The last 16 bytes, overlapping ones already mixed if need be. */
+        a = hash_read64(p + i - 16);
+        b = hash_read64(p + i - 8);
+    }
+
+    a ^= HASH_SECRET1;
+    b ^= seed;
+    hash_multiply(&a, &b);
+    return hash_mix(a ^ HASH_SECRET0 ^ len, b ^ HASH_SECRET1);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HASH_H */
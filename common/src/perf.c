@@ -0,0 +1,341 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "perf.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define PERF_HAVE_EVENTS
+#endif
+
+#define NUM_OPS       DS_PERF_NUM_OPS
+#define NUM_COUNTERS  DS_PERF_NUM_COUNTERS
+
+/*
+ * Counters are split into a core group and a memory group.
+ */
+#define GROUP_CORE    0
+#define GROUP_MEMORY  1
+#define NUM_GROUPS    2
+
+/*
+ * Counter groups of one thread. fds[c] is -1 for a counter the kernel
+ * refused, and slot[c] is its position among its group's values.
+ */
+typedef struct {
+    bool opened;
+    int leaders[NUM_GROUPS];
+    int fds[NUM_COUNTERS];
+    int slot[NUM_COUNTERS];
+    DsPerfTotals totals[NUM_OPS];
+} PerfState;
+
+static _Thread_local PerfState state;
+
+static const char* const op_names[NUM_OPS] = {
+    [DS_PERF_VECTOR_PUSH_BACK]  = "vector_push_back",
+    [DS_PERF_VECTOR_INSERT]     = "vector_insert",
+    [DS_PERF_VECTOR_ERASE]      = "vector_erase",
+    [DS_PERF_VECTOR_GET]        = "vector_get",
+    [DS_PERF_VECTOR_CONCAT]     = "vector_concat",
+    [DS_PERF_VECTOR_REVERSE]    = "vector_reverse",
+    [DS_PERF_LIST_PUSH_BACK]    = "list_push_back",
+    [DS_PERF_LIST_PUSH_FRONT]   = "list_push_front",
+    [DS_PERF_LIST_INSERT]       = "list_insert",
+    [DS_PERF_LIST_GET]          = "list_get",
+    [DS_PERF_LIST_SET]          = "list_set",
+};
+
+static const char* const counter_names[NUM_COUNTERS] = {
+    [DS_PERF_CYCLES]        = "cycles",
+    [DS_PERF_INSTRUCTIONS]  = "instr",
+    [DS_PERF_L1D_MISSES]    = "L1D miss",
+    [DS_PERF_LLC_MISSES]    = "LLC miss",
+    [DS_PERF_DTLB_MISSES]   = "dTLB miss",
+    [DS_PERF_BRANCH_MISSES] = "br miss",
+};
+
+static void perf_open(void);
+
+static void perf_read(DsPerfSample* sample);
+
+static void perf_close(PerfState* perf_state);
+
+/*
+ *                                   Probes.
+ */
+
+void ds_perf_begin(DsPerfSample* sample)
+{
+    if (!state.opened)
+        perf_open();
+    perf_read(sample);
+}
+
+/*
+ * A delta taken while the kernel had a group switched out for part of the
+ * time is scaled up by enabled / running. If the group never ran, there
+ * is nothing to scale, and the call adds nothing to that counter.
+ */
+void ds_perf_end(const DsPerfSample* sample, DsPerfOp op)
+{
+    DsPerfSample end;
+    perf_read(&end);
+
+    DsPerfTotals* totals = &state.totals[op];
+    ++totals->calls;
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        uint64_t running = end.running[c] - sample->running[c];
+        if (running == 0)
+            continue;
+
+        uint64_t enabled = end.enabled[c] - sample->enabled[c];
+        uint64_t delta = end.values[c] - sample->values[c];
+        if (enabled > running)
+            delta = (uint64_t) ((double) delta * enabled / running + 0.5);
+
+        totals->totals[c] += delta;
+        totals->running[c] += running;
+    }
+}
+
+/*
+ *                                  Results.
+ */
+
+bool ds_perf_available(DsPerfCounter counter)
+{
+    if (!state.opened)
+        perf_open();
+    return state.fds[counter] >= 0;
+}
+
+const DsPerfTotals* ds_perf_totals(DsPerfOp op)
+{
+    return &state.totals[op];
+}
+
+void ds_perf_reset(void)
+{
+    memset(state.totals, 0, sizeof(state.totals));
+}
+
+void ds_perf_close(void)
+{
+    if (state.opened)
+        perf_close(&state);
+}
+
+/*
+ * One row per operation that ran, with counter values averaged per call.
+ */
+void ds_perf_report(void)
+{
+    printf("%-18s %10s", "OP", "calls");
+    for (int c = 0; c < NUM_COUNTERS; ++c)
+        printf(" %10s", counter_names[c]);
+    printf("\n");
+
+    for (int op = 0; op < NUM_OPS; ++op) {
+        const DsPerfTotals* totals = &state.totals[op];
+        if (totals->calls == 0)
+            continue;
+
+        printf("%-18s %10llu", op_names[op],
+               (unsigned long long) totals->calls);
+        for (int c = 0; c < NUM_COUNTERS; ++c) {
+            if (ds_perf_available(c) && totals->running[c] > 0)
+                printf(" %10.1f", (double) totals->totals[c] / totals->calls);
+            else
+                printf(" %10s", "n/a");
+        }
+        printf("\n");
+    }
+}
+
+/*
+ *                                  Internal.
+ */
+
+#ifdef PERF_HAVE_EVENTS
+
+static int perf_event_open(uint32_t type, uint64_t config, int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+static const int counter_groups[NUM_COUNTERS] = {
+    [DS_PERF_CYCLES]        = GROUP_CORE,
+    [DS_PERF_INSTRUCTIONS]  = GROUP_CORE,
+    [DS_PERF_L1D_MISSES]    = GROUP_MEMORY,
+    [DS_PERF_LLC_MISSES]    = GROUP_MEMORY,
+    [DS_PERF_DTLB_MISSES]   = GROUP_MEMORY,
+    [DS_PERF_BRANCH_MISSES] = GROUP_CORE,
+};
+
+/*
+ * Thread-local storage has no destructors of its own: a key whose value is
+ * the thread's state closes its counters when the thread exits.
+ */
+static pthread_key_t close_key;
+static pthread_once_t close_key_once = PTHREAD_ONCE_INIT;
+
+static void perf_thread_exit(void* perf_state)
+{
+    perf_close(perf_state);
+}
+
+static void perf_create_close_key(void)
+{
+    pthread_key_create(&close_key, perf_thread_exit);
+}
+
+#define CACHE_MISS(cache)                                                     \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) |                          \
+     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+/*
+ * Opens every counter the kernel allows into its group, so that a single
+ * read per group returns them all. The first counter of a group that
+ * opens leads it.
+ */
+static void perf_open(void)
+{
+    static const struct {
+        uint32_t type;
+        uint64_t config;
+    } events[NUM_COUNTERS] = {
+        [DS_PERF_CYCLES]        = { PERF_TYPE_HARDWARE,
+                                    PERF_COUNT_HW_CPU_CYCLES },
+        [DS_PERF_INSTRUCTIONS]  = { PERF_TYPE_HARDWARE,
+                                    PERF_COUNT_HW_INSTRUCTIONS },
+        [DS_PERF_L1D_MISSES]    = { PERF_TYPE_HW_CACHE,
+                                    CACHE_MISS(PERF_COUNT_HW_CACHE_L1D) },
+        [DS_PERF_LLC_MISSES]    = { PERF_TYPE_HARDWARE,
+                                    PERF_COUNT_HW_CACHE_MISSES },
+        [DS_PERF_DTLB_MISSES]   = { PERF_TYPE_HW_CACHE,
+                                    CACHE_MISS(PERF_COUNT_HW_CACHE_DTLB) },
+        [DS_PERF_BRANCH_MISSES] = { PERF_TYPE_HARDWARE,
+                                    PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    int num_open[NUM_GROUPS] = { 0 };
+
+    state.opened = true;
+    for (int g = 0; g < NUM_GROUPS; ++g)
+        state.leaders[g] = -1;
+
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        int g = counter_groups[c];
+
+        state.fds[c] = perf_event_open(events[c].type, events[c].config,
+                                       state.leaders[g]);
+        state.slot[c] = -1;
+        if (state.fds[c] < 0) {
+            state.fds[c] = -1;
+            continue;
+        }
+        if (state.leaders[g] < 0)
+            state.leaders[g] = state.fds[c];
+        state.slot[c] = num_open[g]++;
+    }
+
+    pthread_once(&close_key_once, perf_create_close_key);
+    pthread_setspecific(close_key, &state);
+}
+
+/*
+ * Counters of a group that cannot be read keep zero times, and so count
+ * as never having run.
+ */
+static void perf_read(DsPerfSample* sample)
+{
+    /*
+     * PERF_FORMAT_GROUP with both TOTAL_TIME flags: the number of
+     * counters, time enabled, time running, then the values.
+     */
+    uint64_t buffers[NUM_GROUPS][3 + NUM_COUNTERS];
+    bool valid[NUM_GROUPS];
+
+    memset(sample, 0, sizeof(*sample));
+    for (int g = 0; g < NUM_GROUPS; ++g) {
+        valid[g] = state.leaders[g] >= 0 &&
+                   read(state.leaders[g], buffers[g], sizeof(buffers[g])) >=
+                       (ssize_t) (3 * sizeof(uint64_t));
+    }
+
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        int g = counter_groups[c];
+        const uint64_t* buffer = buffers[g];
+
+        if (!valid[g] || state.slot[c] < 0 ||
+            (uint64_t) state.slot[c] >= buffer[0])
+            continue;
+
+        sample->values[c] = buffer[3 + state.slot[c]];
+        sample->enabled[c] = buffer[1];
+        sample->running[c] = buffer[2];
+    }
+}
+
+/*
+ * Safe to call again on closed state, as the exit destructor does after
+ * ds_perf_close().
+ */
+static void perf_close(PerfState* perf_state)
+{
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        if (perf_state->fds[c] >= 0)
+            close(perf_state->fds[c]);
+        perf_state->fds[c] = -1;
+        perf_state->slot[c] = -1;
+    }
+    for (int g = 0; g < NUM_GROUPS; ++g)
+        perf_state->leaders[g] = -1;
+    perf_state->opened = false;
+}
+
+#else
+
+static void perf_open(void)
+{
+    state.opened = true;
+    for (int g = 0; g < NUM_GROUPS; ++g)
+        state.leaders[g] = -1;
+    for (int c = 0; c < NUM_COUNTERS; ++c) {
+        state.fds[c] = -1;
+        state.slot[c] = -1;
+    }
+}
+
+static void perf_read(DsPerfSample* sample)
+{
+    memset(sample, 0, sizeof(*sample));
+}
+
+static void perf_close(PerfState* perf_state)
+{
+    perf_state->opened = false;
+}
+
+#endif /* PERF_HAVE_EVENTS */
@@ -0,0 +1,111 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Hardware counter probes. Building with -DDS_PERF (make PERF=1) wraps the
+ * operations below in DS_PERF_BEGIN/DS_PERF_END, which read a
+ * perf_event_open counter group before and after and add the difference to
+ * that operation's totals; ds_perf_report() prints them. Without DS_PERF
+ * the probes compile to nothing.
+ *
+ * Counters are opened lazily, per thread, for user space only, and every
+ * total belongs to the thread that ran the operations. Where the kernel
+ * refuses an event (no PMU in a VM, perf_event_paranoid, non-Linux), or
+ * opens it but never schedules it, that column reads n/a; calls are still
+ * counted. The cache and TLB events form a second group, so that the PMU
+ * need not fit all six at once; when the kernel multiplexes a group
+ * anyway, its deltas are scaled up by time enabled over time running.
+ */
+
+typedef enum {
+    DS_PERF_VECTOR_PUSH_BACK,
+    DS_PERF_VECTOR_INSERT,
+    DS_PERF_VECTOR_ERASE,
+    DS_PERF_VECTOR_GET,
+    DS_PERF_VECTOR_CONCAT,
+    DS_PERF_VECTOR_REVERSE,
+    DS_PERF_LIST_PUSH_BACK,
+    DS_PERF_LIST_PUSH_FRONT,
+    DS_PERF_LIST_INSERT,
+    DS_PERF_LIST_GET,
+    DS_PERF_LIST_SET,
+    DS_PERF_NUM_OPS,
+} DsPerfOp;
+
+typedef enum {
+    DS_PERF_CYCLES,
+    DS_PERF_INSTRUCTIONS,
+    DS_PERF_L1D_MISSES,
+    DS_PERF_LLC_MISSES,
+    DS_PERF_DTLB_MISSES,
+    DS_PERF_BRANCH_MISSES,
+    DS_PERF_NUM_COUNTERS,
+} DsPerfCounter;
+
+/*
+ * Counter values at DS_PERF_BEGIN, with the nanoseconds each counter's
+ * group had been enabled and actually running.
+ */
+typedef struct {
+    uint64_t values[DS_PERF_NUM_COUNTERS];
+    uint64_t enabled[DS_PERF_NUM_COUNTERS];
+    uint64_t running[DS_PERF_NUM_COUNTERS];
+} DsPerfSample;
+
+/*
+ * totals are scaled for multiplexing; running is how long each counter
+ * actually counted, and stays 0 for one that never did.
+ */
+typedef struct {
+    uint64_t calls;
+    uint64_t totals[DS_PERF_NUM_COUNTERS];
+    uint64_t running[DS_PERF_NUM_COUNTERS];
+} DsPerfTotals;
+
+#ifdef DS_PERF
+#define DS_PERF_BEGIN(sample)    DsPerfSample sample; ds_perf_begin(&sample)
+#define DS_PERF_END(sample, op)  ds_perf_end(&sample, op)
+#else
+#define DS_PERF_BEGIN(sample)    ((void) 0)
+#define DS_PERF_END(sample, op)  ((void) 0)
+#endif
+
+/*
+ * Probes.
+ */
+
+void ds_perf_begin(DsPerfSample* sample);
+
+void ds_perf_end(const DsPerfSample* sample, DsPerfOp op);
+
+/*
+ * Results.
+ */
+
+bool ds_perf_available(DsPerfCounter counter);
+
+const DsPerfTotals* ds_perf_totals(DsPerfOp op);
+
+void ds_perf_reset(void);
+
+void ds_perf_report(void);
+
+/*
+ * Closes the calling thread's counters, keeping its totals; the next probe
+ * opens them again. A thread that exits has its counters closed for it.
+ */
+
+void ds_perf_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERF_H */
@@ -0,0 +1,140 @@
+#include "pool.h"
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#define ALIGNMENT  alignof(max_align_t)
+
+static void* poolslab_block(const Pool*, PoolSlab*, size_t i);
+
+static void pool_thread_slab(Pool*, PoolSlab*);
+
+static size_t align_up(size_t n);
+
+static void* pool_alloc_func(void* ctx, size_t size);
+static void* pool_realloc_func(void* ctx, void* ptr,
+                               size_t old_size, size_t new_size);
+static void  pool_free_func(void* ctx, void* ptr, size_t size);
+
+/*
+ *                                Construction.
+ */
+
+Pool* pool_create(Pool* pool, size_t block_size, size_t blocks_per_slab)
+{
+    block_size = (block_size < sizeof(void*)) ? sizeof(void*) : block_size;
+
+    pool->block_size = align_up(block_size);
+    pool->blocks_per_slab = blocks_per_slab ? blocks_per_slab :
+                                              POOL_DEFAULT_BLOCKS_PER_SLAB;
+    pool->free_list = NULL;
+    pool->slabs = NULL;
+    pool->allocator.alloc_func = pool_alloc_func;
+    pool->allocator.realloc_func = pool_realloc_func;
+    pool->allocator.free_func = pool_free_func;
+    pool->allocator.ctx = pool;
+    return pool;
+}
+
+/*
+ *                                Destruction.
+ */
+
+void pool_free(Pool* pool)
+{
+    PoolSlab* current_slab;
+
+    while (pool->slabs) {
+        current_slab = pool->slabs;
+        pool->slabs = pool->slabs->next;
+        free(current_slab);
+    }
+    pool->free_list = NULL;
+}
+
+/*
+ *                                 Allocation.
+ */
+
+void* pool_alloc(Pool* pool)
+{
+    if (!pool->free_list) {
+        PoolSlab* slab = malloc(align_up(sizeof(PoolSlab)) +
+                                pool->blocks_per_slab * pool->block_size);
+        assert(slab);
+
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pool_thread_slab(pool, slab);
+    }
+
+    void* block = pool->free_list;
+    pool->free_list = *(void**) block;
+    return block;
+}
+
+void pool_release(Pool* pool, void* block)
+{
+    *(void**) block = pool->free_list;
+    pool->free_list = block;
+}
+
+/*
+ * Returns every block to the free list in one pass over the slabs, without
+ * freeing any memory.
+ */
+void pool_reset(Pool* pool)
+{
+    pool->free_list = NULL;
+    for (PoolSlab* slab = pool->slabs; slab; slab = slab->next)
+        pool_thread_slab(pool, slab);
+}
+
+/*
+ *                                  Internal.
+ */
+
+static void* poolslab_block(const Pool* pool, PoolSlab* slab, size_t i)
+{
+    return (char*) slab + align_up(sizeof(PoolSlab)) + i * pool->block_size;
+}
+
+static void pool_thread_slab(Pool* pool, PoolSlab* slab)
+{
+    for (size_t i = pool->blocks_per_slab; i > 0; --i)
+        pool_release(pool, poolslab_block(pool, slab, i - 1));
+}
+
+static size_t align_up(size_t n)
+{
+    return (n + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+static void* pool_alloc_func(void* ctx, size_t size)
+{
+    Pool* pool = ctx;
+    return (size <= pool->block_size) ? pool_alloc(pool) : NULL;
+}
+
+static void* pool_realloc_func(void* ctx, void* ptr,
+                               size_t old_size, size_t new_size)
+{
+    Pool* pool = ctx;
+
+    (void) old_size;
+
+    if (!ptr)
+        return pool_alloc_func(pool, new_size);
+
+    return (new_size <= pool->block_size) ? ptr : NULL;
+}
+
+static void pool_free_func(void* ctx, void* ptr, size_t size)
+{
+    (void) size;
+
+    if (ptr)
+        pool_release(ctx, ptr);
+}
@@ -0,0 +1,67 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "allocator.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POOL_DEFAULT_BLOCKS_PER_SLAB  256
+
+typedef struct PoolSlab {
+    struct PoolSlab* next;
+} PoolSlab;
+
+/*
+ * Fixed-size block pool. Blocks are carved out of slabs and recycled through
+ * an intrusive free list; pool_reset() returns every block to the free list
+ * without touching the system allocator.
+ */
+
+typedef struct {
+    size_t block_size;
+    size_t blocks_per_slab;
+    void* free_list;
+    PoolSlab* slabs;
+    Allocator allocator;
+} Pool;
+
+/*
+ * Construction.
+ */
+
+Pool* pool_create(Pool* pool, size_t block_size, size_t blocks_per_slab);
+
+/*
+ * Destruction.
+ */
+
+void pool_free(Pool* pool);
+
+/*
+ * Allocation.
+ */
+
+void* pool_alloc(Pool* pool);
+
+void pool_release(Pool* pool, void* block);
+
+void pool_reset(Pool* pool);
+
+/*
+ * Allocator.
+ */
+
+static inline const Allocator* pool_allocator(const Pool* pool)
+{
+    return &pool->allocator;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POOL_H */
@@ -0,0 +1,19 @@
+#ifndef STATS_H
+#define STATS_H
+
+/*
+ * Operation counters. Building with -DDS_STATS (make STATS=1) embeds a
+ * stats block in Vector and List and counts into it; without it the block
+ * and every DS_STATS_ADD() compile to nothing. DS_STATS changes the layout
+ * of the containers, so it must be the same for every translation unit.
+ */
+
+#ifdef DS_STATS
+#define DS_STATS_ADD(counter, n)  ((counter) += (n))
+#define DS_STATS_RESET(block)     memset(&(block), 0, sizeof(block))
+#else
+#define DS_STATS_ADD(counter, n)  ((void) 0)
+#define DS_STATS_RESET(block)     ((void) 0)
+#endif
+
+#endif /* STATS_H */
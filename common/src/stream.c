@@ -0,0 +1,161 @@
+#include "stream.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define STREAM_HAVE_SSE42
+#endif
+
+#define CRC32C_POLY  0x82F63B78u  /* Castagnoli, reflected */
+
+typedef uint32_t (*CrcKernel)(uint32_t crc, const unsigned char*, size_t);
+
+static CrcKernel crc32c_kernel(void);
+
+/*
+ *                                   Header.
+ */
+
+StreamHeader* stream_header_create(StreamHeader* header, size_t data_size,
+                                   size_t count, bool checksum)
+{
+    memset(header, 0, sizeof(*header));
+    header->magic = STREAM_MAGIC;
+    header->version = STREAM_VERSION;
+    header->flags = checksum ? STREAM_FLAG_CRC32C : 0;
+    header->data_size = data_size;
+    header->count = count;
+
+    return header;
+}
+
+/*
+ * Reads a header and checks that it is one of ours, of a version we
+ * understand, and for elements of data_size bytes.
+ */
+bool stream_read_header(int fd, StreamHeader* header, size_t data_size)
+{
+    return stream_read_all(fd, header, sizeof(*header)) &&
+           header->magic == STREAM_MAGIC &&
+           header->version == STREAM_VERSION &&
+           (header->flags & ~STREAM_FLAG_CRC32C) == 0 &&
+           header->data_size == data_size;
+}
+
+/*
+ *                                    I/O.
+ */
+
+/*
+ * Writes every byte described by iov, consuming iov as it goes.
+ */
+bool stream_write_all(int fd, struct iovec* iov, int iovcnt)
+{
+    while (iovcnt > 0) {
+        ssize_t written = writev(fd, iov, iovcnt);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        size_t n = (size_t) written;
+        while (iovcnt > 0 && n >= iov->iov_len) {
+            n -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*) iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return true;
+}
+
+bool stream_read_all(int fd, void* buffer, size_t length)
+{
+    char* p = buffer;
+
+    while (length > 0) {
+        ssize_t got = read(fd, p, length);
+        if (got < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (got == 0)
+            return false;
+
+        p += got;
+        length -= (size_t) got;
+    }
+    return true;
+}
+
+/*
+ *                                  Checksum.
+ */
+
+uint32_t crc32c(uint32_t crc, const void* data, size_t length)
+{
+    return ~crc32c_kernel()(~crc, data, length);
+}
+
+/*
+ *                                  Internal.
+ */
+
+/*
+ * Bit at a time: only used on CPUs without the crc32 instruction.
+ */
+static uint32_t crc32c_portable(uint32_t crc, const unsigned char* p,
+                                size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (CRC32C_POLY & -(crc & 1));
+    }
+    return crc;
+}
+
+#ifdef STREAM_HAVE_SSE42
+
+/*
+ * SSE4.2 crc32 instruction, eight bytes per step.
+ */
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const unsigned char* p,
+                             size_t length)
+{
+    uint64_t crc64 = crc;
+
+    for (; length >= 8; p += 8, length -= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+
+    crc = (uint32_t) crc64;
+    for (; length > 0; ++p, --length)
+        crc = _mm_crc32_u8(crc, *p);
+    return crc;
+}
+
+#endif
+
+static CrcKernel crc32c_kernel(void)
+{
+#ifdef STREAM_HAVE_SSE42
+    if (__builtin_cpu_supports("sse4.2"))
+        return crc32c_sse42;
+#endif
+    return crc32c_portable;
+}
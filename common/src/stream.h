@@ -0,0 +1,66 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STREAM_MAGIC    0x53445344u  /* "DSDS" */
+#define STREAM_VERSION  1
+
+/*
+ * Header flags.
+ */
+#define STREAM_FLAG_CRC32C  0x1u
+
+/*
+ * Serialized container: a StreamHeader, count * data_size bytes of
+ * elements, and, with STREAM_FLAG_CRC32C, the CRC32C of those bytes as a
+ * trailing uint32_t. Integers are stored in host byte order. Vectors and
+ * lists share the format, so either can read what the other wrote.
+ */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t data_size;
+    uint64_t count;
+} StreamHeader;
+
+/*
+ * Header.
+ */
+
+StreamHeader* stream_header_create(StreamHeader* header, size_t data_size,
+                                   size_t count, bool checksum);
+
+bool stream_read_header(int fd, StreamHeader* header, size_t data_size);
+
+/*
+ * I/O. Both retry short transfers and EINTR, and return false on any other
+ * error or, for reads, on end of file.
+ */
+
+bool stream_write_all(int fd, struct iovec* iov, int iovcnt);
+
+bool stream_read_all(int fd, void* buffer, size_t length);
+
+/*
+ * Checksum. Pass 0 for the first block and the previous result for the
+ * next ones.
+ */
+
+uint32_t crc32c(uint32_t crc, const void* data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STREAM_H */
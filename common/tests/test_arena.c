@@ -0,0 +1,133 @@
+#include "../src/arena.h"
+
+#include <check.h>
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_arena_create)
+{
+    Arena arena;
+    arena_create(&arena, 0);
+
+    ck_assert_ptr_eq(arena.head, NULL);
+    ck_assert_uint_eq(arena.chunk_size, ARENA_DEFAULT_CHUNK_SIZE);
+    ck_assert_ptr_eq(arena_allocator(&arena)->ctx, &arena);
+
+    arena_free(&arena);
+}
+END_TEST
+
+/*
+ *                                 Allocation.
+ */
+
+START_TEST(test_arena_alloc)
+{
+    Arena arena;
+    arena_create(&arena, 1024);
+
+    char* a = arena_alloc(&arena, 10);
+    char* b = arena_alloc(&arena, 10);
+
+    ck_assert_ptr_ne(a, b);
+    ck_assert_uint_eq((uintptr_t) a % alignof(max_align_t), 0);
+    ck_assert_uint_eq((uintptr_t) b % alignof(max_align_t), 0);
+
+    memset(a, 'a', 10);
+    memset(b, 'b', 10);
+    ck_assert_int_eq(a[9], 'a');
+
+    /* Larger than a chunk: gets a dedicated chunk. */
+    char* c = arena_alloc(&arena, 4096);
+    memset(c, 'c', 4096);
+    ck_assert_int_eq(b[0], 'b');
+
+    arena_free(&arena);
+}
+END_TEST
+
+START_TEST(test_arena_reset)
+{
+    Arena arena;
+    arena_create(&arena, 1024);
+
+    for (int i = 0; i < 100; ++i)
+        arena_alloc(&arena, 100);
+
+    ArenaChunk* newest_chunk = arena.head;
+    arena_reset(&arena);
+
+    ck_assert_ptr_eq(arena.head, newest_chunk);
+    ck_assert_ptr_eq(arena.head->next, NULL);
+    ck_assert_uint_eq(arena.head->used, 0);
+
+    arena_free(&arena);
+}
+END_TEST
+
+/*
+ *                                 Allocator.
+ */
+
+START_TEST(test_arena_allocator_realloc_in_place)
+{
+    Arena arena;
+    arena_create(&arena, 1024);
+
+    const Allocator* a = arena_allocator(&arena);
+
+    char* p = allocator_alloc(a, 16);
+    memset(p, 'x', 16);
+
+    char* q = allocator_realloc(a, p, 16, 64);
+    ck_assert_ptr_eq(p, q);
+
+    arena_alloc(&arena, 16);
+
+    /* No longer the newest block: must move and keep its contents. */
+    char* r = allocator_realloc(a, q, 64, 128);
+    ck_assert_ptr_ne(q, r);
+    ck_assert_int_eq(r[15], 'x');
+
+    allocator_free(a, r, 128);
+    arena_free(&arena);
+}
+END_TEST
+
+Suite *arena_suite(void)
+{
+    Suite* s = suite_create("Arena");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_arena_create);
+
+    /* Allocation. */
+    tcase_add_test(tc_core, test_arena_alloc);
+    tcase_add_test(tc_core, test_arena_reset);
+
+    /* Allocator. */
+    tcase_add_test(tc_core, test_arena_allocator_realloc_in_place);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = arena_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
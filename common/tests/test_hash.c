@@ -0,0 +1,97 @@
+/*
+ * Runs the portable multiply that 32-bit targets use, against values
+ * produced with __int128, so that HashMap and vector_hash() hash the same
+ * everywhere.
+ */
+#define HASH_NO_INT128
+
+#include "../src/hash.h"
+
+#include <check.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ *                                  Multiply.
+ */
+
+START_TEST(test_hash_multiply)
+{
+    static const uint64_t cases[][4] = {
+        /* a, b, low, high */
+        { 0, 0, 0, 0 },
+        { UINT64_MAX, UINT64_MAX, 1, 0xfffffffffffffffeull },
+        { HASH_SECRET0, HASH_SECRET1,
+          0x8f3907f7b2b80c35ull, 0x90ccc56588c08119ull },
+        { 0x0123456789abcdefull, 0xfedcba9876543210ull,
+          0x2236d88fe5618cf0ull, 0x0121fa00ad77d742ull },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        uint64_t a = cases[i][0], b = cases[i][1];
+        hash_multiply(&a, &b);
+        ck_assert_uint_eq(a, cases[i][2]);
+        ck_assert_uint_eq(b, cases[i][3]);
+    }
+}
+END_TEST
+
+/*
+ *                                   Bytes.
+ */
+
+START_TEST(test_hash_bytes)
+{
+    static const struct {
+        size_t len;
+        uint64_t hash;
+    } cases[] = {
+        { 0, 0x72014e4eed7eeb7dull },
+        { 3, 0x5d247effdc833ef7ull },
+        { 8, 0x36327b59864c912cull },
+        { 16, 0x135a728cd3ef36adull },
+        { 17, 0x07a6f9555a8dabadull },
+        { 48, 0x1a0920f357089738ull },
+        { 49, 0x50ba04a362534578ull },
+        { 100, 0x3c6a53dc13a36060ull },
+        { 200, 0x513d1fb8d957294cull },
+    };
+
+    unsigned char data[200];
+    for (size_t i = 0; i < sizeof(data); ++i)
+        data[i] = (unsigned char) i;
+
+    /* Every branch: short, 4..16, 17..48 and the three-lane loop. */
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+        ck_assert_uint_eq(hash_bytes(data, cases[i].len, 42),
+                          cases[i].hash);
+}
+END_TEST
+
+Suite* hash_suite(void)
+{
+    Suite* s = suite_create("Hash");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Multiply. */
+    tcase_add_test(tc_core, test_hash_multiply);
+
+    /* Bytes. */
+    tcase_add_test(tc_core, test_hash_bytes);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = hash_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
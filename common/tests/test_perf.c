@@ -0,0 +1,130 @@
+#include "../src/perf.h"
+
+#include <check.h>
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NUM_THREADS  8
+
+static void* probe_main(void* arg);
+static size_t count_open_fds(void);
+
+/*
+ *                                   Probes.
+ */
+
+START_TEST(test_perf_probe)
+{
+    ds_perf_reset();
+
+    volatile uint64_t sum = 0;
+    for (int i = 0; i < 10; ++i) {
+        DsPerfSample sample;
+        ds_perf_begin(&sample);
+        for (int j = 0; j < 1000; ++j)
+            sum += j;
+        ds_perf_end(&sample, DS_PERF_LIST_GET);
+    }
+
+    const DsPerfTotals* totals = ds_perf_totals(DS_PERF_LIST_GET);
+    ck_assert_uint_eq(totals->calls, 10);
+    ck_assert_uint_eq(ds_perf_totals(DS_PERF_VECTOR_GET)->calls, 0);
+
+    /*
+     * Counters the kernel refused, or never scheduled, read as zero and
+     * never ran; the others count.
+     */
+    for (int c = 0; c < DS_PERF_NUM_COUNTERS; ++c) {
+        if (!ds_perf_available(c) || totals->running[c] == 0)
+            ck_assert_uint_eq(totals->totals[c], 0);
+    }
+    if (totals->running[DS_PERF_INSTRUCTIONS] > 0)
+        ck_assert_uint_ge(totals->totals[DS_PERF_INSTRUCTIONS], 10 * 1000);
+
+    ds_perf_report();
+
+    ds_perf_reset();
+    ck_assert_uint_eq(ds_perf_totals(DS_PERF_LIST_GET)->calls, 0);
+}
+END_TEST
+
+/*
+ *                                  Lifetime.
+ */
+
+START_TEST(test_perf_close)
+{
+    ds_perf_reset();
+    probe_main(NULL);
+
+    /* Closing keeps the totals, and the next probe reopens. */
+    ds_perf_close();
+    ck_assert_uint_eq(ds_perf_totals(DS_PERF_LIST_GET)->calls, 1);
+    probe_main(NULL);
+    ck_assert_uint_eq(ds_perf_totals(DS_PERF_LIST_GET)->calls, 2);
+    ds_perf_close();
+
+    /* Threads that exit leave no counters open behind them. */
+    size_t fds = count_open_fds();
+    for (int round = 0; round < 4; ++round) {
+        pthread_t threads[NUM_THREADS];
+        for (int t = 0; t < NUM_THREADS; ++t)
+            ck_assert_int_eq(pthread_create(&threads[t], NULL, probe_main,
+                                            NULL), 0);
+        for (int t = 0; t < NUM_THREADS; ++t)
+            pthread_join(threads[t], NULL);
+    }
+    ck_assert_uint_eq(count_open_fds(), fds);
+}
+END_TEST
+
+Suite* perf_suite(void)
+{
+    Suite* s = suite_create("Perf");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Probes. */
+    tcase_add_test(tc_core, test_perf_probe);
+
+    /* Lifetime. */
+    tcase_add_test(tc_core, test_perf_close);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = perf_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+static void* probe_main(void* arg)
+{
+    DsPerfSample sample;
+    ds_perf_begin(&sample);
+    ds_perf_end(&sample, DS_PERF_LIST_GET);
+    return arg;
+}
+
+static size_t count_open_fds(void)
+{
+    DIR* dir = opendir("/proc/self/fd");
+    if (!dir)
+        return 0;
+
+    size_t count = 0;
+    while (readdir(dir))
+        ++count;
+    closedir(dir);
+    return count;
+}
@@ -0,0 +1,122 @@
+#include "../src/pool.h"
+
+#include <check.h>
+
+#include <stdbool.h>
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_pool_create)
+{
+    Pool pool;
+    pool_create(&pool, 1, 0);
+
+    ck_assert_uint_ge(pool.block_size, sizeof(void*));
+    ck_assert_uint_eq(pool.blocks_per_slab, POOL_DEFAULT_BLOCKS_PER_SLAB);
+    ck_assert_ptr_eq(pool.free_list, NULL);
+    ck_assert_ptr_eq(pool_allocator(&pool)->ctx, &pool);
+
+    pool_free(&pool);
+}
+END_TEST
+
+/*
+ *                                 Allocation.
+ */
+
+START_TEST(test_pool_alloc_release)
+{
+    Pool pool;
+    pool_create(&pool, 32, 4);
+
+    void* blocks[10];
+    for (int i = 0; i < 10; ++i)
+        blocks[i] = pool_alloc(&pool);
+
+    for (int i = 0; i < 10; ++i)
+        for (int j = i + 1; j < 10; ++j)
+            ck_assert_ptr_ne(blocks[i], blocks[j]);
+
+    pool_release(&pool, blocks[3]);
+    ck_assert_ptr_eq(pool_alloc(&pool), blocks[3]);
+
+    pool_free(&pool);
+}
+END_TEST
+
+START_TEST(test_pool_reset)
+{
+    Pool pool;
+    pool_create(&pool, 32, 4);
+
+    for (int i = 0; i < 8; ++i)
+        pool_alloc(&pool);
+
+    PoolSlab* slabs = pool.slabs;
+    pool_reset(&pool);
+
+    /* Every block is reusable without allocating another slab. */
+    for (int i = 0; i < 8; ++i)
+        pool_alloc(&pool);
+    ck_assert_ptr_eq(pool.slabs, slabs);
+
+    pool_free(&pool);
+}
+END_TEST
+
+/*
+ *                                 Allocator.
+ */
+
+START_TEST(test_pool_allocator)
+{
+    Pool pool;
+    pool_create(&pool, 32, 4);
+
+    const Allocator* a = pool_allocator(&pool);
+
+    void* p = allocator_alloc(a, 16);
+    ck_assert_ptr_ne(p, NULL);
+    ck_assert_ptr_eq(allocator_realloc(a, p, 16, 32), p);
+    ck_assert_ptr_eq(allocator_realloc(a, p, 32, 64), NULL);
+    ck_assert_ptr_eq(allocator_alloc(a, 64), NULL);
+
+    allocator_free(a, p, 32);
+    ck_assert_ptr_eq(pool.free_list, p);
+
+    pool_free(&pool);
+}
+END_TEST
+
+Suite *pool_suite(void)
+{
+    Suite* s = suite_create("Pool");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_pool_create);
+
+    /* Allocation. */
+    tcase_add_test(tc_core, test_pool_alloc_release);
+    tcase_add_test(tc_core, test_pool_reset);
+
+    /* Allocator. */
+    tcase_add_test(tc_core, test_pool_allocator);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = pool_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "../src/stream.h"
+
+#include <check.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ *                                   Header.
+ */
+
+START_TEST(test_stream_header)
+{
+    int fds[2];
+    ck_assert_int_eq(pipe(fds), 0);
+
+    StreamHeader header;
+    stream_header_create(&header, sizeof(int), 10, true);
+    ck_assert_uint_eq(header.magic, STREAM_MAGIC);
+    ck_assert_uint_eq(header.flags, STREAM_FLAG_CRC32C);
+
+    struct iovec iov[2] = {
+        { &header, sizeof(header) },
+        { &header, sizeof(header) },
+    };
+    ck_assert(stream_write_all(fds[1], iov, 2));
+    close(fds[1]);
+
+    StreamHeader read_back;
+    ck_assert(stream_read_header(fds[0], &read_back, sizeof(int)));
+    ck_assert_uint_eq(read_back.count, 10);
+    ck_assert_uint_eq(read_back.data_size, sizeof(int));
+
+    /* Wrong element size, then end of file. */
+    ck_assert(!stream_read_header(fds[0], &read_back, sizeof(double)));
+    ck_assert(!stream_read_header(fds[0], &read_back, sizeof(int)));
+
+    close(fds[0]);
+}
+END_TEST
+
+/*
+ *                                    I/O.
+ */
+
+START_TEST(test_stream_write_read_all)
+{
+    int fds[2];
+    ck_assert_int_eq(pipe(fds), 0);
+
+    char a[] = "split ", b[] = "across ", c[] = "iovecs";
+    struct iovec iov[3] = {
+        { a, strlen(a) },
+        { b, strlen(b) },
+        { c, strlen(c) },
+    };
+    ck_assert(stream_write_all(fds[1], iov, 3));
+    close(fds[1]);
+
+    char buffer[32] = { 0 };
+    ck_assert(stream_read_all(fds[0], buffer, 19));
+    ck_assert_str_eq(buffer, "split across iovecs");
+    ck_assert(!stream_read_all(fds[0], buffer, 1));
+
+    close(fds[0]);
+}
+END_TEST
+
+/*
+ *                                  Checksum.
+ */
+
+START_TEST(test_crc32c)
+{
+    ck_assert_uint_eq(crc32c(0, "", 0), 0);
+    ck_assert_uint_eq(crc32c(0, "123456789", 9), 0xE3069283u);
+
+    /* Chained blocks give the same result as one call. */
+    unsigned char data[1000];
+    for (int i = 0; i < 1000; ++i)
+        data[i] = (unsigned char) (i * 7);
+
+    uint32_t whole = crc32c(0, data, sizeof(data));
+    uint32_t crc = crc32c(0, data, 13);
+    crc = crc32c(crc, data + 13, 500);
+    crc = crc32c(crc, data + 513, sizeof(data) - 513);
+    ck_assert_uint_eq(crc, whole);
+
+    data[500] ^= 1;
+    ck_assert_uint_ne(crc32c(0, data, sizeof(data)), whole);
+}
+END_TEST
+
+Suite* stream_suite(void)
+{
+    Suite* s = suite_create("Stream");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Header. */
+    tcase_add_test(tc_core, test_stream_header);
+
+    /* I/O. */
+    tcase_add_test(tc_core, test_stream_write_read_all);
+
+    /* Checksum. */
+    tcase_add_test(tc_core, test_crc32c);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = stream_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
@@ -0,0 +1,430 @@
+#include "../src/hashmap.h"
+#include "../../vector/src/vector.h"
+#include "../../common/bench/bench.h"
+#include "unordered_map.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define MAX_SIZE   ((size_t) 1 << 20)
+#define DATA_SIZE  (2 * sizeof(uint64_t))
+
+/*
+ * A linear search costs O(size), so Vector batches shrink as the vector
+ * grows to keep every sample about as long.
+ */
+#define BATCH_KEYS  ((size_t) 1 << 20)
+#define MIN_BATCH   4
+#define MAX_BATCH   1024
+
+/* Odd multipliers: i * M modulo a power of two is a permutation. */
+#define KEY_MULTIPLIER  0x9e3779b97f4a7c15ull
+#define RANDOM_STRIDE   2654435761u
+
+typedef double (*SampleFunc)(size_t size);
+
+/*
+ * The Vector baseline: keys and values in two parallel vectors, so that
+ * lookups are vector_find() over the keys, which is how the containers
+ * were searched before HashMap.
+ */
+typedef struct {
+    Vector keys;
+    Vector values;
+} VectorMap;
+
+static void bench_op(FILE* csv, const char* op, SampleFunc unordered_sample,
+                     SampleFunc vector_sample, SampleFunc hashmap_sample,
+                     size_t size);
+
+static void hashmap_fill(HashMap* map, size_t size);
+static UnorderedMap* unordered_fill(size_t size);
+static void vector_map_fill(VectorMap* vm, size_t size);
+static void vector_map_free(VectorMap* vm);
+
+static uint64_t key(size_t i);
+static uint64_t missing_key(size_t i);
+static size_t shuffled(size_t i, size_t size);
+static size_t batch_size(size_t size);
+
+/* Keeps the optimizer from discarding the measured loops. */
+static volatile uint64_t sink;
+
+/*
+ *                                  HashMap.
+ */
+
+static double hashmap_insert_sample(size_t size)
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i) {
+        uint64_t k = key(i);
+        hashmap_put(&map, &k, &k);
+    }
+    double elapsed = bench_now_ns() - start;
+
+    hashmap_free(&map);
+    return elapsed / size;
+}
+
+static double hashmap_insert_reserved_sample(size_t size)
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+    hashmap_reserve(&map, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i) {
+        uint64_t k = key(i);
+        hashmap_put(&map, &k, &k);
+    }
+    double elapsed = bench_now_ns() - start;
+
+    hashmap_free(&map);
+    return elapsed / size;
+}
+
+static double hashmap_get_hit_sample(size_t size)
+{
+    uint64_t acc = 0;
+    HashMap map;
+    hashmap_fill(&map, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i) {
+        uint64_t k = key(shuffled(i, size));
+        acc += *(uint64_t*) hashmap_get(&map, &k);
+    }
+    double elapsed = bench_now_ns() - start;
+
+    sink = acc;
+    hashmap_free(&map);
+    return elapsed / size;
+}
+
+static double hashmap_get_miss_sample(size_t size)
+{
+    uint64_t acc = 0;
+    HashMap map;
+    hashmap_fill(&map, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i) {
+        uint64_t k = missing_key(i);
+        acc += hashmap_get(&map, &k) != NULL;
+    }
+    double elapsed = bench_now_ns() - start;
+
+    sink = acc;
+    hashmap_free(&map);
+    return elapsed / size;
+}
+
+static double hashmap_erase_sample(size_t size)
+{
+    HashMap map;
+    hashmap_fill(&map, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i) {
+        uint64_t k = key(shuffled(i, size));
+        hashmap_erase(&map, &k);
+    }
+    double elapsed = bench_now_ns() - start;
+
+    hashmap_free(&map);
+    return elapsed / size;
+}
+
+/*
+ *                            std::unordered_map.
+ */
+
+static double unordered_insert_sample(size_t size)
+{
+    UnorderedMap* map = unordered_map_create();
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i)
+        unordered_map_put(map, key(i), key(i));
+    double elapsed = bench_now_ns() - start;
+
+    unordered_map_free(map);
+    return elapsed / size;
+}
+
+static double unordered_insert_reserved_sample(size_t size)
+{
+    UnorderedMap* map = unordered_map_create();
+    unordered_map_reserve(map, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i)
+        unordered_map_put(map, key(i), key(i));
+    double elapsed = bench_now_ns() - start;
+
+    unordered_map_free(map);
+    return elapsed / size;
+}
+
+static double unordered_get_hit_sample(size_t size)
+{
+    uint64_t acc = 0;
+    UnorderedMap* map = unordered_fill(size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i)
+        acc += *unordered_map_get(map, key(shuffled(i, size)));
+    double elapsed = bench_now_ns() - start;
+
+    sink = acc;
+    unordered_map_free(map);
+    return elapsed / size;
+}
+
+static double unordered_get_miss_sample(size_t size)
+{
+    uint64_t acc = 0;
+    UnorderedMap* map = unordered_fill(size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i)
+        acc += unordered_map_get(map, missing_key(i)) != NULL;
+    double elapsed = bench_now_ns() - start;
+
+    sink = acc;
+    unordered_map_free(map);
+    return elapsed / size;
+}
+
+static double unordered_erase_sample(size_t size)
+{
+    UnorderedMap* map = unordered_fill(size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i)
+        unordered_map_erase(map, key(shuffled(i, size)));
+    double elapsed = bench_now_ns() - start;
+
+    unordered_map_free(map);
+    return elapsed / size;
+}
+
+/*
+ *                                  Vector.
+ */
+
+/*
+ * An insertion searches first, as a map has to, so it is as slow as a
+ * miss; the batch goes on top of size existing keys.
+ */
+static double vector_insert_sample(size_t size)
+{
+    size_t batch = batch_size(size);
+    VectorMap vm;
+    vector_map_fill(&vm, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < batch; ++i) {
+        uint64_t k = key(size + i);
+        if (vector_find(&vm.keys, &k) == VECTOR_NOT_FOUND) {
+            vector_push_back(&vm.keys, &k);
+            vector_push_back(&vm.values, &k);
+        }
+    }
+    double elapsed = bench_now_ns() - start;
+
+    vector_map_free(&vm);
+    return elapsed / batch;
+}
+
+static double vector_get_hit_sample(size_t size)
+{
+    size_t batch = batch_size(size);
+    uint64_t acc = 0;
+    VectorMap vm;
+    vector_map_fill(&vm, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < batch; ++i) {
+        uint64_t k = key(shuffled(i, size));
+        acc += *(uint64_t*) vector_get(&vm.values,
+                                       vector_find(&vm.keys, &k));
+    }
+    double elapsed = bench_now_ns() - start;
+
+    sink = acc;
+    vector_map_free(&vm);
+    return elapsed / batch;
+}
+
+static double vector_get_miss_sample(size_t size)
+{
+    size_t batch = batch_size(size);
+    uint64_t acc = 0;
+    VectorMap vm;
+    vector_map_fill(&vm, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < batch; ++i) {
+        uint64_t k = missing_key(i);
+        acc += vector_find(&vm.keys, &k) != VECTOR_NOT_FOUND;
+    }
+    double elapsed = bench_now_ns() - start;
+
+    sink = acc;
+    vector_map_free(&vm);
+    return elapsed / batch;
+}
+
+static double vector_erase_sample(size_t size)
+{
+    size_t batch = batch_size(size);
+    batch = (batch < size) ? batch : size;
+    VectorMap vm;
+    vector_map_fill(&vm, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < batch; ++i) {
+        uint64_t k = key(shuffled(i, size));
+        size_t pos = vector_find(&vm.keys, &k);
+        vector_erase(&vm.keys, pos);
+        vector_erase(&vm.values, pos);
+    }
+    double elapsed = bench_now_ns() - start;
+
+    vector_map_free(&vm);
+    return elapsed / batch;
+}
+
+/*
+ * uint64_t keys and values, against std::unordered_map with the same
+ * types and against a pair of Vectors searched linearly, for maps from
+ * 16 entries to 1M. Prints a table and, given a file name, writes the
+ * same rows to it as CSV. Figures are ns per operation.
+ */
+int main(int argc, char** argv)
+{
+    static const size_t sizes[] = { 1u << 4, 1u << 10, 1u << 16, MAX_SIZE };
+
+    FILE* csv = bench_open_csv(argc, argv);
+    bench_print_header(csv);
+
+#define BENCH_OP(name, op, vector_op)                                         \
+    bench_op(csv, name, unordered_##op##_sample, vector_op,                   \
+             hashmap_##op##_sample, sizes[s])
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        BENCH_OP("insert",          insert,          vector_insert_sample);
+        BENCH_OP("insert_reserved", insert_reserved, NULL);
+        BENCH_OP("get_hit",         get_hit,         vector_get_hit_sample);
+        BENCH_OP("get_miss",        get_miss,        vector_get_miss_sample);
+        BENCH_OP("erase",           erase,           vector_erase_sample);
+    }
+
+#undef BENCH_OP
+
+    if (csv)
+        fclose(csv);
+
+    return 0;
+}
+
+/*
+ * Prints the std::unordered_map row, then the Vector row, if there is
+ * one, and the HashMap row relative to it.
+ */
+static void bench_op(FILE* csv, const char* op, SampleFunc unordered_sample,
+                     SampleFunc vector_sample, SampleFunc hashmap_sample,
+                     size_t size)
+{
+    double samples[BENCH_SAMPLES];
+
+    for (int i = 0; i < BENCH_SAMPLES; ++i)
+        samples[i] = unordered_sample(size);
+    BenchResult baseline = bench_summarize(samples, BENCH_SAMPLES);
+    bench_print_row(csv, "unordered_map", op, DATA_SIZE, size, &baseline, 0);
+
+    if (vector_sample) {
+        for (int i = 0; i < BENCH_SAMPLES; ++i)
+            samples[i] = vector_sample(size);
+        BenchResult result = bench_summarize(samples, BENCH_SAMPLES);
+        bench_print_row(csv, "Vector", op, DATA_SIZE, size, &result,
+                        baseline.p50);
+    }
+
+    for (int i = 0; i < BENCH_SAMPLES; ++i)
+        samples[i] = hashmap_sample(size);
+    BenchResult result = bench_summarize(samples, BENCH_SAMPLES);
+    bench_print_row(csv, "HashMap", op, DATA_SIZE, size, &result,
+                    baseline.p50);
+}
+
+/*
+ *                                  Internal.
+ */
+
+static void hashmap_fill(HashMap* map, size_t size)
+{
+    hashmap_create(map, sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+    for (size_t i = 0; i < size; ++i) {
+        uint64_t k = key(i);
+        hashmap_put(map, &k, &k);
+    }
+}
+
+static UnorderedMap* unordered_fill(size_t size)
+{
+    UnorderedMap* map = unordered_map_create();
+    for (size_t i = 0; i < size; ++i)
+        unordered_map_put(map, key(i), key(i));
+    return map;
+}
+
+static void vector_map_fill(VectorMap* vm, size_t size)
+{
+    vector_create(&vm->keys, sizeof(uint64_t), NULL);
+    vector_create(&vm->values, sizeof(uint64_t), NULL);
+    vector_reserve(&vm->keys, size + MAX_BATCH);
+    vector_reserve(&vm->values, size + MAX_BATCH);
+    for (size_t i = 0; i < size; ++i) {
+        uint64_t k = key(i);
+        vector_push_back(&vm->keys, &k);
+        vector_push_back(&vm->values, &k);
+    }
+}
+
+static void vector_map_free(VectorMap* vm)
+{
+    vector_free(&vm->keys);
+    vector_free(&vm->values);
+}
+
+/*
+ * Distinct, scattered keys; missing_key(i) never equals any key(j) the
+ * benchmark inserts.
+ */
+static uint64_t key(size_t i)
+{
+    return (i + 1) * KEY_MULTIPLIER;
+}
+
+static uint64_t missing_key(size_t i)
+{
+    return key(2 * MAX_SIZE + i);
+}
+
+static size_t shuffled(size_t i, size_t size)
+{
+    return (i * RANDOM_STRIDE) & (size - 1);
+}
+
+static size_t batch_size(size_t size)
+{
+    size_t batch = BATCH_KEYS / size;
+    return (batch < MIN_BATCH) ? MIN_BATCH :
+           (batch > MAX_BATCH) ? MAX_BATCH : batch;
+}
@@ -0,0 +1,38 @@
+#include "unordered_map.h"
+
+#include <unordered_map>
+
+struct UnorderedMap {
+    std::unordered_map<uint64_t, uint64_t> map;
+};
+
+UnorderedMap* unordered_map_create(void)
+{
+    return new UnorderedMap;
+}
+
+void unordered_map_free(UnorderedMap* map)
+{
+    delete map;
+}
+
+void unordered_map_reserve(UnorderedMap* map, size_t count)
+{
+    map->map.reserve(count);
+}
+
+bool unordered_map_put(UnorderedMap* map, uint64_t key, uint64_t value)
+{
+    return map->map.insert_or_assign(key, value).second;
+}
+
+uint64_t* unordered_map_get(UnorderedMap* map, uint64_t key)
+{
+    auto it = map->map.find(key);
+    return it == map->map.end() ? nullptr : &it->second;
+}
+
+bool unordered_map_erase(UnorderedMap* map, uint64_t key)
+{
+    return map->map.erase(key) != 0;
+}
@@ -0,0 +1,37 @@
+#ifndef UNORDERED_MAP_H
+#define UNORDERED_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * std::unordered_map<uint64_t, uint64_t> behind a C interface, as the
+ * baseline for bench_hashmap. Each call crosses into a separate C++
+ * translation unit, as each hashmap_* call does into hashmap.c, so neither
+ * side gets inlined into the benchmark loops.
+ */
+
+typedef struct UnorderedMap UnorderedMap;
+
+UnorderedMap* unordered_map_create(void);
+
+void unordered_map_free(UnorderedMap* map);
+
+void unordered_map_reserve(UnorderedMap* map, size_t count);
+
+bool unordered_map_put(UnorderedMap* map, uint64_t key, uint64_t value);
+
+uint64_t* unordered_map_get(UnorderedMap* map, uint64_t key);
+
+bool unordered_map_erase(UnorderedMap* map, uint64_t key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNORDERED_MAP_H */
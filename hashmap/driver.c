@@ -0,0 +1,36 @@
+#include "src/hashmap.h"
+
+#include <stdio.h>
+
+void print_entry(const void*, void*, void*);
+
+int main()
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(char), sizeof(int), NULL, NULL);
+
+    const char* text = "the quick brown fox jumps over the lazy dog";
+
+    for (const char* p = text; *p; ++p) {
+        if (*p == ' ')
+            continue;
+
+        int* count = hashmap_get(&map, p);
+        if (count) {
+            ++*count;
+        } else {
+            int one = 1;
+            hashmap_put(&map, p, &one);
+        }
+    }
+
+    hashmap_for_each(&map, print_entry, NULL);
+
+    hashmap_free(&map);
+}
+
+void print_entry(const void* key, void* value, void* ctx)
+{
+    (void) ctx;
+    printf("%c: %d\n", *(const char*) key, *(int*) value);
+}
@@ -0,0 +1,456 @@
+#include "hashmap.h"
+#include "../../common/src/hash.h"
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#define HASHMAP_HAVE_SSE2
+#endif
+
+#define GROUP_WIDTH    HASHMAP_GROUP_WIDTH
+#define INIT_CAPACITY  HASHMAP_INIT_CAPACITY
+#define NOT_FOUND      SIZE_MAX
+
+/*
+ * Both special control bytes have the sign bit set and every full one has
+ * it clear, so "empty or deleted" is just the sign bits of a group.
+ */
+#define CTRL_EMPTY    ((int8_t) -128)
+#define CTRL_DELETED  ((int8_t) -2)
+
+static inline uint32_t group_match(const int8_t* group, int8_t h2);
+static inline uint32_t group_match_empty(const int8_t* group);
+static inline uint32_t group_match_empty_or_deleted(const int8_t* group);
+
+static inline uint64_t hashmap_hash(const HashMap* map, const void* key);
+static inline bool hashmap_keys_equal(const HashMap* map, const void* a,
+                                      const void* b);
+static inline void* hashmap_slot(const HashMap* map, size_t pos);
+static inline void hashmap_set_ctrl(HashMap* map, size_t pos, int8_t ctrl);
+
+static size_t hashmap_find(const HashMap* map, const void* key,
+                           uint64_t hash);
+static size_t hashmap_find_insert_slot(const HashMap* map, uint64_t hash);
+
+static void hashmap_alloc_table(HashMap* map, size_t capacity);
+static void hashmap_rehash(HashMap* map, size_t new_capacity);
+
+static size_t table_bytes(size_t capacity, size_t slot_size);
+static size_t ctrl_bytes(size_t capacity);
+static size_t max_growth(size_t capacity);
+static size_t slot_alignment(size_t size);
+static size_t round_up(size_t size, size_t alignment);
+
+/*
+ *                                Construction.
+ */
+
+HashMap* hashmap_create(HashMap* map, size_t key_size, size_t value_size,
+                        HashFunc hash_func, EqualFunc equal_func)
+{
+    return hashmap_create_with_allocator(map, key_size, value_size,
+                                         hash_func, equal_func,
+                                         &heap_allocator);
+}
+
+/*
+ * Each value starts at the first offset past its key that suits the
+ * value's size, and each slot is padded so that the next key is aligned
+ * as well, so keys and values can be accessed in place.
+ */
+HashMap* hashmap_create_with_allocator(HashMap* map, size_t key_size,
+                                       size_t value_size,
+                                       HashFunc hash_func,
+                                       EqualFunc equal_func,
+                                       const Allocator* allocator)
+{
+    size_t key_align = slot_alignment(key_size);
+    size_t value_align = slot_alignment(value_size);
+
+    assert(key_size > 0);
+    map->key_size = key_size;
+    map->value_size = value_size;
+    map->value_offset = round_up(key_size, value_align);
+    map->slot_size = round_up(map->value_offset + value_size,
+                              key_align > value_align ? key_align
+                                                      : value_align);
+    map->size = 0;
+    map->hash_func = hash_func;
+    map->equal_func = equal_func;
+    map->allocator = allocator;
+    hashmap_alloc_table(map, INIT_CAPACITY);
+
+    return map;
+}
+
+/*
+ *                                Destruction.
+ */
+
+void hashmap_free(HashMap* map)
+{
+    allocator_free(map->allocator, map->ctrl,
+                   table_bytes(map->capacity, map->slot_size));
+}
+
+/*
+ *                                   Lookup.
+ */
+
+void* hashmap_get(const HashMap* map, const void* key)
+{
+    size_t pos = hashmap_find(map, key, hashmap_hash(map, key));
+    if (pos == NOT_FOUND)
+        return NULL;
+    return (char*) hashmap_slot(map, pos) + map->value_offset;
+}
+
+bool hashmap_contains(const HashMap* map, const void* key)
+{
+    return hashmap_find(map, key, hashmap_hash(map, key)) != NOT_FOUND;
+}
+
+/*
+ *                                 Insertion.
+ */
+
+/*
+ * Inserts key with value, or overwrites the value of an existing key.
+ * Returns whether key was new. value may be NULL if value_size is 0. A
+ * new key reuses the first tombstone on its probe sequence; only claiming
+ * an empty slot counts against the load limit.
+ */
+bool hashmap_put(HashMap* map, const void* key, const void* value)
+{
+    uint64_t hash = hashmap_hash(map, key);
+    size_t pos = hashmap_find(map, key, hash);
+
+    if (pos != NOT_FOUND) {
+        if (map->value_size)
+            memcpy((char*) hashmap_slot(map, pos) + map->value_offset,
+                   value, map->value_size);
+        return false;
+    }
+
+    pos = hashmap_find_insert_slot(map, hash);
+    if (map->ctrl[pos] == CTRL_EMPTY && map->growth_left == 0) {
+        /* Up to 25/32 full, purging the tombstones frees enough slots. */
+        if (map->size * 32 <= map->capacity * 25)
+            hashmap_rehash(map, map->capacity);
+        else
+            hashmap_rehash(map, map->capacity * 2);
+        pos = hashmap_find_insert_slot(map, hash);
+    }
+
+    if (map->ctrl[pos] == CTRL_EMPTY)
+        --map->growth_left;
+    hashmap_set_ctrl(map, pos, (int8_t) (hash & 0x7f));
+
+    char* slot = hashmap_slot(map, pos);
+    memcpy(slot, key, map->key_size);
+    if (map->value_size)
+        memcpy(slot + map->value_offset, value, map->value_size);
+    ++map->size;
+
+    return true;
+}
+
+/*
+ *                                  Removal.
+ */
+
+/*
+ * Leaves a tombstone, so that probe sequences passing through the slot
+ * still reach the keys beyond it. Tombstones are reused by later inserts
+ * and purged when the table is rehashed.
+ */
+bool hashmap_erase(HashMap* map, const void* key)
+{
+    size_t pos = hashmap_find(map, key, hashmap_hash(map, key));
+    if (pos == NOT_FOUND)
+        return false;
+
+    hashmap_set_ctrl(map, pos, CTRL_DELETED);
+    --map->size;
+
+    return true;
+}
+
+HashMap* hashmap_clear(HashMap* map)
+{
+    memset(map->ctrl, CTRL_EMPTY, ctrl_bytes(map->capacity));
+    map->size = 0;
+    map->growth_left = max_growth(map->capacity);
+    return map;
+}
+
+/*
+ *                                   Resize.
+ */
+
+/*
+ * Makes room for count entries in total without a rehash, purging
+ * tombstones if that is enough.
+ */
+HashMap* hashmap_reserve(HashMap* map, size_t count)
+{
+    if (count <= map->size + map->growth_left)
+        return map;
+
+    size_t capacity = map->capacity;
+    while (max_growth(capacity) < count)
+        capacity *= 2;
+    hashmap_rehash(map, capacity);
+
+    return map;
+}
+
+/*
+ *                                 Iteration.
+ */
+
+void hashmap_for_each(const HashMap* map, HashMapForFunc for_func, void* ctx)
+{
+    for (size_t i = 0; i < map->capacity; ++i) {
+        if (map->ctrl[i] >= 0) {
+            char* slot = hashmap_slot(map, i);
+            for_func(slot, slot + map->value_offset, ctx);
+        }
+    }
+}
+
+/*
+ *                                  Internal.
+ */
+
+#ifdef HASHMAP_HAVE_SSE2
+
+static inline uint32_t group_match(const int8_t* group, int8_t h2)
+{
+    __m128i ctrl = _mm_loadu_si128((const __m128i*) group);
+    return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl,
+                                                       _mm_set1_epi8(h2)));
+}
+
+static inline uint32_t group_match_empty(const int8_t* group)
+{
+    return group_match(group, CTRL_EMPTY);
+}
+
+static inline uint32_t group_match_empty_or_deleted(const int8_t* group)
+{
+    __m128i ctrl = _mm_loadu_si128((const __m128i*) group);
+    return (uint32_t) _mm_movemask_epi8(ctrl);
+}
+
+#else
+
+static inline uint32_t group_match(const int8_t* group, int8_t h2)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; ++i)
+        mask |= (uint32_t) (group[i] == h2) << i;
+    return mask;
+}
+
+static inline uint32_t group_match_empty(const int8_t* group)
+{
+    return group_match(group, CTRL_EMPTY);
+}
+
+static inline uint32_t group_match_empty_or_deleted(const int8_t* group)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; ++i)
+        mask |= (uint32_t) (group[i] < 0) << i;
+    return mask;
+}
+
+#endif /* HASHMAP_HAVE_SSE2 */
+
+/*
+ * A user hash is mixed once more, since the table splits it into a probe
+ * start (the high bits) and a 7-bit tag (the low bits), and hashes such as
+ * the identity on integers leave both poorly distributed. Integer-sized
+ * keys skip the general byte hash and get that one mix of their value.
+ */
+static inline uint64_t hashmap_hash(const HashMap* map, const void* key)
+{
+    const unsigned char* p = key;
+
+    if (map->hash_func)
+        return hash_mix(map->hash_func(key) ^ HASH_SECRET0, HASH_SECRET1);
+
+    switch (map->key_size) {
+    case 4:
+        return hash_mix(hash_read32(p) ^ HASH_SECRET0, HASH_SECRET1);
+    case 8:
+        return hash_mix(hash_read64(p) ^ HASH_SECRET0, HASH_SECRET1);
+    default:
+        return hash_bytes(key, map->key_size, 0);
+    }
+}
+
+/*
+ * memcmp with a size only known at run time is a library call, so
+ * integer-sized keys are compared inline.
+ */
+static inline bool hashmap_keys_equal(const HashMap* map, const void* a,
+                                      const void* b)
+{
+    if (map->equal_func)
+        return map->equal_func(a, b);
+
+    switch (map->key_size) {
+    case 4:
+        return hash_read32(a) == hash_read32(b);
+    case 8:
+        return hash_read64(a) == hash_read64(b);
+    default:
+        return memcmp(a, b, map->key_size) == 0;
+    }
+}
+
+static inline void* hashmap_slot(const HashMap* map, size_t pos)
+{
+    return (char*) map->slots + pos * map->slot_size;
+}
+
+/*
+ * The first GROUP_WIDTH control bytes are mirrored past the end, so that a
+ * group starting near the end can be loaded without wrapping.
+ */
+static inline void hashmap_set_ctrl(HashMap* map, size_t pos, int8_t ctrl)
+{
+    map->ctrl[pos] = ctrl;
+    if (pos < GROUP_WIDTH)
+        map->ctrl[map->capacity + pos] = ctrl;
+}
+
+/*
+ * Probes group by group with triangular strides, which visits every group
+ * of a power-of-two table once. An empty byte in a group ends the search:
+ * the key would have been placed there.
+ */
+static size_t hashmap_find(const HashMap* map, const void* key,
+                           uint64_t hash)
+{
+    size_t mask = map->capacity - 1;
+    size_t pos = (size_t) (hash >> 7) & mask;
+    int8_t h2 = (int8_t) (hash & 0x7f);
+
+    for (size_t stride = GROUP_WIDTH;; stride += GROUP_WIDTH) {
+        const int8_t* group = map->ctrl + pos;
+
+        for (uint32_t match = group_match(group, h2); match;
+             match &= match - 1) {
+            size_t i = (pos + __builtin_ctz(match)) & mask;
+            if (hashmap_keys_equal(map, key, hashmap_slot(map, i)))
+                return i;
+        }
+        if (group_match_empty(group))
+            return NOT_FOUND;
+
+        pos = (pos + stride) & mask;
+    }
+}
+
+/*
+ * The first empty or deleted slot on hash's probe sequence. The load limit
+ * guarantees there is one.
+ */
+static size_t hashmap_find_insert_slot(const HashMap* map, uint64_t hash)
+{
+    size_t mask = map->capacity - 1;
+    size_t pos = (size_t) (hash >> 7) & mask;
+
+    for (size_t stride = GROUP_WIDTH;; stride += GROUP_WIDTH) {
+        uint32_t match = group_match_empty_or_deleted(map->ctrl + pos);
+        if (match)
+            return (pos + __builtin_ctz(match)) & mask;
+
+        pos = (pos + stride) & mask;
+    }
+}
+
+/*
+ * Control bytes and slots share one allocation, control bytes first.
+ */
+static void hashmap_alloc_table(HashMap* map, size_t capacity)
+{
+    map->capacity = capacity;
+    map->ctrl = allocator_alloc(map->allocator,
+                                table_bytes(capacity, map->slot_size));
+    assert(map->ctrl);
+    map->slots = (char*) map->ctrl + ctrl_bytes(capacity);
+    memset(map->ctrl, CTRL_EMPTY, ctrl_bytes(capacity));
+    map->growth_left = max_growth(capacity) - map->size;
+}
+
+/*
+ * Moves every entry into a fresh table, which also drops all tombstones.
+ * Keys are known to be distinct, so each goes straight to the first free
+ * slot on its probe sequence without comparisons.
+ */
+static void hashmap_rehash(HashMap* map, size_t new_capacity)
+{
+    int8_t* old_ctrl = map->ctrl;
+    char* old_slots = map->slots;
+    size_t old_capacity = map->capacity;
+
+    hashmap_alloc_table(map, new_capacity);
+
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old_ctrl[i] < 0)
+            continue;
+
+        char* slot = old_slots + i * map->slot_size;
+        uint64_t hash = hashmap_hash(map, slot);
+        size_t pos = hashmap_find_insert_slot(map, hash);
+        hashmap_set_ctrl(map, pos, (int8_t) (hash & 0x7f));
+        memcpy(hashmap_slot(map, pos), slot, map->slot_size);
+    }
+
+    allocator_free(map->allocator, old_ctrl,
+                   table_bytes(old_capacity, map->slot_size));
+}
+
+static size_t table_bytes(size_t capacity, size_t slot_size)
+{
+    return ctrl_bytes(capacity) + capacity * slot_size;
+}
+
+static size_t ctrl_bytes(size_t capacity)
+{
+    return round_up(capacity + GROUP_WIDTH, alignof(max_align_t));
+}
+
+static size_t max_growth(size_t capacity)
+{
+    return capacity - capacity / 8;
+}
+
+/*
+ * The natural alignment of a scalar or array of this size: its largest
+ * power-of-two divisor, up to that of max_align_t.
+ */
+static size_t slot_alignment(size_t size)
+{
+    size_t alignment = size & -size;
+    if (alignment == 0)
+        return 1;
+    if (alignment > alignof(max_align_t))
+        return alignof(max_align_t);
+    return alignment;
+}
+
+static size_t round_up(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
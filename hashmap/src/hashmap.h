@@ -0,0 +1,135 @@
+#ifndef HASHMAP_H
+#define HASHMAP_H
+
+#include "../../common/src/allocator.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Hashes a key, and compares two keys for equality.
+ */
+
+typedef uint64_t(*HashFunc)(const void* key);
+
+typedef bool(*EqualFunc)(const void* a, const void* b);
+
+typedef void(*HashMapForFunc)(const void* key, void* value, void* ctx);
+
+/*
+ * Control bytes are probed a group at a time: one SSE2 compare and
+ * movemask tests 16 slots.
+ */
+#define HASHMAP_GROUP_WIDTH    16
+#define HASHMAP_INIT_CAPACITY  16
+
+/*
+ * Open-addressing hash map in the style of Abseil's Swiss tables. Keys and
+ * values are stored by value, in fixed-size slots of one flat buffer, with
+ * one control byte per slot in front of them. A control byte is empty,
+ * deleted (a tombstone left by an erase), or holds the low 7 bits of a
+ * full slot's hash, so a lookup compares keys only for slots whose byte
+ * matches, which is one in 128 for a key that is absent.
+ *
+ * The capacity is a power of two and at most 7/8 of it is ever used by
+ * entries and tombstones together. Pointers returned by hashmap_get()
+ * stay valid until the next insertion.
+ */
+
+typedef struct {
+    size_t key_size;
+    size_t value_size;
+    size_t value_offset;
+    size_t slot_size;
+    size_t size;
+    size_t capacity;
+    size_t growth_left;
+    int8_t* ctrl;
+    void* slots;
+    HashFunc hash_func;
+    EqualFunc equal_func;
+    const Allocator* allocator;
+} HashMap;
+
+/*
+ * Construction. A NULL HashFunc hashes the key's bytes and a NULL
+ * EqualFunc compares them with memcmp, which suits keys without padding
+ * or pointers.
+ */
+
+HashMap* hashmap_create(HashMap* map, size_t key_size, size_t value_size,
+                        HashFunc, EqualFunc);
+
+HashMap* hashmap_create_with_allocator(HashMap* map, size_t key_size,
+                                       size_t value_size, HashFunc,
+                                       EqualFunc, const Allocator*);
+
+/*
+ * Destruction.
+ */
+
+void hashmap_free(HashMap* map);
+
+/*
+ * Size.
+ */
+
+static inline size_t hashmap_size(const HashMap* map)
+{
+    return map->size;
+}
+
+static inline size_t hashmap_capacity(const HashMap* map)
+{
+    return map->capacity;
+}
+
+static inline bool hashmap_is_empty(const HashMap* map)
+{
+    return map->size == 0;
+}
+
+/*
+ * Lookup.
+ */
+
+void* hashmap_get(const HashMap* map, const void* key);
+
+bool hashmap_contains(const HashMap* map, const void* key);
+
+/*
+ * Insertion.
+ */
+
+bool hashmap_put(HashMap* map, const void* key, const void* value);
+
+/*
+ * Removal.
+ */
+
+bool hashmap_erase(HashMap* map, const void* key);
+
+HashMap* hashmap_clear(HashMap* map);
+
+/*
+ * Resize.
+ */
+
+HashMap* hashmap_reserve(HashMap* map, size_t count);
+
+/*
+ * Iteration.
+ */
+
+void hashmap_for_each(const HashMap* map, HashMapForFunc, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HASHMAP_H */
@@ -0,0 +1,385 @@
+#include "../src/hashmap.h"
+#include "../../common/src/arena.h"
+
+#include <check.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_KEYS  10000
+
+static uint64_t u64_identity(const void*);
+static uint64_t u64_constant(const void*);
+static uint64_t str_hash(const void*);
+static bool str_equal(const void*, const void*);
+static void sum_entries(const void* key, void* value, void* ctx);
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_hashmap_create)
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(uint64_t), sizeof(uint32_t), NULL, NULL);
+
+    ck_assert_uint_eq(map.key_size, sizeof(uint64_t));
+    ck_assert_uint_eq(map.value_size, sizeof(uint32_t));
+    ck_assert_uint_eq(map.value_offset, 8);
+    ck_assert_uint_eq(map.slot_size, 16);
+    ck_assert_uint_eq(hashmap_size(&map), 0);
+    ck_assert_uint_eq(hashmap_capacity(&map), HASHMAP_INIT_CAPACITY);
+    ck_assert(hashmap_is_empty(&map));
+
+    hashmap_free(&map);
+}
+END_TEST
+
+START_TEST(test_hashmap_slot_layout)
+{
+    HashMap map;
+
+    /* A 2-byte key is padded so the 8-byte value is aligned. */
+    hashmap_create(&map, sizeof(uint16_t), sizeof(uint64_t), NULL, NULL);
+    ck_assert_uint_eq(map.value_offset, 8);
+    ck_assert_uint_eq(map.slot_size, 16);
+    hashmap_free(&map);
+
+    /* A set: no values, slots as small as the keys. */
+    hashmap_create(&map, sizeof(uint32_t), 0, NULL, NULL);
+    ck_assert_uint_eq(map.value_offset, 4);
+    ck_assert_uint_eq(map.slot_size, 4);
+    hashmap_free(&map);
+
+    /* Odd sizes are packed. */
+    hashmap_create(&map, 3, 5, NULL, NULL);
+    ck_assert_uint_eq(map.value_offset, 3);
+    ck_assert_uint_eq(map.slot_size, 8);
+    hashmap_free(&map);
+}
+END_TEST
+
+START_TEST(test_hashmap_create_with_allocator)
+{
+    Arena arena;
+    arena_create(&arena, 0);
+
+    HashMap map;
+    hashmap_create_with_allocator(&map, sizeof(uint64_t), sizeof(uint64_t),
+                                  NULL, NULL, arena_allocator(&arena));
+
+    for (uint64_t i = 0; i < 1000; ++i)
+        hashmap_put(&map, &i, &i);
+    for (uint64_t i = 0; i < 1000; ++i)
+        ck_assert_uint_eq(*(uint64_t*) hashmap_get(&map, &i), i);
+
+    hashmap_free(&map);
+    arena_free(&arena);
+}
+END_TEST
+
+/*
+ *                                 Insertion.
+ */
+
+START_TEST(test_hashmap_put_get)
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+
+    for (uint64_t i = 0; i < NUM_KEYS; ++i) {
+        uint64_t value = i * 3;
+        ck_assert(hashmap_put(&map, &i, &value));
+    }
+    ck_assert_uint_eq(hashmap_size(&map), NUM_KEYS);
+    ck_assert_uint_le(hashmap_size(&map),
+                      hashmap_capacity(&map) - hashmap_capacity(&map) / 8);
+
+    for (uint64_t i = 0; i < NUM_KEYS; ++i) {
+        uint64_t* value = hashmap_get(&map, &i);
+        ck_assert_ptr_ne(value, NULL);
+        ck_assert_uint_eq(*value, i * 3);
+    }
+    for (uint64_t i = NUM_KEYS; i < 2 * NUM_KEYS; ++i)
+        ck_assert(!hashmap_contains(&map, &i));
+
+    hashmap_free(&map);
+}
+END_TEST
+
+START_TEST(test_hashmap_put_overwrite)
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(int), sizeof(int), NULL, NULL);
+
+    int key = 7, value = 1;
+    ck_assert(hashmap_put(&map, &key, &value));
+    value = 2;
+    ck_assert(!hashmap_put(&map, &key, &value));
+
+    ck_assert_uint_eq(hashmap_size(&map), 1);
+    ck_assert_int_eq(*(int*) hashmap_get(&map, &key), 2);
+
+    hashmap_free(&map);
+}
+END_TEST
+
+START_TEST(test_hashmap_hash_funcs)
+{
+    static const char* const words[] = {
+        "alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta",
+    };
+    static const size_t num_words = sizeof(words) / sizeof(words[0]);
+
+    HashMap map;
+    hashmap_create(&map, sizeof(char*), sizeof(size_t), str_hash, str_equal);
+
+    for (size_t i = 0; i < num_words; ++i)
+        hashmap_put(&map, &words[i], &i);
+
+    /* Equal strings at other addresses find the same entries. */
+    char buffer[16];
+    for (size_t i = 0; i < num_words; ++i) {
+        strcpy(buffer, words[i]);
+        const char* key = buffer;
+        ck_assert_uint_eq(*(size_t*) hashmap_get(&map, &key), i);
+    }
+
+    const char* missing = "theta";
+    ck_assert(!hashmap_contains(&map, &missing));
+
+    hashmap_free(&map);
+}
+END_TEST
+
+START_TEST(test_hashmap_weak_hash)
+{
+    HashMap map;
+
+    /* The identity hash is mixed before the table uses it. */
+    hashmap_create(&map, sizeof(uint64_t), 0, u64_identity, NULL);
+    for (uint64_t i = 0; i < NUM_KEYS; ++i)
+        hashmap_put(&map, &i, NULL);
+    for (uint64_t i = 0; i < NUM_KEYS; ++i)
+        ck_assert(hashmap_contains(&map, &i));
+    hashmap_free(&map);
+
+    /* Every key collides: correct, if slow. */
+    hashmap_create(&map, sizeof(uint64_t), 0, u64_constant, NULL);
+    for (uint64_t i = 0; i < 200; ++i)
+        hashmap_put(&map, &i, NULL);
+    for (uint64_t i = 0; i < 400; ++i)
+        ck_assert(hashmap_contains(&map, &i) == (i < 200));
+    for (uint64_t i = 0; i < 200; i += 2)
+        ck_assert(hashmap_erase(&map, &i));
+    for (uint64_t i = 0; i < 200; ++i)
+        ck_assert(hashmap_contains(&map, &i) == (i % 2 == 1));
+    hashmap_free(&map);
+}
+END_TEST
+
+/*
+ *                                  Removal.
+ */
+
+START_TEST(test_hashmap_erase)
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+
+    for (uint64_t i = 0; i < NUM_KEYS; ++i)
+        hashmap_put(&map, &i, &i);
+    for (uint64_t i = 0; i < NUM_KEYS; i += 2)
+        ck_assert(hashmap_erase(&map, &i));
+
+    uint64_t key = 0;
+    ck_assert(!hashmap_erase(&map, &key));
+    ck_assert_uint_eq(hashmap_size(&map), NUM_KEYS / 2);
+
+    /* Keys probed past a tombstone are still found. */
+    for (uint64_t i = 0; i < NUM_KEYS; ++i) {
+        uint64_t* value = hashmap_get(&map, &i);
+        if (i % 2 == 0) {
+            ck_assert_ptr_eq(value, NULL);
+        } else {
+            ck_assert_ptr_ne(value, NULL);
+            ck_assert_uint_eq(*value, i);
+        }
+    }
+
+    hashmap_free(&map);
+}
+END_TEST
+
+START_TEST(test_hashmap_tombstone_reuse)
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+    hashmap_reserve(&map, 100);
+    size_t capacity = hashmap_capacity(&map);
+
+    /* Churn through many distinct keys with at most 100 alive. */
+    for (uint64_t i = 0; i < 10 * NUM_KEYS; ++i) {
+        hashmap_put(&map, &i, &i);
+        if (i >= 99) {
+            uint64_t old = i - 99;
+            ck_assert(hashmap_erase(&map, &old));
+        }
+    }
+    ck_assert_uint_eq(hashmap_size(&map), 99);
+    ck_assert_uint_eq(hashmap_capacity(&map), capacity);
+
+    uint64_t last = 10 * NUM_KEYS - 1;
+    ck_assert_uint_eq(*(uint64_t*) hashmap_get(&map, &last), last);
+
+    hashmap_free(&map);
+}
+END_TEST
+
+START_TEST(test_hashmap_clear)
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(int), sizeof(int), NULL, NULL);
+
+    for (int i = 0; i < 100; ++i)
+        hashmap_put(&map, &i, &i);
+    size_t capacity = hashmap_capacity(&map);
+    hashmap_clear(&map);
+
+    ck_assert(hashmap_is_empty(&map));
+    ck_assert_uint_eq(hashmap_capacity(&map), capacity);
+    for (int i = 0; i < 100; ++i)
+        ck_assert(!hashmap_contains(&map, &i));
+
+    int key = 5;
+    hashmap_put(&map, &key, &key);
+    ck_assert_int_eq(*(int*) hashmap_get(&map, &key), 5);
+
+    hashmap_free(&map);
+}
+END_TEST
+
+/*
+ *                                   Resize.
+ */
+
+START_TEST(test_hashmap_reserve)
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+
+    hashmap_reserve(&map, NUM_KEYS);
+    size_t capacity = hashmap_capacity(&map);
+    ck_assert_uint_ge(capacity - capacity / 8, NUM_KEYS);
+    ck_assert_uint_lt(capacity / 2 - capacity / 16, NUM_KEYS);
+
+    for (uint64_t i = 0; i < NUM_KEYS; ++i)
+        hashmap_put(&map, &i, &i);
+    ck_assert_uint_eq(hashmap_capacity(&map), capacity);
+
+    /* Reserving less is a no-op. */
+    hashmap_reserve(&map, 10);
+    ck_assert_uint_eq(hashmap_capacity(&map), capacity);
+
+    hashmap_free(&map);
+}
+END_TEST
+
+/*
+ *                                 Iteration.
+ */
+
+START_TEST(test_hashmap_for_each)
+{
+    HashMap map;
+    hashmap_create(&map, sizeof(uint64_t), sizeof(uint64_t), NULL, NULL);
+
+    for (uint64_t i = 1; i <= 100; ++i)
+        hashmap_put(&map, &i, &i);
+    for (uint64_t i = 1; i <= 100; i += 10)
+        hashmap_erase(&map, &i);
+
+    uint64_t sum = 0;
+    hashmap_for_each(&map, sum_entries, &sum);
+    ck_assert_uint_eq(sum, 2 * (5050 - 460));
+
+    hashmap_free(&map);
+}
+END_TEST
+
+Suite* hashmap_suite(void)
+{
+    Suite* s = suite_create("HashMap");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_hashmap_create);
+    tcase_add_test(tc_core, test_hashmap_slot_layout);
+    tcase_add_test(tc_core, test_hashmap_create_with_allocator);
+
+    /* Insertion. */
+    tcase_add_test(tc_core, test_hashmap_put_get);
+    tcase_add_test(tc_core, test_hashmap_put_overwrite);
+    tcase_add_test(tc_core, test_hashmap_hash_funcs);
+    tcase_add_test(tc_core, test_hashmap_weak_hash);
+
+    /* Removal. */
+    tcase_add_test(tc_core, test_hashmap_erase);
+    tcase_add_test(tc_core, test_hashmap_tombstone_reuse);
+    tcase_add_test(tc_core, test_hashmap_clear);
+
+    /* Resize. */
+    tcase_add_test(tc_core, test_hashmap_reserve);
+
+    /* Iteration. */
+    tcase_add_test(tc_core, test_hashmap_for_each);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = hashmap_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+static uint64_t u64_identity(const void* key)
+{
+    return *(const uint64_t*) key;
+}
+
+static uint64_t u64_constant(const void* key)
+{
+    (void) key;
+    return 42;
+}
+
+/*
+ * FNV-1a over the string a char* key points to.
+ */
+static uint64_t str_hash(const void* key)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char* p = *(const char* const*) key; *p; ++p)
+        hash = (hash ^ (unsigned char) *p) * 0x100000001b3ull;
+    return hash;
+}
+
+static bool str_equal(const void* a, const void* b)
+{
+    return strcmp(*(const char* const*) a, *(const char* const*) b) == 0;
+}
+
+static void sum_entries(const void* key, void* value, void* ctx)
+{
+    *(uint64_t*) ctx += *(const uint64_t*) key + *(uint64_t*) value;
+}
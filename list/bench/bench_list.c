@@ -0,0 +1,325 @@
+#include "../src/list.h"
+#include "../../common/bench/array.h"
+#include "../../common/bench/bench.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_DATA_SIZE  64
+
+/*
+ * Middle insertions and random gets walk the list, so their batches shrink
+ * as the list grows to keep every sample about as long.
+ */
+#define BATCH_NODES  ((size_t) 1 << 20)
+#define MIN_BATCH    4
+#define MAX_BATCH    1024
+
+/* Odd multiplier: i * RANDOM_STRIDE modulo a power of two is a permutation. */
+#define RANDOM_STRIDE  2654435761u
+
+typedef double (*SampleFunc)(size_t data_size, size_t size);
+
+static void bench_op(FILE* csv, const char* op, SampleFunc array_sample,
+                     SampleFunc list_sample, size_t data_size, size_t size);
+
+static void list_fill(List* list, size_t data_size, size_t size);
+static void array_fill(Array* a, size_t data_size, size_t size);
+
+static size_t batch_size(size_t size);
+
+static double list_push_back_sample(size_t data_size, size_t size);
+static double list_push_front_sample(size_t data_size, size_t size);
+static double list_insert_middle_sample(size_t data_size, size_t size);
+static double list_get_sample(size_t data_size, size_t size);
+static double list_iterate_sample(size_t data_size, size_t size);
+static double list_free_sample(size_t data_size, size_t size);
+
+static double array_push_back_sample(size_t data_size, size_t size);
+static double array_push_front_sample(size_t data_size, size_t size);
+static double array_insert_middle_sample(size_t data_size, size_t size);
+static double array_get_sample(size_t data_size, size_t size);
+static double array_iterate_sample(size_t data_size, size_t size);
+static double array_free_sample(size_t data_size, size_t size);
+
+/* Keeps the optimizer from discarding the measured loops. */
+static volatile uint64_t sink;
+
+/*
+ * Every operation List supports, for element sizes of 4, 16 and 64 bytes
+ * and for lists of 1K, 32K and 1M nodes, against a plain array doing the
+ * same. Prints a table and, given a file name, writes the same rows to it
+ * as CSV. Figures are ns per element operated on.
+ */
+int main(int argc, char** argv)
+{
+    static const size_t data_sizes[] = { 4, 16, MAX_DATA_SIZE };
+    static const size_t sizes[] = { 1u << 10, 1u << 15, 1u << 20 };
+
+    FILE* csv = bench_open_csv(argc, argv);
+    bench_print_header(csv);
+
+#define BENCH_OP(name, op)                                                    \
+    bench_op(csv, name, array_##op##_sample, list_##op##_sample,              \
+             data_sizes[d], sizes[s])
+
+    for (size_t d = 0; d < sizeof(data_sizes) / sizeof(data_sizes[0]); ++d) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            BENCH_OP("push_back",     push_back);
+            BENCH_OP("push_front",    push_front);
+            BENCH_OP("insert_middle", insert_middle);
+            BENCH_OP("get",           get);
+            BENCH_OP("iterate",       iterate);
+            BENCH_OP("free",          free);
+        }
+    }
+
+#undef BENCH_OP
+
+    if (csv)
+        fclose(csv);
+
+    return 0;
+}
+
+static void bench_op(FILE* csv, const char* op, SampleFunc array_sample,
+                     SampleFunc list_sample, size_t data_size, size_t size)
+{
+    double samples[BENCH_SAMPLES];
+
+    for (int i = 0; i < BENCH_SAMPLES; ++i)
+        samples[i] = array_sample(data_size, size);
+    BenchResult baseline = bench_summarize(samples, BENCH_SAMPLES);
+    bench_print_row(csv, "array", op, data_size, size, &baseline, 0);
+
+    for (int i = 0; i < BENCH_SAMPLES; ++i)
+        samples[i] = list_sample(data_size, size);
+    BenchResult result = bench_summarize(samples, BENCH_SAMPLES);
+    bench_print_row(csv, "List", op, data_size, size, &result,
+                    baseline.p50);
+}
+
+/*
+ *                                    List.
+ */
+
+static double list_push_back_sample(size_t data_size, size_t size)
+{
+    char elem[MAX_DATA_SIZE] = { 0 };
+    List list;
+    list_create(&list, data_size, NULL);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i)
+        list_push_back(&list, elem);
+    double elapsed = bench_now_ns() - start;
+
+    list_free(&list);
+    return elapsed / size;
+}
+
+static double list_push_front_sample(size_t data_size, size_t size)
+{
+    char elem[MAX_DATA_SIZE] = { 0 };
+    List list;
+    list_create(&list, data_size, NULL);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i)
+        list_push_front(&list, elem);
+    double elapsed = bench_now_ns() - start;
+
+    list_free(&list);
+    return elapsed / size;
+}
+
+static double list_insert_middle_sample(size_t data_size, size_t size)
+{
+    char elem[MAX_DATA_SIZE] = { 0 };
+    size_t batch = batch_size(size);
+    List list;
+    list_fill(&list, data_size, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < batch; ++i)
+        list_insert(&list, list_size(&list) / 2, elem);
+    double elapsed = bench_now_ns() - start;
+
+    list_free(&list);
+    return elapsed / batch;
+}
+
+static double list_get_sample(size_t data_size, size_t size)
+{
+    size_t batch = batch_size(size);
+    uint64_t acc = 0;
+    List list;
+    list_fill(&list, data_size, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < batch; ++i)
+        acc += *(unsigned char*) list_get(&list, (i * RANDOM_STRIDE) &
+                                                 (size - 1));
+    double elapsed = bench_now_ns() - start;
+
+    sink = acc;
+    list_free(&list);
+    return elapsed / batch;
+}
+
+static double list_iterate_sample(size_t data_size, size_t size)
+{
+    uint64_t acc = 0;
+    List list;
+    list_fill(&list, data_size, size);
+
+    double start = bench_now_ns();
+    for (ListNode* node = list.head; node; node = node->next)
+        acc += *(unsigned char*) node->data_ptr;
+    double elapsed = bench_now_ns() - start;
+
+    sink = acc;
+    list_free(&list);
+    return elapsed / size;
+}
+
+static double list_free_sample(size_t data_size, size_t size)
+{
+    List list;
+    list_fill(&list, data_size, size);
+
+    double start = bench_now_ns();
+    list_free(&list);
+    return (bench_now_ns() - start) / size;
+}
+
+/*
+ *                                   Array.
+ */
+
+static double array_push_back_sample(size_t data_size, size_t size)
+{
+    char elem[MAX_DATA_SIZE] = { 0 };
+    Array a;
+    array_create(&a, data_size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i)
+        array_push_back(&a, elem);
+    double elapsed = bench_now_ns() - start;
+
+    array_free(&a);
+    return elapsed / size;
+}
+
+/*
+ * Front insertion is quadratic for an array, so it gets the same batch
+ * limit as a list's middle insertion.
+ */
+static double array_push_front_sample(size_t data_size, size_t size)
+{
+    char elem[MAX_DATA_SIZE] = { 0 };
+    size_t batch = batch_size(size);
+    Array a;
+    array_fill(&a, data_size, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < batch; ++i)
+        array_insert(&a, 0, elem);
+    double elapsed = bench_now_ns() - start;
+
+    array_free(&a);
+    return elapsed / batch;
+}
+
+static double array_insert_middle_sample(size_t data_size, size_t size)
+{
+    char elem[MAX_DATA_SIZE] = { 0 };
+    size_t batch = batch_size(size);
+    Array a;
+    array_fill(&a, data_size, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < batch; ++i)
+        array_insert(&a, a.size / 2, elem);
+    double elapsed = bench_now_ns() - start;
+
+    array_free(&a);
+    return elapsed / batch;
+}
+
+static double array_get_sample(size_t data_size, size_t size)
+{
+    size_t batch = batch_size(size);
+    uint64_t acc = 0;
+    Array a;
+    array_fill(&a, data_size, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < batch; ++i)
+        acc += *(unsigned char*) array_get(&a, (i * RANDOM_STRIDE) &
+                                               (size - 1));
+    double elapsed = bench_now_ns() - start;
+
+    sink = acc;
+    array_free(&a);
+    return elapsed / batch;
+}
+
+static double array_iterate_sample(size_t data_size, size_t size)
+{
+    uint64_t acc = 0;
+    Array a;
+    array_fill(&a, data_size, size);
+
+    double start = bench_now_ns();
+    for (size_t i = 0; i < size; ++i)
+        acc += *(unsigned char*) array_get(&a, i);
+    double elapsed = bench_now_ns() - start;
+
+    sink = acc;
+    array_free(&a);
+    return elapsed / size;
+}
+
+static double array_free_sample(size_t data_size, size_t size)
+{
+    Array a;
+    array_fill(&a, data_size, size);
+
+    double start = bench_now_ns();
+    array_free(&a);
+    return (bench_now_ns() - start) / size;
+}
+
+/*
+ *                                  Internal.
+ */
+
+static void list_fill(List* list, size_t data_size, size_t size)
+{
+    char elem[MAX_DATA_SIZE];
+    list_create(list, data_size, NULL);
+    for (size_t i = 0; i < size; ++i) {
+        memset(elem, (int) i, data_size);
+        list_push_back(list, elem);
+    }
+}
+
+static void array_fill(Array* a, size_t data_size, size_t size)
+{
+    char elem[MAX_DATA_SIZE];
+    array_create(a, data_size);
+    for (size_t i = 0; i < size; ++i) {
+        memset(elem, (int) i, data_size);
+        array_push_back(a, elem);
+    }
+}
+
+static size_t batch_size(size_t size)
+{
+    size_t batch = BATCH_NODES / size;
+    return (batch < MIN_BATCH) ? MIN_BATCH :
+           (batch > MAX_BATCH) ? MAX_BATCH : batch;
+}
@@ -1,26 +1,55 @@
 #include "../src/list.h"
+#include "../../common/src/perf.h"
+#include "../../common/src/stream.h"
 
 #include <assert.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-static ListNode* listnode_create(size_t data_size, const void* data_ptr);
+/*
+ * list_write() hands the kernel this many nodes per writev.
+ */
+#define WRITE_BATCH  256
+
+/*
+ * list_read() reads the stream in blocks of about this many bytes.
+ */
+#define READ_BLOCK_BYTES  (64 * 1024)
+
+static ListNode* listnode_create(List*, const void* data_ptr);
 
-static void listnode_free(ListNode*, FreeFunc);
+static void listnode_free(List*, ListNode*);
 
 /*
  *                                Construction.
  */
 
+/*
+ * Without a free_func the list frees every element itself, so the elements
+ * can share their nodes' blocks.
+ */
 List* list_create(List* list, size_t data_size, FreeFunc free_func)
+{
+    list_create_with_allocator(list, data_size, free_func, &heap_allocator);
+    list->storage = free_func ? LIST_STORAGE_SEPARATE : LIST_STORAGE_INLINE;
+    return list;
+}
+
+List* list_create_with_allocator(List* list, size_t data_size,
+                                 FreeFunc free_func,
+                                 const Allocator* allocator)
 {
     list->data_size = data_size;
     list->size = 0;
     list->head = NULL;
     list->tail = NULL;
     list->free_func = (*free_func);
+    list->allocator = allocator;
+    list->storage = LIST_STORAGE_INLINE;
+    DS_STATS_RESET(list->stats);
     return list;
 }
 
@@ -35,7 +64,7 @@ void list_free(List* list)
     while (list->head) {
         current_node = list->head;
         list->head = list->head->next;
-        listnode_free(current_node, list->free_func);
+        listnode_free(list, current_node);
     }
 }
 
@@ -45,26 +74,34 @@ void list_free(List* list)
 
 void* list_get(const List* list, size_t pos)
 {
+    DS_PERF_BEGIN(probe);
     assert(pos < list_size(list));
 
     ListNode* current_node = list->head;
 
     for (size_t i = 0; i < pos; ++i, current_node = current_node->next)
         ;
+    /* Counters are bookkeeping, not part of the list's observable state. */
+    DS_STATS_ADD(((List*) list)->stats.chase_steps, pos);
 
+    DS_PERF_END(probe, DS_PERF_LIST_GET);
     return current_node->data_ptr;
 }
 
 void list_set(const List* list, size_t pos, const void* data_ptr)
 {
+    DS_PERF_BEGIN(probe);
     assert(pos < list_size(list));
 
     ListNode* current_node = list->head;
 
     for (size_t i = 0; i < pos; ++i, current_node = current_node->next)
         ;
+    DS_STATS_ADD(((List*) list)->stats.chase_steps, pos);
 
     memcpy(current_node->data_ptr, data_ptr, list->data_size);
+
+    DS_PERF_END(probe, DS_PERF_LIST_SET);
 }
 
 /*
@@ -73,7 +110,8 @@ void list_set(const List* list, size_t pos, const void* data_ptr)
 
 void list_push_back(List* list, const void* data_ptr)
 {
-    ListNode *new_node = listnode_create(list->data_size, data_ptr);
+    DS_PERF_BEGIN(probe);
+    ListNode *new_node = listnode_create(list, data_ptr);
 
     if (list_is_empty(list))
         list->head = list->tail = new_node;
@@ -83,11 +121,14 @@ void list_push_back(List* list, const void* data_ptr)
     }
 
     ++list->size;
+
+    DS_PERF_END(probe, DS_PERF_LIST_PUSH_BACK);
 }
 
 void list_push_front(List* list, const void* data_ptr)
 {
-    ListNode *new_node = listnode_create(list->data_size, data_ptr);
+    DS_PERF_BEGIN(probe);
+    ListNode *new_node = listnode_create(list, data_ptr);
 
     new_node->next = list->head;
     list->head = new_node;
@@ -96,22 +137,28 @@ void list_push_front(List* list, const void* data_ptr)
         list->tail = list->head;
 
     ++list->size;
+
+    DS_PERF_END(probe, DS_PERF_LIST_PUSH_FRONT);
 }
 
 void list_insert(List* list, size_t pos, const void* data_ptr)
 {
+    DS_PERF_BEGIN(probe);
     assert(pos < list_size(list));
 
-    ListNode* new_node = listnode_create(list->data_size, data_ptr);
+    ListNode* new_node = listnode_create(list, data_ptr);
     ListNode* current_node = list->head;
 
     for (size_t i = 0; i < pos - 1; ++i, current_node = current_node->next)
         ;
+    DS_STATS_ADD(list->stats.chase_steps, pos - 1);
 
     new_node->next = current_node->next;
     current_node->next = new_node;
 
     ++list->size;
+
+    DS_PERF_END(probe, DS_PERF_LIST_INSERT);
 }
 
 /*
@@ -142,6 +189,100 @@ void list_insert(List* list, size_t pos, const void* data_ptr)
 
 /* void list_erase(List* list, size_t pos); */
 
+/*
+ *                               Serialization.
+ */
+
+/*
+ * Gathers the node payloads into batches of iovecs, so the elements go out
+ * WRITE_BATCH at a time rather than one write per node. The checksum is
+ * accumulated on the way and written last.
+ */
+bool list_write(const List* list, int fd, bool checksum)
+{
+    StreamHeader header;
+    stream_header_create(&header, list->data_size, list->size, checksum);
+
+    struct iovec iov[WRITE_BATCH];
+    uint32_t crc = 0;
+    int n = 0;
+
+    iov[n].iov_base = &header;
+    iov[n++].iov_len = sizeof(header);
+
+    for (ListNode* node = list->head; node; node = node->next) {
+        if (checksum)
+            crc = crc32c(crc, node->data_ptr, list->data_size);
+
+        iov[n].iov_base = node->data_ptr;
+        iov[n++].iov_len = list->data_size;
+
+        if (n == WRITE_BATCH) {
+            if (!stream_write_all(fd, iov, n))
+                return false;
+            n = 0;
+        }
+    }
+
+    if (checksum) {
+        if (n == WRITE_BATCH) {
+            if (!stream_write_all(fd, iov, n))
+                return false;
+            n = 0;
+        }
+        iov[n].iov_base = &crc;
+        iov[n++].iov_len = sizeof(crc);
+    }
+
+    return n == 0 || stream_write_all(fd, iov, n);
+}
+
+List* list_read(List* list, int fd, size_t data_size, FreeFunc free_func)
+{
+    StreamHeader header;
+    if (data_size == 0 || !stream_read_header(fd, &header, data_size))
+        return NULL;
+
+    list_create(list, data_size, free_func);
+
+    size_t per_block = READ_BLOCK_BYTES / data_size;
+    per_block = per_block ? per_block : 1;
+
+    char* block = malloc(per_block * data_size);
+    assert(block);
+
+    uint32_t crc = 0;
+    size_t remaining = header.count;
+
+    while (remaining > 0) {
+        size_t count = (remaining < per_block) ? remaining : per_block;
+        if (!stream_read_all(fd, block, count * data_size))
+            goto fail;
+
+        if (header.flags & STREAM_FLAG_CRC32C)
+            crc = crc32c(crc, block, count * data_size);
+        for (size_t i = 0; i < count; ++i)
+            list_push_back(list, block + i * data_size);
+        remaining -= count;
+    }
+
+    if (header.flags & STREAM_FLAG_CRC32C) {
+        uint32_t expected;
+        if (!stream_read_all(fd, &expected, sizeof(expected)) ||
+            expected != crc)
+            goto fail;
+    }
+
+    free(block);
+    return list;
+
+fail:
+    free(block);
+    list->free_func = NULL;
+    list_free(list);
+    return NULL;
+}
+
 /*
  *                                   Printing.
  */
@@ -165,29 +306,70 @@ void list_print(const List* list, PrintFunc print_func)
     printf("]\n");
 }
 
+/*
+ * Prints the DS_STATS counters; does nothing in builds without them.
+ */
+void list_stats_dump(const List* list)
+{
+#ifdef DS_STATS
+    const char* format = "%12s - %llu\n";
+    printf(format, "NODE_ALLOCS",
+           (unsigned long long) list->stats.node_allocs);
+    printf(format, "NODE_FREES", (unsigned long long) list->stats.node_frees);
+    printf(format, "CHASE_STEPS",
+           (unsigned long long) list->stats.chase_steps);
+#else
+    (void) list;
+#endif
+}
+
 /*
  *                                  Internal.
  */
 
-static ListNode* listnode_create(size_t data_size, const void* data_ptr)
+/*
+ * With LIST_STORAGE_INLINE the node and its element share one block: the
+ * element is stored right after the ListNode header, so each insertion
+ * costs a single allocation.
+ */
+static ListNode* listnode_create(List* list, const void* data_ptr)
 {
-    ListNode* new_node = malloc(sizeof(ListNode));
+    DS_STATS_ADD(list->stats.node_allocs, 1);
+
+    bool separate = list->storage == LIST_STORAGE_SEPARATE;
+    size_t node_size = sizeof(ListNode) + (separate ? 0 : list->data_size);
+
+    ListNode* new_node = allocator_alloc(list->allocator, node_size);
     assert(new_node);
 
-    new_node->data_ptr = malloc(data_size);
-    assert(new_node->data_ptr);
+    if (separate) {
+        new_node->data_ptr = allocator_alloc(list->allocator,
+                                             list->data_size);
+        assert(new_node->data_ptr);
+    } else {
+        new_node->data_ptr = new_node + 1;
+    }
 
-    memcpy(new_node->data_ptr, data_ptr, data_size);
+    memcpy(new_node->data_ptr, data_ptr, list->data_size);
     new_node->next = NULL;
 
     return new_node;
 }
 
-static void listnode_free(ListNode* node, FreeFunc free_func)
+static void listnode_free(List* list, ListNode* node)
 {
-    if (free_func)
-        free_func(node->data_ptr);
-    else
-        free(node->data_ptr);
-    free(node);
+    DS_STATS_ADD(list->stats.node_frees, 1);
+
+    if (list->storage == LIST_STORAGE_SEPARATE) {
+        if (list->free_func)
+            list->free_func(node->data_ptr);
+        else
+            allocator_free(list->allocator, node->data_ptr, list->data_size);
+        allocator_free(list->allocator, node, sizeof(ListNode));
+        return;
+    }
+
+    if (list->free_func)
+        list->free_func(node->data_ptr);
+    allocator_free(list->allocator, node, sizeof(ListNode) + list->data_size);
 }
@@ -1,8 +1,12 @@
 #ifndef LIST_H
 #define LIST_H
 
+#include "../../common/src/allocator.h"
+#include "../../common/src/stats.h"
+
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -12,25 +16,60 @@ typedef void(*FreeFunc)(void*);
 
 typedef void(*PrintFunc)(const void*);
 
+/*
+ * Where a node keeps its element. LIST_STORAGE_INLINE stores it in the same
+ * block as the node; LIST_STORAGE_SEPARATE gives it a heap block of its
+ * own, which a free_func set with list_create() takes over and releases.
+ */
+typedef enum {
+    LIST_STORAGE_INLINE,
+    LIST_STORAGE_SEPARATE,
+} ListStorage;
+
 typedef struct ListNode {
     void* data_ptr;
     struct ListNode* next;
 } ListNode;
 
+/*
+ * Counters kept with -DDS_STATS: node allocations and frees, and the links
+ * followed by the positional operations (list_get, list_set, list_insert).
+ */
+typedef struct {
+    uint64_t node_allocs;
+    uint64_t node_frees;
+    uint64_t chase_steps;
+} ListStats;
+
 typedef struct {
     size_t data_size;
     size_t size;
     ListNode* head;
     ListNode* tail;
     FreeFunc free_func;
+    const Allocator* allocator;
+    ListStorage storage;
+#ifdef DS_STATS
+    ListStats stats;
+#endif
 } List;
 
 /*
  * Construction.
+ *
+ * The two constructors differ in who frees an element's storage. With
+ * list_create(), free_func is handed each element and frees it, storage
+ * included, exactly as free() would be called on it without a free_func.
+ * With list_create_with_allocator(), elements live inside their nodes,
+ * which the list frees itself: free_func must release only the resources
+ * an element owns, never the element.
  */
 
 List* list_create(List* list, size_t data_size, FreeFunc);
 
+List* list_create_with_allocator(List* list, size_t data_size, FreeFunc,
+                                 const Allocator*);
+
 /*
  * Destruction.
  */
@@ -92,12 +131,25 @@ void* list_pop_front(List* list);
 
 void list_erase(List* list, size_t pos);
 
+/*
+ * Serialization, in the same stream format as vector_write(), so a list
+ * can be read back as a vector and vice versa. list_read() creates list
+ * and returns NULL on I/O errors, a foreign header, a different or zero
+ * data_size or a bad checksum.
+ */
+
+bool list_write(const List* list, int fd, bool checksum);
+
+List* list_read(List* list, int fd, size_t data_size, FreeFunc);
+
 /*
  * Printing.
  */
 
 void list_print(const List* list, PrintFunc);
 
+void list_stats_dump(const List* list);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,11 +1,19 @@
 #include "../src/list.h"
+#include "../../common/src/pool.h"
+#include "../../common/src/stream.h"
 
 #include <check.h>
 
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 static size_t list_fill_with_strings(List* list);
+static void list_fill_with_copies(List* list);
+
+static void str_free(void* s);
+static void str_free_owned(void* s);
 
 /*
  *                                Construction.
@@ -25,6 +33,56 @@ START_TEST(test_list_create)
 }
 END_TEST
 
+START_TEST(test_list_create_with_allocator)
+{
+    Pool pool;
+    pool_create(&pool, sizeof(ListNode) + sizeof(char*), 0);
+
+    List list;
+    list_create_with_allocator(&list, sizeof(char*), NULL,
+                               pool_allocator(&pool));
+
+    ck_assert_ptr_eq(list.allocator, pool_allocator(&pool));
+
+    size_t num_strings = list_fill_with_strings(&list);
+    ck_assert_uint_eq(list_size(&list), num_strings);
+    ck_assert_str_eq(*(char**) list_get(&list, 0), "Very");
+
+    list_free(&list);
+
+    /* Every node went back to the pool. */
+    PoolSlab* slabs = pool.slabs;
+    list_create_with_allocator(&list, sizeof(char*), NULL,
+                               pool_allocator(&pool));
+    list_fill_with_strings(&list);
+    ck_assert_ptr_eq(pool.slabs, slabs);
+
+    pool_free(&pool);
+}
+END_TEST
+
+START_TEST(test_list_free_func)
+{
+    /* list_create(): free_func frees the element too. */
+    List list;
+    list_create(&list, sizeof(char*), str_free);
+    ck_assert_int_eq(list.storage, LIST_STORAGE_SEPARATE);
+
+    list_fill_with_copies(&list);
+    ck_assert_str_eq(*(char**) list_get(&list, 1), "Interesting");
+    list_free(&list);
+
+    /* With an allocator it frees only what the element owns. */
+    list_create_with_allocator(&list, sizeof(char*), str_free_owned,
+                               &heap_allocator);
+    ck_assert_int_eq(list.storage, LIST_STORAGE_INLINE);
+
+    list_fill_with_copies(&list);
+    ck_assert_str_eq(*(char**) list_get(&list, 1), "Interesting");
+    list_free(&list);
+}
+END_TEST
+
 /*
  *                                   Sizeof.
  */
@@ -184,6 +242,114 @@ START_TEST(test_list_pop_back)
 }
 END_TEST
 
+/*
+ *                               Serialization.
+ */
+
+START_TEST(test_list_write_read)
+{
+    char path[] = "/tmp/test_list_XXXXXX";
+    int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+
+    /* More elements than one write batch or read block holds. */
+    List list;
+    list_create(&list, sizeof(int), NULL);
+    for (int i = 0; i < 20000; ++i)
+        list_push_back(&list, &i);
+
+    ck_assert(list_write(&list, fd, true));
+    ck_assert(list_write(&list, fd, false));
+    list_free(&list);
+
+    lseek(fd, 0, SEEK_SET);
+    for (int round = 0; round < 2; ++round) {
+        ck_assert_ptr_eq(list_read(&list, fd, sizeof(int), NULL), &list);
+        ck_assert_uint_eq(list_size(&list), 20000);
+
+        int i = 0;
+        for (ListNode* node = list.head; node; node = node->next, ++i)
+            ck_assert_int_eq(*(int*) node->data_ptr, i);
+        list_free(&list);
+    }
+
+    /* End of file. */
+    ck_assert_ptr_eq(list_read(&list, fd, sizeof(int), NULL), NULL);
+
+    close(fd);
+    unlink(path);
+}
+END_TEST
+
+START_TEST(test_list_read_corrupt)
+{
+    char path[] = "/tmp/test_list_XXXXXX";
+    int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+
+    List list;
+    list_create(&list, sizeof(int), NULL);
+    for (int i = 0; i < 100; ++i)
+        list_push_back(&list, &i);
+    ck_assert(list_write(&list, fd, true));
+    list_free(&list);
+
+    /* Wrong element size. */
+    lseek(fd, 0, SEEK_SET);
+    ck_assert_ptr_eq(list_read(&list, fd, sizeof(double), NULL), NULL);
+
+    /* A stream written for a zero-size list has no element size. */
+    int fds[2];
+    ck_assert_int_eq(pipe(fds), 0);
+    list_create(&list, 0, NULL);
+    ck_assert(list_write(&list, fds[1], false));
+    list_free(&list);
+    close(fds[1]);
+    ck_assert_ptr_eq(list_read(&list, fds[0], 0, NULL), NULL);
+    close(fds[0]);
+
+    /* Flip one payload byte: the checksum no longer matches. */
+    int bad = -1;
+    ck_assert_int_eq(pwrite(fd, &bad, sizeof(bad),
+                            sizeof(StreamHeader) + 50 * sizeof(int)),
+                     sizeof(bad));
+    lseek(fd, 0, SEEK_SET);
+    ck_assert_ptr_eq(list_read(&list, fd, sizeof(int), NULL), NULL);
+
+    close(fd);
+    unlink(path);
+}
+END_TEST
+
+/*
+ *                                   Stats.
+ */
+
+START_TEST(test_list_stats)
+{
+    List list;
+    list_create(&list, sizeof(int), NULL);
+
+    for (int i = 0; i < 10; ++i)
+        list_push_back(&list, &i);
+    list_get(&list, 7);
+    list_set(&list, 3, &(int){ 42 });
+    list_insert(&list, 5, &(int){ 24 });
+
+#ifdef DS_STATS
+    ck_assert_uint_eq(list.stats.node_allocs, 11);
+    ck_assert_uint_eq(list.stats.node_frees, 0);
+    ck_assert_uint_eq(list.stats.chase_steps, 7 + 3 + 4);
+#endif
+    list_stats_dump(&list);
+
+    list_free(&list);
+#ifdef DS_STATS
+    ck_assert_uint_eq(list.stats.node_frees, 11);
+#endif
+}
+END_TEST
+
 Suite *list_suite(void)
 {
     Suite* s = suite_create("List");
@@ -191,6 +357,8 @@ Suite *list_suite(void)
 
     /* Construction. */
     tcase_add_test(tc_core, test_list_create);
+    tcase_add_test(tc_core, test_list_create_with_allocator);
+    tcase_add_test(tc_core, test_list_free_func);
 
     /* Sizeof. */
     tcase_add_test(tc_core, test_list_sizeof);
@@ -213,6 +381,13 @@ Suite *list_suite(void)
     /* Removal. */
     tcase_add_test(tc_core, test_list_pop_back);
 
+    /* Serialization. */
+    tcase_add_test(tc_core, test_list_write_read);
+    tcase_add_test(tc_core, test_list_read_corrupt);
+
+    /* Stats. */
+    tcase_add_test(tc_core, test_list_stats);
+
     suite_add_tcase(s, tc_core);
 
     return s;
@@ -245,3 +420,31 @@ static size_t list_fill_with_strings(List* list)
 
     return sizeof(strings) / sizeof(strings[0]);
 }
+
+/*
+ * Like list_fill_with_strings(), with heap copies the list must free.
+ */
+static void list_fill_with_copies(List* list)
+{
+    List strings;
+    list_create(&strings, sizeof(char*), NULL);
+
+    size_t count = list_fill_with_strings(&strings);
+    for (size_t i = 0; i < count; ++i) {
+        char* copy = strdup(*(char**) list_get(&strings, i));
+        list_push_back(list, &copy);
+    }
+
+    list_free(&strings);
+}
+
+static void str_free(void* s)
+{
+    free(*(char**) s);
+    free(s);
+}
+
+static void str_free_owned(void* s)
+{
+    free(*(char**) s);
+}
@@ -0,0 +1,292 @@
+#include "../src/ring.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NUM_MSGS         4000000
+#define NUM_ROUND_TRIPS  100000
+#define RING_CAPACITY    1024
+#define BATCH_SIZE       32
+
+/*
+ * A kind of queue under test, seen through push_n/pop_n so that every kind
+ * runs the same producer and consumer loops. Latency runs use both queues,
+ * one per direction.
+ */
+typedef struct {
+    const char* name;
+    size_t (*push_n)(void* queue, const void* array, size_t count);
+    size_t (*pop_n)(void* queue, void* array, size_t count);
+    void* queues[2];
+    size_t batch;
+} Queue;
+
+/*
+ * Baseline: a mutex-protected linked list with one malloc per message,
+ * which is how records are handed between threads without a ring.
+ */
+typedef struct LockedNode {
+    struct LockedNode* next;
+    uint64_t value;
+} LockedNode;
+
+typedef struct {
+    pthread_mutex_t lock;
+    LockedNode* head;
+    LockedNode* tail;
+} LockedQueue;
+
+static size_t spsc_push_n(void*, const void*, size_t);
+static size_t spsc_pop_n(void*, void*, size_t);
+static size_t mpmc_push_n(void*, const void*, size_t);
+static size_t mpmc_pop_n(void*, void*, size_t);
+static size_t locked_push_n(void*, const void*, size_t);
+static size_t locked_pop_n(void*, void*, size_t);
+
+static void* producer_main(void*);
+static void* echo_main(void*);
+
+static void bench_throughput(const Queue*);
+static void bench_latency(const Queue*);
+
+static void push_all(const Queue*, size_t index, const uint64_t* array,
+                     size_t count);
+static void pop_all(const Queue*, size_t index, uint64_t* array,
+                    size_t count);
+
+static int u64_cmp(const void*, const void*);
+static uint64_t now_ns(void);
+
+int main()
+{
+    SpscRing spsc[2];
+    MpmcRing mpmc[2];
+    LockedQueue locked[2];
+
+    for (int i = 0; i < 2; ++i) {
+        spsc_ring_create(&spsc[i], sizeof(uint64_t), RING_CAPACITY);
+        mpmc_ring_create(&mpmc[i], sizeof(uint64_t), RING_CAPACITY);
+        pthread_mutex_init(&locked[i].lock, NULL);
+        locked[i].head = locked[i].tail = NULL;
+    }
+
+    Queue queues[] = {
+        { "spsc",       spsc_push_n, spsc_pop_n, { &spsc[0], &spsc[1] }, 1 },
+        { "spsc/batch", spsc_push_n, spsc_pop_n, { &spsc[0], &spsc[1] },
+          BATCH_SIZE },
+        { "mpmc",       mpmc_push_n, mpmc_pop_n, { &mpmc[0], &mpmc[1] }, 1 },
+        { "mpmc/batch", mpmc_push_n, mpmc_pop_n, { &mpmc[0], &mpmc[1] },
+          BATCH_SIZE },
+        { "mutex+list", locked_push_n, locked_pop_n,
+          { &locked[0], &locked[1] }, 1 },
+    };
+
+    printf("%-12s %12s %10s %10s %10s\n",
+           "QUEUE", "Mmsg/s", "p50 ns", "p99 ns", "p99.9 ns");
+
+    for (size_t q = 0; q < sizeof(queues) / sizeof(queues[0]); ++q) {
+        printf("%-12s", queues[q].name);
+        bench_throughput(&queues[q]);
+        bench_latency(&queues[q]);
+        printf("\n");
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        spsc_ring_free(&spsc[i]);
+        mpmc_ring_free(&mpmc[i]);
+        pthread_mutex_destroy(&locked[i].lock);
+    }
+
+    return 0;
+}
+
+/*
+ * One producer thread sends NUM_MSGS sequence numbers, batch at a time,
+ * while the calling thread receives and checks them.
+ */
+static void bench_throughput(const Queue* queue)
+{
+    pthread_t producer;
+    uint64_t batch[BATCH_SIZE];
+    uint64_t expected = 0;
+
+    uint64_t start = now_ns();
+    pthread_create(&producer, NULL, producer_main, (void*) queue);
+
+    while (expected < NUM_MSGS) {
+        size_t n = queue->pop_n(queue->queues[0], batch, BATCH_SIZE);
+        if (n == 0)
+            sched_yield();
+        for (size_t i = 0; i < n; ++i) {
+            if (batch[i] != expected++)
+                fprintf(stderr, "%s: message out of order\n", queue->name);
+        }
+    }
+    pthread_join(producer, NULL);
+
+    double seconds = (now_ns() - start) / 1e9;
+    printf(" %12.2f", NUM_MSGS / seconds / 1e6);
+}
+
+/*
+ * Round trips of a single message: the calling thread sends a timestamp on
+ * ping and an echo thread returns it on pong.
+ */
+static void bench_latency(const Queue* queue)
+{
+    pthread_t echo;
+    uint64_t* samples = malloc(NUM_ROUND_TRIPS * sizeof(uint64_t));
+
+    pthread_create(&echo, NULL, echo_main, (void*) queue);
+
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) {
+        uint64_t sent = now_ns(), received;
+        push_all(queue, 0, &sent, 1);
+        pop_all(queue, 1, &received, 1);
+        samples[i] = now_ns() - received;
+    }
+    pthread_join(echo, NULL);
+
+    qsort(samples, NUM_ROUND_TRIPS, sizeof(uint64_t), u64_cmp);
+    printf(" %10llu %10llu %10llu",
+           (unsigned long long) samples[NUM_ROUND_TRIPS / 2],
+           (unsigned long long) samples[NUM_ROUND_TRIPS * 99 / 100],
+           (unsigned long long) samples[NUM_ROUND_TRIPS * 999 / 1000]);
+
+    free(samples);
+}
+
+static void* producer_main(void* arg)
+{
+    const Queue* queue = arg;
+    uint64_t batch[BATCH_SIZE];
+
+    for (uint64_t next = 0; next < NUM_MSGS; next += queue->batch) {
+        size_t count = (NUM_MSGS - next < queue->batch) ? NUM_MSGS - next :
+                                                          queue->batch;
+        for (size_t i = 0; i < count; ++i)
+            batch[i] = next + i;
+        push_all(queue, 0, batch, count);
+    }
+    return NULL;
+}
+
+static void* echo_main(void* arg)
+{
+    const Queue* queue = arg;
+
+    for (size_t i = 0; i < NUM_ROUND_TRIPS; ++i) {
+        uint64_t value;
+        pop_all(queue, 0, &value, 1);
+        push_all(queue, 1, &value, 1);
+    }
+    return NULL;
+}
+
+/*
+ * Retry until everything went through, yielding whenever the queue is full
+ * (or empty) so that the bench also makes progress on a single CPU.
+ */
+static void push_all(const Queue* queue, size_t index, const uint64_t* array,
+                     size_t count)
+{
+    while (count > 0) {
+        size_t n = queue->push_n(queue->queues[index], array, count);
+        if (n == 0)
+            sched_yield();
+        array += n;
+        count -= n;
+    }
+}
+
+static void pop_all(const Queue* queue, size_t index, uint64_t* array,
+                    size_t count)
+{
+    while (count > 0) {
+        size_t n = queue->pop_n(queue->queues[index], array, count);
+        if (n == 0)
+            sched_yield();
+        array += n;
+        count -= n;
+    }
+}
+
+static size_t spsc_push_n(void* queue, const void* array, size_t count)
+{
+    return spsc_ring_push_n(queue, array, count);
+}
+
+static size_t spsc_pop_n(void* queue, void* array, size_t count)
+{
+    return spsc_ring_pop_n(queue, array, count);
+}
+
+static size_t mpmc_push_n(void* queue, const void* array, size_t count)
+{
+    return mpmc_ring_push_n(queue, array, count);
+}
+
+static size_t mpmc_pop_n(void* queue, void* array, size_t count)
+{
+    return mpmc_ring_pop_n(queue, array, count);
+}
+
+static size_t locked_push_n(void* queue_ptr, const void* array, size_t count)
+{
+    LockedQueue* queue = queue_ptr;
+    const uint64_t* values = array;
+
+    for (size_t i = 0; i < count; ++i) {
+        LockedNode* node = malloc(sizeof(LockedNode));
+        node->next = NULL;
+        node->value = values[i];
+
+        pthread_mutex_lock(&queue->lock);
+        if (queue->tail)
+            queue->tail->next = node;
+        else
+            queue->head = node;
+        queue->tail = node;
+        pthread_mutex_unlock(&queue->lock);
+    }
+    return count;
+}
+
+static size_t locked_pop_n(void* queue_ptr, void* array, size_t count)
+{
+    LockedQueue* queue = queue_ptr;
+    uint64_t* values = array;
+    size_t n = 0;
+
+    pthread_mutex_lock(&queue->lock);
+    while (n < count && queue->head) {
+        LockedNode* node = queue->head;
+        queue->head = node->next;
+        if (!queue->head)
+            queue->tail = NULL;
+        values[n++] = node->value;
+        free(node);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return n;
+}
+
+static int u64_cmp(const void* a_ptr, const void* b_ptr)
+{
+    uint64_t a_val = *(const uint64_t*) a_ptr;
+    uint64_t b_val = *(const uint64_t*) b_ptr;
+
+    return (a_val > b_val) - (a_val < b_val);
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
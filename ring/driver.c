@@ -0,0 +1,38 @@
+#include "src/ring.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_VALUES  10
+
+void* produce(void*);
+
+int main()
+{
+    SpscRing ring;
+    spsc_ring_create(&ring, sizeof(int), 4);
+
+    pthread_t producer;
+    pthread_create(&producer, NULL, produce, &ring);
+
+    for (int received = 0; received < NUM_VALUES;) {
+        int value;
+        if (spsc_ring_pop(&ring, &value)) {
+            printf("%d\n", value);
+            ++received;
+        }
+    }
+
+    pthread_join(producer, NULL);
+    spsc_ring_free(&ring);
+}
+
+void* produce(void* ring)
+{
+    for (int i = 0; i < NUM_VALUES;) {
+        if (spsc_ring_push(ring, &i))
+            ++i;
+    }
+    return NULL;
+}
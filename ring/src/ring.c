@@ -0,0 +1,400 @@
+#include "ring.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#define MIN_CAPACITY  2
+
+static size_t ring_round_capacity(size_t capacity);
+
+static void spsc_ring_copy_in(SpscRing*, size_t pos, const char* src,
+                              size_t count);
+static void spsc_ring_copy_out(const SpscRing*, size_t pos, char* dst,
+                               size_t count);
+
+static inline char* mpmc_ring_cell(const MpmcRing*, size_t pos);
+static inline _Atomic size_t* mpmc_ring_sequence(const MpmcRing*, size_t pos);
+
+/*
+ *                                Construction.
+ */
+
+SpscRing* spsc_ring_create(SpscRing* ring, size_t data_size, size_t capacity)
+{
+    return spsc_ring_create_with_allocator(ring, data_size, capacity,
+                                           &heap_allocator);
+}
+
+SpscRing* spsc_ring_create_with_allocator(SpscRing* ring, size_t data_size,
+                                          size_t capacity,
+                                          const Allocator* allocator)
+{
+    ring->data_size = data_size;
+    ring->capacity = ring_round_capacity(capacity);
+    ring->mask = ring->capacity - 1;
+    ring->allocator = allocator;
+    ring->buffer_ptr = allocator_alloc(allocator,
+                                       ring->capacity * data_size);
+    assert(ring->buffer_ptr);
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->cached_head = 0;
+    ring->cached_tail = 0;
+
+    return ring;
+}
+
+MpmcRing* mpmc_ring_create(MpmcRing* ring, size_t data_size, size_t capacity)
+{
+    return mpmc_ring_create_with_allocator(ring, data_size, capacity,
+                                           &heap_allocator);
+}
+
+MpmcRing* mpmc_ring_create_with_allocator(MpmcRing* ring, size_t data_size,
+                                          size_t capacity,
+                                          const Allocator* allocator)
+{
+    /* A cell is its sequence number followed by the element. */
+    size_t word = sizeof(size_t);
+
+    ring->data_size = data_size;
+    ring->capacity = ring_round_capacity(capacity);
+    ring->mask = ring->capacity - 1;
+    ring->cell_size = (word + data_size + word - 1) / word * word;
+    ring->allocator = allocator;
+    ring->buffer_ptr = allocator_alloc(allocator,
+                                       ring->capacity * ring->cell_size);
+    assert(ring->buffer_ptr);
+
+    for (size_t i = 0; i < ring->capacity; ++i)
+        atomic_init(mpmc_ring_sequence(ring, i), i);
+
+    atomic_init(&ring->enqueue_pos, 0);
+    atomic_init(&ring->dequeue_pos, 0);
+
+    return ring;
+}
+
+/*
+ *                                Destruction.
+ */
+
+void spsc_ring_free(SpscRing* ring)
+{
+    allocator_free(ring->allocator, ring->buffer_ptr,
+                   ring->capacity * ring->data_size);
+}
+
+void mpmc_ring_free(MpmcRing* ring)
+{
+    allocator_free(ring->allocator, ring->buffer_ptr,
+                   ring->capacity * ring->cell_size);
+}
+
+/*
+ *                                    Size.
+ */
+
+/*
+ * Number of queued elements. Exact when called by the producer or consumer
+ * of a quiescent ring; otherwise a snapshot that may already be stale.
+ */
+size_t spsc_ring_size(SpscRing* ring)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    return tail - head;
+}
+
+size_t mpmc_ring_size(MpmcRing* ring)
+{
+    size_t dequeue = atomic_load_explicit(&ring->dequeue_pos,
+                                          memory_order_acquire);
+    size_t enqueue = atomic_load_explicit(&ring->enqueue_pos,
+                                          memory_order_acquire);
+
+    /* The two loads are not atomic together, so clamp the difference. */
+    if ((intptr_t) (enqueue - dequeue) < 0)
+        return 0;
+    if (enqueue - dequeue > ring->capacity)
+        return ring->capacity;
+    return enqueue - dequeue;
+}
+
+/*
+ *                                  Insertion.
+ */
+
+bool spsc_ring_push(SpscRing* ring, const void* data_ptr)
+{
+    return spsc_ring_push_n(ring, data_ptr, 1) == 1;
+}
+
+/*
+ * Appends up to count elements from array and returns how many fit. Only
+ * the producer thread may call this.
+ */
+size_t spsc_ring_push_n(SpscRing* ring, const void* array, size_t count)
+{
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t free_slots = ring->capacity - (tail - ring->cached_head);
+
+    if (free_slots < count) {
+        ring->cached_head = atomic_load_explicit(&ring->head,
+                                                 memory_order_acquire);
+        free_slots = ring->capacity - (tail - ring->cached_head);
+    }
+
+    size_t n = (count < free_slots) ? count : free_slots;
+    if (n == 0)
+        return 0;
+
+    spsc_ring_copy_in(ring, tail, array, n);
+    atomic_store_explicit(&ring->tail, tail + n, memory_order_release);
+
+    return n;
+}
+
+bool mpmc_ring_push(MpmcRing* ring, const void* data_ptr)
+{
+    size_t pos = atomic_load_explicit(&ring->enqueue_pos,
+                                      memory_order_relaxed);
+    _Atomic size_t* sequence;
+
+    for (;;) {
+        sequence = mpmc_ring_sequence(ring, pos);
+        size_t seq = atomic_load_explicit(sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &ring->enqueue_pos, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            /* The cell still holds an element from the previous lap. */
+            return false;
+        } else {
+            pos = atomic_load_explicit(&ring->enqueue_pos,
+                                       memory_order_relaxed);
+        }
+    }
+
+    memcpy((char*) sequence + sizeof(size_t), data_ptr, ring->data_size);
+    atomic_store_explicit(sequence, pos + 1, memory_order_release);
+
+    return true;
+}
+
+/*
+ * Claims as many consecutive free cells as are available, up to count, with
+ * a single CAS, then fills and publishes them. Returns the number pushed.
+ */
+size_t mpmc_ring_push_n(MpmcRing* ring, const void* array, size_t count)
+{
+    size_t pos = atomic_load_explicit(&ring->enqueue_pos,
+                                      memory_order_relaxed);
+    size_t n;
+
+    if (count == 0)
+        return 0;
+
+    for (;;) {
+        for (n = 0; n < count; ++n) {
+            _Atomic size_t* sequence = mpmc_ring_sequence(ring, pos + n);
+            size_t seq = atomic_load_explicit(sequence, memory_order_acquire);
+            if (seq != pos + n)
+                break;
+        }
+
+        if (n > 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &ring->enqueue_pos, &pos, pos + n,
+                    memory_order_relaxed, memory_order_relaxed))
+                break;
+            continue;
+        }
+
+        size_t seq = atomic_load_explicit(mpmc_ring_sequence(ring, pos),
+                                          memory_order_acquire);
+        if ((intptr_t) seq - (intptr_t) pos < 0)
+            return 0;
+        pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        _Atomic size_t* sequence = mpmc_ring_sequence(ring, pos + i);
+        memcpy((char*) sequence + sizeof(size_t),
+               (const char*) array + i * ring->data_size, ring->data_size);
+        atomic_store_explicit(sequence, pos + i + 1, memory_order_release);
+    }
+
+    return n;
+}
+
+/*
+ *                                   Removal.
+ */
+
+bool spsc_ring_pop(SpscRing* ring, void* data_ptr)
+{
+    return spsc_ring_pop_n(ring, data_ptr, 1) == 1;
+}
+
+/*
+ * Moves up to count of the oldest elements into array and returns how many
+ * were moved. Only the consumer thread may call this.
+ */
+size_t spsc_ring_pop_n(SpscRing* ring, void* array, size_t count)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t available = ring->cached_tail - head;
+
+    if (available < count) {
+        ring->cached_tail = atomic_load_explicit(&ring->tail,
+                                                 memory_order_acquire);
+        available = ring->cached_tail - head;
+    }
+
+    size_t n = (count < available) ? count : available;
+    if (n == 0)
+        return 0;
+
+    spsc_ring_copy_out(ring, head, array, n);
+    atomic_store_explicit(&ring->head, head + n, memory_order_release);
+
+    return n;
+}
+
+bool mpmc_ring_pop(MpmcRing* ring, void* data_ptr)
+{
+    size_t pos = atomic_load_explicit(&ring->dequeue_pos,
+                                      memory_order_relaxed);
+    _Atomic size_t* sequence;
+
+    for (;;) {
+        sequence = mpmc_ring_sequence(ring, pos);
+        size_t seq = atomic_load_explicit(sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &ring->dequeue_pos, &pos, pos + 1,
+                    memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            /* The cell has not been filled in this lap yet. */
+            return false;
+        } else {
+            pos = atomic_load_explicit(&ring->dequeue_pos,
+                                       memory_order_relaxed);
+        }
+    }
+
+    memcpy(data_ptr, (char*) sequence + sizeof(size_t), ring->data_size);
+    atomic_store_explicit(sequence, pos + ring->capacity,
+                          memory_order_release);
+
+    return true;
+}
+
+size_t mpmc_ring_pop_n(MpmcRing* ring, void* array, size_t count)
+{
+    size_t pos = atomic_load_explicit(&ring->dequeue_pos,
+                                      memory_order_relaxed);
+    size_t n;
+
+    if (count == 0)
+        return 0;
+
+    for (;;) {
+        for (n = 0; n < count; ++n) {
+            _Atomic size_t* sequence = mpmc_ring_sequence(ring, pos + n);
+            size_t seq = atomic_load_explicit(sequence, memory_order_acquire);
+            if (seq != pos + n + 1)
+                break;
+        }
+
+        if (n > 0) {
+            if (atomic_compare_exchange_weak_explicit(
+                    &ring->dequeue_pos, &pos, pos + n,
+                    memory_order_relaxed, memory_order_relaxed))
+                break;
+            continue;
+        }
+
+        size_t seq = atomic_load_explicit(mpmc_ring_sequence(ring, pos),
+                                          memory_order_acquire);
+        if ((intptr_t) seq - (intptr_t) (pos + 1) < 0)
+            return 0;
+        pos = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        _Atomic size_t* sequence = mpmc_ring_sequence(ring, pos + i);
+        memcpy((char*) array + i * ring->data_size,
+               (char*) sequence + sizeof(size_t), ring->data_size);
+        atomic_store_explicit(sequence, pos + i + ring->capacity,
+                              memory_order_release);
+    }
+
+    return n;
+}
+
+/*
+ *                                  Internal.
+ */
+
+static size_t ring_round_capacity(size_t capacity)
+{
+    size_t rounded = MIN_CAPACITY;
+
+    while (rounded < capacity)
+        rounded *= 2;
+    return rounded;
+}
+
+/*
+ * Copies count elements into the slots starting at pos, wrapping around the
+ * end of the buffer at most once.
+ */
+static void spsc_ring_copy_in(SpscRing* ring, size_t pos, const char* src,
+                              size_t count)
+{
+    size_t index = pos & ring->mask;
+    size_t first = ring->capacity - index;
+    first = (count < first) ? count : first;
+
+    memcpy((char*) ring->buffer_ptr + index * ring->data_size, src,
+           first * ring->data_size);
+    memcpy(ring->buffer_ptr, src + first * ring->data_size,
+           (count - first) * ring->data_size);
+}
+
+static void spsc_ring_copy_out(const SpscRing* ring, size_t pos, char* dst,
+                               size_t count)
+{
+    size_t index = pos & ring->mask;
+    size_t first = ring->capacity - index;
+    first = (count < first) ? count : first;
+
+    memcpy(dst, (char*) ring->buffer_ptr + index * ring->data_size,
+           first * ring->data_size);
+    memcpy(dst + first * ring->data_size, ring->buffer_ptr,
+           (count - first) * ring->data_size);
+}
+
+static inline char* mpmc_ring_cell(const MpmcRing* ring, size_t pos)
+{
+    return (char*) ring->buffer_ptr + (pos & ring->mask) * ring->cell_size;
+}
+
+static inline _Atomic size_t* mpmc_ring_sequence(const MpmcRing* ring,
+                                                 size_t pos)
+{
+    return (_Atomic size_t*) mpmc_ring_cell(ring, pos);
+}
@@ -0,0 +1,125 @@
+#ifndef RING_H
+#define RING_H
+
+#include "../../common/src/allocator.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RING_CACHE_LINE  64
+
+/*
+ * Bounded single-producer single-consumer ring of fixed-size elements,
+ * stored by value. Capacity is rounded up to a power of two. The producer
+ * owns tail and the consumer owns head; each keeps a cached copy of the
+ * other side's index on its own cache line and rereads the shared index
+ * only when the cached one says the ring is full (or empty).
+ */
+
+typedef struct {
+    size_t data_size;
+    size_t capacity;
+    size_t mask;
+    void* buffer_ptr;
+    const Allocator* allocator;
+
+    _Alignas(RING_CACHE_LINE) _Atomic size_t head;
+    size_t cached_tail;
+
+    _Alignas(RING_CACHE_LINE) _Atomic size_t tail;
+    size_t cached_head;
+} SpscRing;
+
+/*
+ * Bounded multi-producer multi-consumer ring after Dmitry Vyukov's design:
+ * every cell carries a sequence number that tells producers and consumers
+ * whose turn it is, so a push or pop is one CAS on the shared position
+ * plus uncontended accesses to the claimed cell.
+ */
+
+typedef struct {
+    size_t data_size;
+    size_t capacity;
+    size_t mask;
+    size_t cell_size;
+    void* buffer_ptr;
+    const Allocator* allocator;
+
+    _Alignas(RING_CACHE_LINE) _Atomic size_t enqueue_pos;
+    _Alignas(RING_CACHE_LINE) _Atomic size_t dequeue_pos;
+} MpmcRing;
+
+/*
+ * Construction.
+ */
+
+SpscRing* spsc_ring_create(SpscRing* ring, size_t data_size, size_t capacity);
+
+SpscRing* spsc_ring_create_with_allocator(SpscRing* ring, size_t data_size,
+                                          size_t capacity, const Allocator*);
+
+MpmcRing* mpmc_ring_create(MpmcRing* ring, size_t data_size, size_t capacity);
+
+MpmcRing* mpmc_ring_create_with_allocator(MpmcRing* ring, size_t data_size,
+                                          size_t capacity, const Allocator*);
+
+/*
+ * Destruction.
+ */
+
+void spsc_ring_free(SpscRing* ring);
+
+void mpmc_ring_free(MpmcRing* ring);
+
+/*
+ * Size.
+ */
+
+static inline size_t spsc_ring_capacity(const SpscRing* ring)
+{
+    return ring->capacity;
+}
+
+static inline size_t mpmc_ring_capacity(const MpmcRing* ring)
+{
+    return ring->capacity;
+}
+
+size_t spsc_ring_size(SpscRing* ring);
+
+size_t mpmc_ring_size(MpmcRing* ring);
+
+/*
+ * Insertion.
+ */
+
+bool spsc_ring_push(SpscRing* ring, const void* data_ptr);
+
+size_t spsc_ring_push_n(SpscRing* ring, const void* array, size_t count);
+
+bool mpmc_ring_push(MpmcRing* ring, const void* data_ptr);
+
+size_t mpmc_ring_push_n(MpmcRing* ring, const void* array, size_t count);
+
+/*
+ * Removal.
+ */
+
+bool spsc_ring_pop(SpscRing* ring, void* data_ptr);
+
+size_t spsc_ring_pop_n(SpscRing* ring, void* array, size_t count);
+
+bool mpmc_ring_pop(MpmcRing* ring, void* data_ptr);
+
+size_t mpmc_ring_pop_n(MpmcRing* ring, void* array, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_H */
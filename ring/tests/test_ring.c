@@ -0,0 +1,377 @@
+#include "../src/ring.h"
+
+#include <check.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define NUM_ITEMS      100000
+#define NUM_PRODUCERS  3
+#define NUM_CONSUMERS  3
+
+typedef struct {
+    uint32_t id;
+    uint32_t value;
+    uint64_t pad;
+} Item;
+
+typedef struct {
+    MpmcRing* ring;
+    uint32_t id;
+    uint64_t sum;
+    size_t count;
+    bool in_order;
+} Worker;
+
+static void* spsc_producer(void*);
+static void* mpmc_producer(void*);
+static void* mpmc_consumer(void*);
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_spsc_ring_create)
+{
+    SpscRing ring;
+    spsc_ring_create(&ring, sizeof(int), 100);
+
+    ck_assert_uint_eq(ring.data_size, sizeof(int));
+    ck_assert_uint_eq(spsc_ring_capacity(&ring), 128);
+    ck_assert_uint_eq(spsc_ring_size(&ring), 0);
+
+    spsc_ring_free(&ring);
+}
+END_TEST
+
+START_TEST(test_mpmc_ring_create)
+{
+    MpmcRing ring;
+    mpmc_ring_create(&ring, sizeof(Item), 1);
+
+    ck_assert_uint_eq(ring.data_size, sizeof(Item));
+    ck_assert_uint_eq(mpmc_ring_capacity(&ring), 2);
+    ck_assert_uint_eq(mpmc_ring_size(&ring), 0);
+
+    mpmc_ring_free(&ring);
+}
+END_TEST
+
+/*
+ *                                  Insertion.
+ */
+
+START_TEST(test_spsc_ring_push_pop)
+{
+    SpscRing ring;
+    spsc_ring_create(&ring, sizeof(int), 4);
+
+    for (int i = 0; i < 4; ++i)
+        ck_assert(spsc_ring_push(&ring, &i));
+
+    int full = 4;
+    ck_assert(!spsc_ring_push(&ring, &full));
+    ck_assert_uint_eq(spsc_ring_size(&ring), 4);
+
+    /* Wrap around the end of the buffer a few times. */
+    for (int i = 0; i < 20; ++i) {
+        int out;
+        ck_assert(spsc_ring_pop(&ring, &out));
+        ck_assert_int_eq(out, i);
+
+        int in = i + 4;
+        ck_assert(spsc_ring_push(&ring, &in));
+    }
+
+    int out;
+    for (int i = 20; i < 24; ++i) {
+        ck_assert(spsc_ring_pop(&ring, &out));
+        ck_assert_int_eq(out, i);
+    }
+    ck_assert(!spsc_ring_pop(&ring, &out));
+
+    spsc_ring_free(&ring);
+}
+END_TEST
+
+START_TEST(test_mpmc_ring_push_pop)
+{
+    MpmcRing ring;
+    mpmc_ring_create(&ring, sizeof(int), 4);
+
+    for (int i = 0; i < 4; ++i)
+        ck_assert(mpmc_ring_push(&ring, &i));
+
+    int full = 4;
+    ck_assert(!mpmc_ring_push(&ring, &full));
+    ck_assert_uint_eq(mpmc_ring_size(&ring), 4);
+
+    for (int i = 0; i < 20; ++i) {
+        int out;
+        ck_assert(mpmc_ring_pop(&ring, &out));
+        ck_assert_int_eq(out, i);
+
+        int in = i + 4;
+        ck_assert(mpmc_ring_push(&ring, &in));
+    }
+
+    int out;
+    for (int i = 20; i < 24; ++i) {
+        ck_assert(mpmc_ring_pop(&ring, &out));
+        ck_assert_int_eq(out, i);
+    }
+    ck_assert(!mpmc_ring_pop(&ring, &out));
+
+    mpmc_ring_free(&ring);
+}
+END_TEST
+
+/*
+ *                                   Batches.
+ */
+
+START_TEST(test_spsc_ring_batch)
+{
+    SpscRing ring;
+    spsc_ring_create(&ring, sizeof(int), 8);
+
+    int in[10], out[10];
+    for (int i = 0; i < 10; ++i)
+        in[i] = i;
+
+    ck_assert_uint_eq(spsc_ring_push_n(&ring, in, 5), 5);
+    ck_assert_uint_eq(spsc_ring_pop_n(&ring, out, 3), 3);
+    ck_assert_int_eq(out[2], 2);
+
+    /* Only 6 slots are free; the copy wraps at the end of the buffer. */
+    ck_assert_uint_eq(spsc_ring_push_n(&ring, in, 10), 6);
+    ck_assert_uint_eq(spsc_ring_size(&ring), 8);
+
+    ck_assert_uint_eq(spsc_ring_pop_n(&ring, out, 10), 8);
+    ck_assert_int_eq(out[0], 3);
+    ck_assert_int_eq(out[1], 4);
+    for (int i = 0; i < 6; ++i)
+        ck_assert_int_eq(out[i + 2], i);
+
+    ck_assert_uint_eq(spsc_ring_pop_n(&ring, out, 10), 0);
+
+    spsc_ring_free(&ring);
+}
+END_TEST
+
+START_TEST(test_mpmc_ring_batch)
+{
+    MpmcRing ring;
+    mpmc_ring_create(&ring, sizeof(int), 8);
+
+    int in[10], out[10];
+    for (int i = 0; i < 10; ++i)
+        in[i] = i;
+
+    ck_assert_uint_eq(mpmc_ring_push_n(&ring, in, 5), 5);
+    ck_assert_uint_eq(mpmc_ring_pop_n(&ring, out, 3), 3);
+    ck_assert_int_eq(out[2], 2);
+
+    ck_assert_uint_eq(mpmc_ring_push_n(&ring, in, 10), 6);
+    ck_assert_uint_eq(mpmc_ring_size(&ring), 8);
+    ck_assert_uint_eq(mpmc_ring_push_n(&ring, in, 1), 0);
+
+    ck_assert_uint_eq(mpmc_ring_pop_n(&ring, out, 10), 8);
+    ck_assert_int_eq(out[0], 3);
+    ck_assert_int_eq(out[1], 4);
+    for (int i = 0; i < 6; ++i)
+        ck_assert_int_eq(out[i + 2], i);
+
+    ck_assert_uint_eq(mpmc_ring_pop_n(&ring, out, 10), 0);
+
+    mpmc_ring_free(&ring);
+}
+END_TEST
+
+/*
+ *                                 Concurrency.
+ */
+
+START_TEST(test_spsc_ring_threads)
+{
+    SpscRing ring;
+    spsc_ring_create(&ring, sizeof(uint64_t), 64);
+
+    pthread_t producer;
+    pthread_create(&producer, NULL, spsc_producer, &ring);
+
+    bool in_order = true;
+    uint64_t expected = 0, batch[16];
+
+    while (expected < NUM_ITEMS) {
+        size_t n = spsc_ring_pop_n(&ring, batch, 16);
+        if (n == 0)
+            sched_yield();
+        for (size_t i = 0; i < n; ++i)
+            in_order &= (batch[i] == expected++);
+    }
+    pthread_join(producer, NULL);
+
+    ck_assert(in_order);
+    ck_assert_uint_eq(spsc_ring_size(&ring), 0);
+
+    spsc_ring_free(&ring);
+}
+END_TEST
+
+START_TEST(test_mpmc_ring_threads)
+{
+    MpmcRing ring;
+    mpmc_ring_create(&ring, sizeof(Item), 64);
+
+    pthread_t producers[NUM_PRODUCERS], consumers[NUM_CONSUMERS];
+    Worker producer_args[NUM_PRODUCERS], consumer_args[NUM_CONSUMERS];
+
+    for (uint32_t p = 0; p < NUM_PRODUCERS; ++p) {
+        producer_args[p] = (Worker) { &ring, p, 0, 0, true };
+        pthread_create(&producers[p], NULL, mpmc_producer, &producer_args[p]);
+    }
+    for (uint32_t c = 0; c < NUM_CONSUMERS; ++c) {
+        consumer_args[c] = (Worker) { &ring, c, 0, 0, true };
+        pthread_create(&consumers[c], NULL, mpmc_consumer, &consumer_args[c]);
+    }
+
+    for (size_t p = 0; p < NUM_PRODUCERS; ++p)
+        pthread_join(producers[p], NULL);
+    for (size_t c = 0; c < NUM_CONSUMERS; ++c)
+        pthread_join(consumers[c], NULL);
+
+    uint64_t sum = 0;
+    size_t count = 0;
+    for (size_t c = 0; c < NUM_CONSUMERS; ++c) {
+        sum += consumer_args[c].sum;
+        count += consumer_args[c].count;
+        ck_assert(consumer_args[c].in_order);
+    }
+
+    ck_assert_uint_eq(count, (size_t) NUM_PRODUCERS * NUM_ITEMS);
+    ck_assert_uint_eq(sum, (uint64_t) NUM_PRODUCERS *
+                           ((uint64_t) NUM_ITEMS * (NUM_ITEMS - 1) / 2));
+
+    mpmc_ring_free(&ring);
+}
+END_TEST
+
+Suite* ring_suite(void)
+{
+    Suite* s = suite_create("Ring");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_spsc_ring_create);
+    tcase_add_test(tc_core, test_mpmc_ring_create);
+
+    /* Insertion. */
+    tcase_add_test(tc_core, test_spsc_ring_push_pop);
+    tcase_add_test(tc_core, test_mpmc_ring_push_pop);
+
+    /* Batches. */
+    tcase_add_test(tc_core, test_spsc_ring_batch);
+    tcase_add_test(tc_core, test_mpmc_ring_batch);
+
+    /* Concurrency. */
+    tcase_add_test(tc_core, test_spsc_ring_threads);
+    tcase_add_test(tc_core, test_mpmc_ring_threads);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = ring_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+static void* spsc_producer(void* arg)
+{
+    SpscRing* ring = arg;
+    uint64_t next = 0, batch[8];
+
+    /* Alternate single pushes and batches of up to 8. */
+    while (next < NUM_ITEMS) {
+        if (next % 2 == 0) {
+            if (spsc_ring_push(ring, &next))
+                ++next;
+            else
+                sched_yield();
+            continue;
+        }
+
+        size_t count = (NUM_ITEMS - next < 8) ? NUM_ITEMS - next : 8;
+        for (size_t i = 0; i < count; ++i)
+            batch[i] = next + i;
+        size_t pushed = spsc_ring_push_n(ring, batch, count);
+        if (pushed == 0)
+            sched_yield();
+        next += pushed;
+    }
+    return NULL;
+}
+
+static void* mpmc_producer(void* arg)
+{
+    Worker* worker = arg;
+    Item batch[4];
+    uint32_t next = 0;
+
+    while (next < NUM_ITEMS) {
+        size_t count = (NUM_ITEMS - next < 4) ? NUM_ITEMS - next : 4;
+        for (size_t i = 0; i < count; ++i)
+            batch[i] = (Item) { worker->id, next + (uint32_t) i, 0 };
+
+        size_t pushed = (count == 4 && next % 8 == 0) ?
+                        mpmc_ring_push_n(worker->ring, batch, count) :
+                        mpmc_ring_push(worker->ring, &batch[0]);
+        if (pushed == 0)
+            sched_yield();
+        next += (uint32_t) pushed;
+    }
+    return NULL;
+}
+
+/*
+ * Drains the ring until every producer's items are accounted for. Items
+ * from any one producer must arrive at each consumer in increasing order.
+ */
+static void* mpmc_consumer(void* arg)
+{
+    static _Atomic size_t consumed;
+    Worker* worker = arg;
+    int64_t last[NUM_PRODUCERS];
+    Item batch[4];
+
+    for (size_t p = 0; p < NUM_PRODUCERS; ++p)
+        last[p] = -1;
+
+    while (atomic_load(&consumed) < (size_t) NUM_PRODUCERS * NUM_ITEMS) {
+        size_t n = (worker->id % 2) ?
+                   mpmc_ring_pop_n(worker->ring, batch, 4) :
+                   mpmc_ring_pop(worker->ring, batch);
+        if (n == 0)
+            sched_yield();
+
+        for (size_t i = 0; i < n; ++i) {
+            worker->in_order &= ((int64_t) batch[i].value > last[batch[i].id]);
+            last[batch[i].id] = batch[i].value;
+            worker->sum += batch[i].value;
+        }
+        worker->count += n;
+        atomic_fetch_add(&consumed, n);
+    }
+    return NULL;
+}
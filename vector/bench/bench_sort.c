@@ -0,0 +1,124 @@
+#include "../src/vector.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NUM_ELEMS  10000000
+
+typedef struct {
+    uint64_t key;
+    uint64_t payload;
+} Record;
+
+static int u32_cmp(const void*, const void*);
+static int u64_cmp(const void*, const void*);
+
+static double now_ms(void);
+
+static void fill_random(Vector* v, size_t n, size_t data_size);
+
+static void bench_one(const char* name, size_t data_size, CmpFunc,
+                      void (*radix_sort)(Vector*));
+
+int main()
+{
+    printf("%-8s %9s %12s %12s %12s %12s\n",
+           "TYPE", "DATA_SIZE", "qsort ms", "sort ms", "radix ms",
+           "parallel ms");
+
+    bench_one("u32",    sizeof(uint32_t), u32_cmp, vector_sort_u32);
+    bench_one("u64",    sizeof(uint64_t), u64_cmp, vector_sort_u64);
+    bench_one("record", sizeof(Record),   u64_cmp, vector_sort_u64);
+
+    return 0;
+}
+
+/*
+ * Sorts the same NUM_ELEMS random elements with qsort, vector_sort, the
+ * matching radix sort and vector_parallel_sort on every online CPU, and
+ * prints the wall time of each.
+ */
+static void bench_one(const char* name, size_t data_size, CmpFunc cmp_func,
+                      void (*radix_sort)(Vector*))
+{
+    Vector original, v;
+    vector_create(&original, data_size, NULL);
+    vector_create(&v, data_size, NULL);
+
+    fill_random(&original, NUM_ELEMS, data_size);
+    vector_reserve(&v, NUM_ELEMS);
+
+    double times[4];
+
+    for (int k = 0; k < 4; ++k) {
+        vector_clear(&v);
+        vector_concat(&v, &original);
+
+        double start = now_ms();
+        switch (k) {
+        case 0:
+            qsort(vector_data(&v), vector_size(&v), data_size, cmp_func);
+            break;
+        case 1:
+            vector_sort(&v, cmp_func);
+            break;
+        case 2:
+            radix_sort(&v);
+            break;
+        case 3:
+            vector_parallel_sort(&v, cmp_func, 0);
+            break;
+        }
+        times[k] = now_ms() - start;
+
+        if (!vector_is_sorted(&v, cmp_func))
+            fprintf(stderr, "%s: pass %d did not sort\n", name, k);
+    }
+
+    printf("%-8s %9zu %12.1f %12.1f %12.1f %12.1f\n",
+           name, data_size, times[0], times[1], times[2], times[3]);
+
+    vector_free(&original);
+    vector_free(&v);
+}
+
+static void fill_random(Vector* v, size_t n, size_t data_size)
+{
+    uint64_t state = 88172645463325252ull;
+    unsigned char elem[sizeof(Record)] = { 0 };
+
+    for (size_t i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        memcpy(elem, &state, sizeof(state));
+        vector_push_back(v, elem);
+    }
+    (void) data_size;
+}
+
+static int u32_cmp(const void* a_ptr, const void* b_ptr)
+{
+    uint32_t a_val = *(const uint32_t*) a_ptr;
+    uint32_t b_val = *(const uint32_t*) b_ptr;
+
+    return (a_val > b_val) - (a_val < b_val);
+}
+
+static int u64_cmp(const void* a_ptr, const void* b_ptr)
+{
+    uint64_t a_val = *(const uint64_t*) a_ptr;
+    uint64_t b_val = *(const uint64_t*) b_ptr;
+
+    return (a_val > b_val) - (a_val < b_val);
+}
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
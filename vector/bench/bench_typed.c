@@ -0,0 +1,122 @@
+#include "../src/vector.h"
+#include "../src/vector_typed.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NUM_ELEMS   (1u << 22)
+#define NUM_ROUNDS  5
+
+typedef struct {
+    int64_t lo;
+    int64_t hi;
+} Pair;
+
+VECTOR_DEFINE(VectorI32,  vector_i32,  int32_t)
+VECTOR_DEFINE(VectorI64,  vector_i64,  int64_t)
+VECTOR_DEFINE(VectorPair, vector_pair, Pair)
+
+static double now_ns(void);
+
+static void report(const char* name, size_t data_size,
+                   double generic_ns, double typed_ns);
+
+/* Keeps the optimizer from discarding the measured loops. */
+static volatile int64_t sink;
+
+/*
+ * One benchmark round: push_back NUM_ELEMS elements, read them all back
+ * with get, reverse, then free. Leaves the best time over NUM_ROUNDS in
+ * `best`.
+ */
+
+#define BENCH_GENERIC(T, make)                                                \
+    do {                                                                      \
+        best = 1e30;                                                          \
+        for (int r = 0; r < NUM_ROUNDS; ++r) {                                \
+            double start = now_ns();                                          \
+            Vector v;                                                         \
+            vector_create(&v, sizeof(T), NULL);                               \
+            for (size_t i = 0; i < NUM_ELEMS; ++i) {                          \
+                T x = make(i);                                                \
+                vector_push_back(&v, &x);                                     \
+            }                                                                 \
+            int64_t acc = 0;                                                  \
+            for (size_t i = 0; i < NUM_ELEMS; ++i)                            \
+                acc += *(unsigned char*) vector_get(&v, i);                   \
+            vector_reverse(&v);                                               \
+            sink = acc;                                                       \
+            vector_free(&v);                                                  \
+            double elapsed = now_ns() - start;                                \
+            best = (elapsed < best) ? elapsed : best;                         \
+        }                                                                     \
+    } while (0)
+
+#define BENCH_TYPED(Name, prefix, T, make)                                    \
+    do {                                                                      \
+        best = 1e30;                                                          \
+        for (int r = 0; r < NUM_ROUNDS; ++r) {                                \
+            double start = now_ns();                                          \
+            Name v;                                                           \
+            prefix##_create(&v, NULL);                                        \
+            for (size_t i = 0; i < NUM_ELEMS; ++i)                            \
+                prefix##_push_back(&v, make(i));                              \
+            int64_t acc = 0;                                                  \
+            for (size_t i = 0; i < NUM_ELEMS; ++i)                            \
+                acc += *(unsigned char*) prefix##_at(&v, i);                  \
+            prefix##_reverse(&v);                                             \
+            sink = acc;                                                       \
+            prefix##_free(&v);                                                \
+            double elapsed = now_ns() - start;                                \
+            best = (elapsed < best) ? elapsed : best;                         \
+        }                                                                     \
+    } while (0)
+
+#define MAKE_I32(i)   ((int32_t) (i))
+#define MAKE_I64(i)   ((int64_t) (i))
+#define MAKE_PAIR(i)  ((Pair) { (int64_t) (i), (int64_t) (i) })
+
+int main()
+{
+    double best, generic_ns, typed_ns;
+
+    printf("%-8s %9s %14s %14s %8s\n",
+           "TYPE", "DATA_SIZE", "Vector ns/op", "typed ns/op", "SPEEDUP");
+
+    BENCH_GENERIC(int32_t, MAKE_I32);
+    generic_ns = best;
+    BENCH_TYPED(VectorI32, vector_i32, int32_t, MAKE_I32);
+    typed_ns = best;
+    report("int32", sizeof(int32_t), generic_ns, typed_ns);
+
+    BENCH_GENERIC(int64_t, MAKE_I64);
+    generic_ns = best;
+    BENCH_TYPED(VectorI64, vector_i64, int64_t, MAKE_I64);
+    typed_ns = best;
+    report("int64", sizeof(int64_t), generic_ns, typed_ns);
+
+    BENCH_GENERIC(Pair, MAKE_PAIR);
+    generic_ns = best;
+    BENCH_TYPED(VectorPair, vector_pair, Pair, MAKE_PAIR);
+    typed_ns = best;
+    report("pair", sizeof(Pair), generic_ns, typed_ns);
+
+    return 0;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report(const char* name, size_t data_size,
+                   double generic_ns, double typed_ns)
+{
+    printf("%-8s %9zu %14.2f %14.2f %7.2fx\n", name, data_size,
+           generic_ns / NUM_ELEMS, typed_ns / NUM_ELEMS,
+           generic_ns / typed_ns);
+}
@@ -0,0 +1,252 @@
+#include "../src/vector.h"
+#include "../../common/bench/array.h"
+#include "../../common/bench/bench.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_DATA_SIZE  64
+
+/*
+ * Insert/erase and random-get batches shrink as the vector grows, so that
+ * every sample moves about the same number of bytes.
+ */
+#define BATCH_BYTES  ((size_t) 1 << 20)
+#define MIN_BATCH    4
+#define MAX_BATCH    1024
+
+/* Odd multiplier: i * RANDOM_STRIDE modulo a power of two is a permutation. */
+#define RANDOM_STRIDE  2654435761u
+
+enum { FRONT, MIDDLE, BACK };
+
+typedef double (*SampleFunc)(size_t data_size, size_t size, int where);
+
+static void bench_op(FILE* csv, const char* op, SampleFunc array_sample,
+                     SampleFunc vector_sample, size_t data_size,
+                     size_t size, int where);
+
+static size_t batch_size(size_t size);
+
+static size_t position(size_t size, int where);
+
+/* Keeps the optimizer from discarding the measured loops. */
+static volatile uint64_t sink;
+
+/*
+ * One sample function per operation and container. Each builds its input
+ * untimed, times only the operation, and returns ns per element operated
+ * on. The bodies are shared between Vector and the array baseline.
+ */
+
+#define DEFINE_SAMPLES(T, prefix, CREATE)                                     \
+                                                                              \
+static void prefix##_fill(T* c, size_t data_size, size_t size)                \
+{                                                                             \
+    char elem[MAX_DATA_SIZE];                                                 \
+    CREATE(c, data_size);                                                     \
+    for (size_t i = 0; i < size; ++i) {                                       \
+        memset(elem, (int) i, data_size);                                     \
+        prefix##_push_back(c, elem);                                          \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static double prefix##_push_back_sample(size_t data_size, size_t size,        \
+                                        int where)                            \
+{                                                                             \
+    char elem[MAX_DATA_SIZE] = { 0 };                                         \
+    T c;                                                                      \
+    (void) where;                                                             \
+    CREATE(&c, data_size);                                                    \
+    double start = bench_now_ns();                                            \
+    for (size_t i = 0; i < size; ++i)                                         \
+        prefix##_push_back(&c, elem);                                         \
+    double elapsed = bench_now_ns() - start;                                  \
+    prefix##_free(&c);                                                        \
+    return elapsed / size;                                                    \
+}                                                                             \
+                                                                              \
+static double prefix##_insert_sample(size_t data_size, size_t size,           \
+                                     int where)                               \
+{                                                                             \
+    char elem[MAX_DATA_SIZE] = { 0 };                                         \
+    size_t batch = batch_size(size * data_size);                              \
+    T c;                                                                      \
+    prefix##_fill(&c, data_size, size);                                       \
+    prefix##_reserve(&c, size + batch);                                       \
+    double start = bench_now_ns();                                            \
+    for (size_t i = 0; i < batch; ++i)                                        \
+        prefix##_insert(&c, position(c.size, where), elem);                   \
+    double elapsed = bench_now_ns() - start;                                  \
+    prefix##_free(&c);                                                        \
+    return elapsed / batch;                                                   \
+}                                                                             \
+                                                                              \
+static double prefix##_erase_sample(size_t data_size, size_t size,            \
+                                    int where)                                \
+{                                                                             \
+    size_t batch = batch_size(size * data_size);                              \
+    batch = (batch < size) ? batch : size;                                    \
+    T c;                                                                      \
+    prefix##_fill(&c, data_size, size);                                       \
+    double start = bench_now_ns();                                            \
+    for (size_t i = 0; i < batch; ++i)                                        \
+        prefix##_erase(&c, position(c.size - 1, where));                      \
+    double elapsed = bench_now_ns() - start;                                  \
+    prefix##_free(&c);                                                        \
+    return elapsed / batch;                                                   \
+}                                                                             \
+                                                                              \
+static double prefix##_get_sample(size_t data_size, size_t size, int where)   \
+{                                                                             \
+    uint64_t acc = 0;                                                         \
+    T c;                                                                      \
+    (void) where;                                                             \
+    prefix##_fill(&c, data_size, size);                                       \
+    double start = bench_now_ns();                                            \
+    for (size_t i = 0; i < size; ++i)                                         \
+        acc += *(unsigned char*) prefix##_get(&c, (i * RANDOM_STRIDE) &       \
+                                                  (size - 1));                \
+    double elapsed = bench_now_ns() - start;                                  \
+    sink = acc;                                                               \
+    prefix##_free(&c);                                                        \
+    return elapsed / size;                                                    \
+}                                                                             \
+                                                                              \
+static double prefix##_iterate_sample(size_t data_size, size_t size,          \
+                                      int where)                              \
+{                                                                             \
+    uint64_t acc = 0;                                                         \
+    T c;                                                                      \
+    (void) where;                                                             \
+    prefix##_fill(&c, data_size, size);                                       \
+    double start = bench_now_ns();                                            \
+    for (size_t i = 0; i < size; ++i)                                         \
+        acc += *(unsigned char*) prefix##_get(&c, i);                         \
+    double elapsed = bench_now_ns() - start;                                  \
+    sink = acc;                                                               \
+    prefix##_free(&c);                                                        \
+    return elapsed / size;                                                    \
+}                                                                             \
+                                                                              \
+static double prefix##_concat_sample(size_t data_size, size_t size,           \
+                                     int where)                               \
+{                                                                             \
+    T dest, src;                                                              \
+    (void) where;                                                             \
+    prefix##_fill(&dest, data_size, size);                                    \
+    prefix##_fill(&src, data_size, size);                                     \
+    double start = bench_now_ns();                                            \
+    prefix##_concat(&dest, &src);                                             \
+    double elapsed = bench_now_ns() - start;                                  \
+    prefix##_free(&dest);                                                     \
+    prefix##_free(&src);                                                      \
+    return elapsed / size;                                                    \
+}                                                                             \
+                                                                              \
+static double prefix##_reverse_sample(size_t data_size, size_t size,          \
+                                      int where)                              \
+{                                                                             \
+    T c;                                                                      \
+    (void) where;                                                             \
+    prefix##_fill(&c, data_size, size);                                       \
+    double start = bench_now_ns();                                            \
+    prefix##_reverse(&c);                                                     \
+    double elapsed = bench_now_ns() - start;                                  \
+    sink = *(unsigned char*) prefix##_get(&c, 0);                             \
+    prefix##_free(&c);                                                        \
+    return elapsed / size;                                                    \
+}                                                                             \
+                                                                              \
+static double prefix##_free_sample(size_t data_size, size_t size, int where)  \
+{                                                                             \
+    T c;                                                                      \
+    (void) where;                                                             \
+    prefix##_fill(&c, data_size, size);                                       \
+    double start = bench_now_ns();                                            \
+    prefix##_free(&c);                                                        \
+    return (bench_now_ns() - start) / size;                                   \
+}
+
+#define ARRAY_CREATE(a, data_size)   array_create((a), (data_size))
+#define VECTOR_CREATE(v, data_size)  vector_create((v), (data_size), NULL)
+
+DEFINE_SAMPLES(Array,  array,  ARRAY_CREATE)
+DEFINE_SAMPLES(Vector, vector, VECTOR_CREATE)
+
+/*
+ * Every operation for element sizes of 4, 16 and 64 bytes and for vectors
+ * that fit in L1, in L2 and in neither. Prints a table and, given a file
+ * name, writes the same rows to it as CSV.
+ */
+int main(int argc, char** argv)
+{
+    static const size_t data_sizes[] = { 4, 16, MAX_DATA_SIZE };
+    static const size_t sizes[] = { 1u << 10, 1u << 15, 1u << 20 };
+
+    FILE* csv = bench_open_csv(argc, argv);
+    bench_print_header(csv);
+
+#define BENCH_OP(name, op, where)                                             \
+    bench_op(csv, name, array_##op##_sample, vector_##op##_sample,            \
+             data_sizes[d], sizes[s], where)
+
+    for (size_t d = 0; d < sizeof(data_sizes) / sizeof(data_sizes[0]); ++d) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            BENCH_OP("push_back",     push_back, BACK);
+            BENCH_OP("insert_front",  insert,    FRONT);
+            BENCH_OP("insert_middle", insert,    MIDDLE);
+            BENCH_OP("insert_back",   insert,    BACK);
+            BENCH_OP("erase_front",   erase,     FRONT);
+            BENCH_OP("erase_middle",  erase,     MIDDLE);
+            BENCH_OP("erase_back",    erase,     BACK);
+            BENCH_OP("get",           get,       BACK);
+            BENCH_OP("iterate",       iterate,   BACK);
+            BENCH_OP("concat",        concat,    BACK);
+            BENCH_OP("reverse",       reverse,   BACK);
+            BENCH_OP("free",          free,      BACK);
+        }
+    }
+
+#undef BENCH_OP
+
+    if (csv)
+        fclose(csv);
+
+    return 0;
+}
+
+/*
+ * Runs both containers and prints the array row, then the vector row
+ * relative to it.
+ */
+static void bench_op(FILE* csv, const char* op, SampleFunc array_sample,
+                     SampleFunc vector_sample, size_t data_size,
+                     size_t size, int where)
+{
+    double samples[BENCH_SAMPLES];
+
+    for (int i = 0; i < BENCH_SAMPLES; ++i)
+        samples[i] = array_sample(data_size, size, where);
+    BenchResult baseline = bench_summarize(samples, BENCH_SAMPLES);
+    bench_print_row(csv, "array", op, data_size, size, &baseline, 0);
+
+    for (int i = 0; i < BENCH_SAMPLES; ++i)
+        samples[i] = vector_sample(data_size, size, where);
+    BenchResult result = bench_summarize(samples, BENCH_SAMPLES);
+    bench_print_row(csv, "Vector", op, data_size, size, &result,
+                    baseline.p50);
+}
+
+static size_t batch_size(size_t bytes)
+{
+    size_t batch = BATCH_BYTES / (bytes ? bytes : 1);
+    return (batch < MIN_BATCH) ? MIN_BATCH :
+           (batch > MAX_BATCH) ? MAX_BATCH : batch;
+}
+
+static size_t position(size_t size, int where)
+{
+    return (where == FRONT) ? 0 : (where == MIDDLE) ? size / 2 : size;
+}
@@ -0,0 +1,345 @@
+#include "bit_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BIT_VECTOR_HAVE_X86_SIMD
+#endif
+
+#define WORD_BITS    BIT_VECTOR_WORD_BITS
+#define BLOCK_WORDS  BIT_VECTOR_RANK_BLOCK_WORDS
+#define BLOCK_BITS   (BLOCK_WORDS * WORD_BITS)
+
+typedef size_t (*PopcountKernel)(const uint64_t* words, size_t n);
+
+static PopcountKernel popcount_kernel(void);
+
+static size_t count_words(const uint64_t* words, size_t n);
+
+static size_t word_count(size_t num_bits);
+
+static void bit_vector_clear_tail(BitVector* bv);
+
+static size_t select_in_word(uint64_t word, size_t k);
+
+/*
+ *                                Construction.
+ */
+
+/*
+ * Creates a vector of num_bits zero bits.
+ */
+BitVector* bit_vector_create(BitVector* bv, size_t num_bits)
+{
+    vector_create(&bv->words, sizeof(uint64_t), NULL);
+    vector_create(&bv->rank_index, sizeof(uint64_t), NULL);
+    bv->size = 0;
+    bv->rank_valid = false;
+
+    return bit_vector_resize(bv, num_bits);
+}
+
+/*
+ *                                Destruction.
+ */
+
+void bit_vector_free(BitVector* bv)
+{
+    vector_free(&bv->words);
+    vector_free(&bv->rank_index);
+}
+
+/*
+ *                                    Size.
+ */
+
+/*
+ * Bits added by growing are zero; bits dropped by shrinking are cleared
+ * from the last word so that they do not come back on the next grow.
+ */
+BitVector* bit_vector_resize(BitVector* bv, size_t num_bits)
+{
+    size_t old_words = vector_size(&bv->words);
+    size_t new_words = word_count(num_bits);
+    uint64_t zero = 0;
+
+    if (new_words > old_words) {
+        vector_reserve(&bv->words, new_words);
+        for (size_t i = old_words; i < new_words; ++i)
+            vector_push_back(&bv->words, &zero);
+    } else {
+        vector_erase_range(&bv->words, new_words, old_words - new_words);
+    }
+
+    bv->size = num_bits;
+    bv->rank_valid = false;
+    bit_vector_clear_tail(bv);
+
+    return bv;
+}
+
+/*
+ *                                 Bit access.
+ */
+
+void bit_vector_push_back(BitVector* bv, bool value)
+{
+    if (bv->size % WORD_BITS == 0) {
+        uint64_t zero = 0;
+        vector_push_back(&bv->words, &zero);
+    }
+    ++bv->size;
+    bit_vector_assign(bv, bv->size - 1, value);
+}
+
+BitVector* bit_vector_fill(BitVector* bv, bool value)
+{
+    memset(vector_data(&bv->words), value ? 0xFF : 0,
+           vector_size(&bv->words) * sizeof(uint64_t));
+    bv->rank_valid = false;
+    bit_vector_clear_tail(bv);
+
+    return bv;
+}
+
+/*
+ *                              Bulk operations.
+ */
+
+/*
+ * Plain word loops, which the vectorizer turns into SIMD loads and stores
+ * for whatever vector width the target has. dest and src may be the same
+ * vector, so the pointers are not restrict: the loops are versioned on an
+ * overlap check instead.
+ */
+
+#define DEFINE_BULK_OP(name, expr)                                            \
+BitVector* bit_vector_##name(BitVector* dest, const BitVector* src)           \
+{                                                                             \
+    assert(dest->size == src->size);                                          \
+                                                                              \
+    uint64_t* a = vector_data(&dest->words);                                  \
+    const uint64_t* b = vector_data(&src->words);                             \
+    size_t n = vector_size(&dest->words);                                     \
+                                                                              \
+    for (size_t i = 0; i < n; ++i)                                            \
+        a[i] = (expr);                                                        \
+    dest->rank_valid = false;                                                 \
+                                                                              \
+    return dest;                                                              \
+}
+
+DEFINE_BULK_OP(and,    a[i] & b[i])
+DEFINE_BULK_OP(or,     a[i] | b[i])
+DEFINE_BULK_OP(xor,    a[i] ^ b[i])
+DEFINE_BULK_OP(andnot, a[i] & ~b[i])
+
+/*
+ *                                  Counting.
+ */
+
+size_t bit_vector_popcount(const BitVector* bv)
+{
+    return count_words(bit_vector_words(bv), vector_size(&bv->words));
+}
+
+/*
+ * Builds the rank index: entry b is the number of set bits before block b,
+ * and one final entry holds the total.
+ */
+void bit_vector_build_rank(BitVector* bv)
+{
+    const uint64_t* words = bit_vector_words(bv);
+    size_t num_words = vector_size(&bv->words);
+    uint64_t count = 0;
+
+    vector_clear(&bv->rank_index);
+    vector_reserve(&bv->rank_index, num_words / BLOCK_WORDS + 2);
+
+    for (size_t w = 0; w < num_words; w += BLOCK_WORDS) {
+        vector_push_back(&bv->rank_index, &count);
+        size_t n = (num_words - w < BLOCK_WORDS) ? num_words - w : BLOCK_WORDS;
+        count += count_words(words + w, n);
+    }
+    vector_push_back(&bv->rank_index, &count);
+
+    bv->rank_valid = true;
+}
+
+/*
+ * Number of set bits in positions [0, pos).
+ */
+size_t bit_vector_rank(const BitVector* bv, size_t pos)
+{
+    assert(pos <= bv->size);
+
+    const uint64_t* words = bit_vector_words(bv);
+    size_t word = pos / WORD_BITS;
+    size_t count;
+
+    if (bv->rank_valid) {
+        size_t block = pos / BLOCK_BITS;
+        count = ((const uint64_t*) vector_data(&bv->rank_index))[block];
+        for (size_t w = block * BLOCK_WORDS; w < word; ++w)
+            count += __builtin_popcountll(words[w]);
+    } else {
+        count = count_words(words, word);
+    }
+
+    if (pos % WORD_BITS) {
+        uint64_t mask = ((uint64_t) 1 << (pos % WORD_BITS)) - 1;
+        count += __builtin_popcountll(words[word] & mask);
+    }
+    return count;
+}
+
+/*
+ * Position of the set bit with rank k (the first set bit is k == 0), or
+ * VECTOR_NOT_FOUND if fewer than k + 1 bits are set.
+ */
+size_t bit_vector_select(const BitVector* bv, size_t k)
+{
+    const uint64_t* words = bit_vector_words(bv);
+    size_t num_words = vector_size(&bv->words);
+    size_t w = 0;
+
+    if (bv->rank_valid) {
+        const uint64_t* index = vector_data(&bv->rank_index);
+        size_t num_blocks = vector_size(&bv->rank_index) - 1;
+
+        if (k >= index[num_blocks])
+            return VECTOR_NOT_FOUND;
+
+        /* Last block with fewer than k + 1 set bits before it. */
+        size_t low = 0, high = num_blocks;
+        while (high - low > 1) {
+            size_t middle = low + (high - low) / 2;
+            if (index[middle] <= k)
+                low = middle;
+            else
+                high = middle;
+        }
+        k -= index[low];
+        w = low * BLOCK_WORDS;
+    }
+
+    for (; w < num_words; ++w) {
+        size_t count = __builtin_popcountll(words[w]);
+        if (k < count)
+            return w * WORD_BITS + select_in_word(words[w], k);
+        k -= count;
+    }
+    return VECTOR_NOT_FOUND;
+}
+
+/*
+ *                                  Internal.
+ */
+
+static size_t popcount_scalar(const uint64_t* words, size_t n)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i)
+        count += __builtin_popcountll(words[i]);
+    return count;
+}
+
+#ifdef BIT_VECTOR_HAVE_X86_SIMD
+
+/*
+ * Same loop as popcount_scalar, but compiled for POPCNT so that every
+ * word is one instruction rather than a bit-twiddling sequence.
+ */
+__attribute__((target("popcnt")))
+static size_t popcount_popcnt(const uint64_t* words, size_t n)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i)
+        count += __builtin_popcountll(words[i]);
+    return count;
+}
+
+/*
+ * Mula's nibble lookup: vpshufb counts the bits of every nibble of four
+ * words at once, and vpsadbw sums the byte counts into 64-bit lanes.
+ */
+__attribute__((target("avx2,popcnt")))
+static size_t popcount_avx2(const uint64_t* words, size_t n)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3,
+                                            1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3,
+                                            1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256((const __m256i*) (words + i));
+        __m256i lo = _mm256_and_si256(x, low_mask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask);
+        __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                        _mm256_shuffle_epi8(lookup, hi));
+        total = _mm256_add_epi64(total,
+                                 _mm256_sad_epu8(bytes,
+                                                 _mm256_setzero_si256()));
+    }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*) lanes, total);
+    size_t count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    for (; i < n; ++i)
+        count += __builtin_popcountll(words[i]);
+    return count;
+}
+
+#endif
+
+/*
+ * Runtime dispatch: AVX2 when the CPU has it, then POPCNT, then the
+ * portable loop.
+ */
+static PopcountKernel popcount_kernel(void)
+{
+#ifdef BIT_VECTOR_HAVE_X86_SIMD
+    if (__builtin_cpu_supports("avx2"))
+        return popcount_avx2;
+    if (__builtin_cpu_supports("popcnt"))
+        return popcount_popcnt;
+#endif
+    return popcount_scalar;
+}
+
+static size_t count_words(const uint64_t* words, size_t n)
+{
+    return popcount_kernel()(words, n);
+}
+
+static size_t word_count(size_t num_bits)
+{
+    return (num_bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+static void bit_vector_clear_tail(BitVector* bv)
+{
+    if (bv->size % WORD_BITS) {
+        uint64_t* words = vector_data(&bv->words);
+        words[bv->size / WORD_BITS] &=
+            ((uint64_t) 1 << (bv->size % WORD_BITS)) - 1;
+    }
+}
+
+/*
+ * Index of the set bit of word with rank k, which must exist.
+ */
+static size_t select_in_word(uint64_t word, size_t k)
+{
+    for (size_t i = 0; i < k; ++i)
+        word &= word - 1;
+    return __builtin_ctzll(word);
+}
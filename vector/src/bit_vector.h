@@ -0,0 +1,140 @@
+#ifndef BIT_VECTOR_H
+#define BIT_VECTOR_H
+
+#include "vector.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BIT_VECTOR_WORD_BITS  64
+
+/*
+ * Number of words summarized by one entry of the rank index. A rank query
+ * adds one index entry to at most this many word popcounts.
+ */
+#define BIT_VECTOR_RANK_BLOCK_WORDS  8
+
+/*
+ * Packed bit array: bit pos is bit pos % 64 of word pos / 64 of a Vector
+ * of uint64_t, so it grows with the same policy as any Vector. Bits past
+ * size in the last word are always zero.
+ *
+ * bit_vector_build_rank() adds a table with the number of set bits before
+ * every block of BIT_VECTOR_RANK_BLOCK_WORDS words, which makes rank O(1)
+ * and select O(log n). Any modification drops the table again; rank and
+ * select still work without it, in linear time.
+ */
+
+typedef struct {
+    Vector words;
+    size_t size;
+    Vector rank_index;
+    bool rank_valid;
+} BitVector;
+
+/*
+ * Construction.
+ */
+
+BitVector* bit_vector_create(BitVector* bv, size_t num_bits);
+
+/*
+ * Destruction.
+ */
+
+void bit_vector_free(BitVector* bv);
+
+/*
+ * Size.
+ */
+
+static inline size_t bit_vector_size(const BitVector* bv)
+{
+    return bv->size;
+}
+
+static inline const uint64_t* bit_vector_words(const BitVector* bv)
+{
+    return (const uint64_t*) vector_data(&bv->words);
+}
+
+BitVector* bit_vector_resize(BitVector* bv, size_t num_bits);
+
+/*
+ * Bit access.
+ */
+
+static inline bool bit_vector_test(const BitVector* bv, size_t pos)
+{
+    const uint64_t* words = bit_vector_words(bv);
+    assert(pos < bv->size);
+    return (words[pos / BIT_VECTOR_WORD_BITS] >>
+            (pos % BIT_VECTOR_WORD_BITS)) & 1;
+}
+
+static inline void bit_vector_set(BitVector* bv, size_t pos)
+{
+    uint64_t* words = (uint64_t*) vector_data(&bv->words);
+    assert(pos < bv->size);
+    words[pos / BIT_VECTOR_WORD_BITS] |=
+        (uint64_t) 1 << (pos % BIT_VECTOR_WORD_BITS);
+    bv->rank_valid = false;
+}
+
+static inline void bit_vector_clear(BitVector* bv, size_t pos)
+{
+    uint64_t* words = (uint64_t*) vector_data(&bv->words);
+    assert(pos < bv->size);
+    words[pos / BIT_VECTOR_WORD_BITS] &=
+        ~((uint64_t) 1 << (pos % BIT_VECTOR_WORD_BITS));
+    bv->rank_valid = false;
+}
+
+static inline void bit_vector_assign(BitVector* bv, size_t pos, bool value)
+{
+    if (value)
+        bit_vector_set(bv, pos);
+    else
+        bit_vector_clear(bv, pos);
+}
+
+void bit_vector_push_back(BitVector* bv, bool value);
+
+BitVector* bit_vector_fill(BitVector* bv, bool value);
+
+/*
+ * Bulk operations. Both operands must have the same size; the result is
+ * stored in dest, which may be src itself.
+ */
+
+BitVector* bit_vector_and(BitVector* dest, const BitVector* src);
+
+BitVector* bit_vector_or(BitVector* dest, const BitVector* src);
+
+BitVector* bit_vector_xor(BitVector* dest, const BitVector* src);
+
+BitVector* bit_vector_andnot(BitVector* dest, const BitVector* src);
+
+/*
+ * Counting.
+ */
+
+size_t bit_vector_popcount(const BitVector* bv);
+
+void bit_vector_build_rank(BitVector* bv);
+
+size_t bit_vector_rank(const BitVector* bv, size_t pos);
+
+size_t bit_vector_select(const BitVector* bv, size_t k);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIT_VECTOR_H */
@@ -0,0 +1,160 @@
+#include "column_vector.h"
+
+#include <assert.h>
+#include <string.h>
+
+static void column_vector_resize(ColumnVector* cv, size_t capacity);
+
+static inline char* column_vector_cell(const ColumnVector* cv, size_t pos,
+                                       size_t col);
+
+/*
+ *                                Construction.
+ */
+
+ColumnVector* column_vector_create(ColumnVector* cv, size_t row_size,
+                                   const ColumnField* fields,
+                                   size_t num_columns)
+{
+    return column_vector_create_with_allocator(cv, row_size, fields,
+                                               num_columns, &heap_allocator);
+}
+
+ColumnVector* column_vector_create_with_allocator(ColumnVector* cv,
+                                                  size_t row_size,
+                                                  const ColumnField* fields,
+                                                  size_t num_columns,
+                                                  const Allocator* allocator)
+{
+    assert(num_columns > 0 && num_columns <= COLUMN_VECTOR_MAX_COLUMNS);
+
+    cv->row_size = row_size;
+    cv->num_columns = num_columns;
+    cv->size = 0;
+    cv->capacity = VECTOR_INIT_CAPACITY;
+    cv->allocator = allocator;
+
+    for (size_t col = 0; col < num_columns; ++col) {
+        assert(fields[col].offset + fields[col].size <= row_size);
+        cv->fields[col] = fields[col];
+        cv->columns[col] = allocator_alloc(allocator,
+                                           cv->capacity * fields[col].size);
+        assert(cv->columns[col]);
+    }
+
+    return cv;
+}
+
+/*
+ *                                Destruction.
+ */
+
+void column_vector_free(ColumnVector* cv)
+{
+    for (size_t col = 0; col < cv->num_columns; ++col)
+        allocator_free(cv->allocator, cv->columns[col],
+                       cv->capacity * cv->fields[col].size);
+}
+
+/*
+ *                                  Indexing.
+ */
+
+void* column_vector_get(const ColumnVector* cv, size_t pos, size_t col)
+{
+    assert(pos < cv->size && col < cv->num_columns);
+    return column_vector_cell(cv, pos, col);
+}
+
+void column_vector_set(ColumnVector* cv, size_t pos, size_t col,
+                       const void* data_ptr)
+{
+    assert(pos < cv->size && col < cv->num_columns);
+    memcpy(column_vector_cell(cv, pos, col), data_ptr, cv->fields[col].size);
+}
+
+/*
+ * Gathers row pos into *row_out. Bytes of the row type not covered by any
+ * field are left untouched.
+ */
+void* column_vector_get_row(const ColumnVector* cv, size_t pos, void* row_out)
+{
+    assert(pos < cv->size);
+
+    for (size_t col = 0; col < cv->num_columns; ++col)
+        memcpy((char*) row_out + cv->fields[col].offset,
+               column_vector_cell(cv, pos, col), cv->fields[col].size);
+    return row_out;
+}
+
+void column_vector_set_row(ColumnVector* cv, size_t pos, const void* row)
+{
+    assert(pos < cv->size);
+
+    for (size_t col = 0; col < cv->num_columns; ++col)
+        memcpy(column_vector_cell(cv, pos, col),
+               (const char*) row + cv->fields[col].offset,
+               cv->fields[col].size);
+}
+
+/*
+ *                                  Insertion.
+ */
+
+void column_vector_push_back(ColumnVector* cv, const void* row)
+{
+    if (cv->size == cv->capacity)
+        column_vector_resize(cv, cv->capacity * VECTOR_GROW_FACTOR);
+
+    ++cv->size;
+    column_vector_set_row(cv, cv->size - 1, row);
+}
+
+/*
+ *                                   Removal.
+ */
+
+void column_vector_pop_back(ColumnVector* cv)
+{
+    assert(!column_vector_is_empty(cv));
+    --cv->size;
+}
+
+ColumnVector* column_vector_clear(ColumnVector* cv)
+{
+    cv->size = 0;
+    return cv;
+}
+
+/*
+ *                                   Resize.
+ */
+
+ColumnVector* column_vector_reserve(ColumnVector* cv, size_t min_capacity)
+{
+    if (min_capacity > cv->capacity)
+        column_vector_resize(cv, min_capacity);
+    return cv;
+}
+
+/*
+ *                                  Internal.
+ */
+
+static void column_vector_resize(ColumnVector* cv, size_t capacity)
+{
+    for (size_t col = 0; col < cv->num_columns; ++col) {
+        size_t field_size = cv->fields[col].size;
+        cv->columns[col] = allocator_realloc(cv->allocator, cv->columns[col],
+                                             cv->capacity * field_size,
+                                             capacity * field_size);
+        assert(cv->columns[col]);
+    }
+    cv->capacity = capacity;
+}
+
+static inline char* column_vector_cell(const ColumnVector* cv, size_t pos,
+                                       size_t col)
+{
+    return (char*) cv->columns[col] + pos * cv->fields[col].size;
+}
@@ -0,0 +1,132 @@
+#ifndef COLUMN_VECTOR_H
+#define COLUMN_VECTOR_H
+
+#include "vector.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COLUMN_VECTOR_MAX_COLUMNS  16
+
+/*
+ * A field of the row type: where it sits in a row and how many bytes it
+ * takes. COLUMN_FIELD(Record, price) describes Record.price.
+ */
+
+typedef struct {
+    size_t offset;
+    size_t size;
+} ColumnField;
+
+#define COLUMN_FIELD(Type, member) \
+    ((ColumnField) { offsetof(Type, member), sizeof(((Type*) 0)->member) })
+
+/*
+ * Struct-of-arrays vector. Each field of the row type is kept in its own
+ * contiguous buffer, so a scan over one field reads only that field's
+ * bytes. Rows are pushed and read back as whole row structs, scattered
+ * into and gathered from the columns; column_vector_column() gives direct
+ * access to one column as a plain array.
+ */
+
+typedef struct {
+    size_t row_size;
+    size_t num_columns;
+    ColumnField fields[COLUMN_VECTOR_MAX_COLUMNS];
+    void* columns[COLUMN_VECTOR_MAX_COLUMNS];
+    size_t size;
+    size_t capacity;
+    const Allocator* allocator;
+} ColumnVector;
+
+/*
+ * Construction.
+ */
+
+ColumnVector* column_vector_create(ColumnVector* cv, size_t row_size,
+                                   const ColumnField* fields,
+                                   size_t num_columns);
+
+ColumnVector* column_vector_create_with_allocator(ColumnVector* cv,
+                                                  size_t row_size,
+                                                  const ColumnField* fields,
+                                                  size_t num_columns,
+                                                  const Allocator*);
+
+/*
+ * Destruction.
+ */
+
+void column_vector_free(ColumnVector* cv);
+
+/*
+ * Size/Capacity.
+ */
+
+static inline size_t column_vector_size(const ColumnVector* cv)
+{
+    return cv->size;
+}
+
+static inline size_t column_vector_capacity(const ColumnVector* cv)
+{
+    return cv->capacity;
+}
+
+static inline bool column_vector_is_empty(const ColumnVector* cv)
+{
+    return cv->size == 0;
+}
+
+/*
+ * Columns.
+ */
+
+static inline void* column_vector_column(const ColumnVector* cv, size_t col)
+{
+    return cv->columns[col];
+}
+
+/*
+ * Indexing.
+ */
+
+void* column_vector_get(const ColumnVector* cv, size_t pos, size_t col);
+
+void column_vector_set(ColumnVector* cv, size_t pos, size_t col,
+                       const void* data_ptr);
+
+void* column_vector_get_row(const ColumnVector* cv, size_t pos,
+                            void* row_out);
+
+void column_vector_set_row(ColumnVector* cv, size_t pos, const void* row);
+
+/*
+ * Insertion.
+ */
+
+void column_vector_push_back(ColumnVector* cv, const void* row);
+
+/*
+ * Removal.
+ */
+
+void column_vector_pop_back(ColumnVector* cv);
+
+ColumnVector* column_vector_clear(ColumnVector* cv);
+
+/*
+ * Resize.
+ */
+
+ColumnVector* column_vector_reserve(ColumnVector* cv, size_t min_capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COLUMN_VECTOR_H */
@@ -0,0 +1,179 @@
+#include "deque.h"
+
+#include <assert.h>
+#include <string.h>
+
+static inline void* deque_slot(const Deque* d, size_t pos);
+
+static void deque_grow_to(Deque* d, size_t capacity);
+
+/*
+ *                                Construction.
+ */
+
+Deque* deque_create(Deque* d, size_t data_size, FreeFunc free_func)
+{
+    return deque_create_with_allocator(d, data_size, free_func,
+                                       &heap_allocator);
+}
+
+Deque* deque_create_with_allocator(Deque* d, size_t data_size,
+                                   FreeFunc free_func,
+                                   const Allocator* allocator)
+{
+    d->data_size = data_size;
+    d->size = 0;
+    d->capacity = DEQUE_INIT_CAPACITY;
+    d->head = 0;
+    d->free_func = free_func;
+    d->allocator = allocator;
+    d->buffer_ptr = allocator_alloc(allocator, d->capacity * data_size);
+    assert(d->buffer_ptr);
+
+    return d;
+}
+
+/*
+ *                                Destruction.
+ */
+
+void deque_free(Deque* d)
+{
+    if (d->free_func) {
+        for (size_t i = 0; i < d->size; ++i)
+            d->free_func(deque_slot(d, i));
+    }
+    allocator_free(d->allocator, d->buffer_ptr, d->capacity * d->data_size);
+}
+
+/*
+ *                                  Indexing.
+ */
+
+void* deque_get(const Deque* d, size_t pos)
+{
+    assert(pos < d->size);
+    return deque_slot(d, pos);
+}
+
+void deque_set(Deque* d, size_t pos, const void* data_ptr)
+{
+    assert(pos < d->size);
+    memcpy(deque_slot(d, pos), data_ptr, d->data_size);
+}
+
+void* deque_front(const Deque* d)
+{
+    return deque_get(d, 0);
+}
+
+void* deque_back(const Deque* d)
+{
+    return deque_get(d, d->size - 1);
+}
+
+/*
+ *                                  Insertion.
+ */
+
+void deque_push_back(Deque* d, const void* data_ptr)
+{
+    if (deque_is_full(d))
+        deque_grow_to(d, d->capacity * 2);
+
+    memcpy(deque_slot(d, d->size), data_ptr, d->data_size);
+    ++d->size;
+}
+
+void deque_push_front(Deque* d, const void* data_ptr)
+{
+    if (deque_is_full(d))
+        deque_grow_to(d, d->capacity * 2);
+
+    d->head = (d->head - 1) & (d->capacity - 1);
+    ++d->size;
+    memcpy(deque_slot(d, 0), data_ptr, d->data_size);
+}
+
+/*
+ *                                   Removal.
+ */
+
+/*
+ * Like vector_pop_back, the pop functions return a pointer to the removed
+ * element, which stays valid until the next insertion.
+ */
+void* deque_pop_back(Deque* d)
+{
+    assert(!deque_is_empty(d));
+    return deque_slot(d, --d->size);
+}
+
+void* deque_pop_front(Deque* d)
+{
+    assert(!deque_is_empty(d));
+
+    void* front = deque_slot(d, 0);
+    d->head = (d->head + 1) & (d->capacity - 1);
+    --d->size;
+
+    return front;
+}
+
+Deque* deque_clear(Deque* d)
+{
+    d->size = 0;
+    d->head = 0;
+    return d;
+}
+
+/*
+ *                                   Resize.
+ */
+
+Deque* deque_reserve(Deque* d, size_t min_capacity)
+{
+    size_t capacity = d->capacity;
+
+    while (capacity < min_capacity)
+        capacity *= 2;
+    if (capacity != d->capacity)
+        deque_grow_to(d, capacity);
+    return d;
+}
+
+/*
+ *                                  Internal.
+ */
+
+static inline void* deque_slot(const Deque* d, size_t pos)
+{
+    size_t index = (d->head + pos) & (d->capacity - 1);
+    return (char*) d->buffer_ptr + index * d->data_size;
+}
+
+/*
+ * Moves the elements to a new buffer of the given power-of-two capacity,
+ * unwrapped so that head becomes 0: one memcpy for the run from head to
+ * the end of the old buffer and one for the part that wrapped around.
+ */
+static void deque_grow_to(Deque* d, size_t capacity)
+{
+    size_t data_size = d->data_size;
+    char* buffer = allocator_alloc(d->allocator, capacity * data_size);
+    assert(buffer);
+
+    size_t first = d->capacity - d->head;
+    first = (d->size < first) ? d->size : first;
+
+    memcpy(buffer, (char*) d->buffer_ptr + d->head * data_size,
+           first * data_size);
+    memcpy(buffer + first * data_size, d->buffer_ptr,
+           (d->size - first) * data_size);
+
+    allocator_free(d->allocator, d->buffer_ptr, d->capacity * data_size);
+
+    d->buffer_ptr = buffer;
+    d->capacity = capacity;
+    d->head = 0;
+}
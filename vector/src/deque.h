@@ -0,0 +1,115 @@
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#include "vector.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DEQUE_INIT_CAPACITY  4
+
+/*
+ * Double-ended queue on a circular buffer. capacity is always a power of
+ * two, so the element at logical position pos lives in slot
+ * (head + pos) & (capacity - 1). Pushing or popping at either end is O(1);
+ * growing unwraps the contents into a buffer twice as large.
+ */
+
+typedef struct {
+    size_t data_size;
+    size_t size;
+    size_t capacity;
+    size_t head;
+    void*  buffer_ptr;
+    FreeFunc free_func;
+    const Allocator* allocator;
+} Deque;
+
+/*
+ * Construction.
+ */
+
+Deque* deque_create(Deque* d, size_t data_size, FreeFunc);
+
+Deque* deque_create_with_allocator(Deque* d, size_t data_size, FreeFunc,
+                                   const Allocator*);
+
+/*
+ * Destruction.
+ */
+
+void deque_free(Deque* d);
+
+/*
+ * Size/Capacity.
+ */
+
+static inline size_t deque_size(const Deque* d)
+{
+    return d->size;
+}
+
+static inline size_t deque_capacity(const Deque* d)
+{
+    return d->capacity;
+}
+
+/*
+ * Emptiness/Fullness.
+ */
+
+static inline bool deque_is_empty(const Deque* d)
+{
+    return d->size == 0;
+}
+
+static inline bool deque_is_full(const Deque* d)
+{
+    return d->size == d->capacity;
+}
+
+/*
+ * Indexing.
+ */
+
+void* deque_get(const Deque* d, size_t pos);
+
+void deque_set(Deque* d, size_t pos, const void* data_ptr);
+
+void* deque_front(const Deque* d);
+
+void* deque_back(const Deque* d);
+
+/*
+ * Insertion.
+ */
+
+void deque_push_back(Deque* d, const void* data_ptr);
+
+void deque_push_front(Deque* d, const void* data_ptr);
+
+/*
+ * Removal.
+ */
+
+void* deque_pop_back(Deque* d);
+
+void* deque_pop_front(Deque* d);
+
+Deque* deque_clear(Deque* d);
+
+/*
+ * Resize.
+ */
+
+Deque* deque_reserve(Deque* d, size_t min_capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEQUE_H */
@@ -0,0 +1,234 @@
+#include "flat_map.h"
+
+#include <assert.h>
+#include <stdalign.h>
+#include <string.h>
+
+static size_t flat_map_sorted_batch(const FlatMap* map, Vector* records,
+                                    const void* keys, const void* values,
+                                    size_t count);
+
+static size_t record_size(size_t key_size, size_t value_size);
+
+/*
+ *                                Construction.
+ */
+
+FlatMap* flat_map_create(FlatMap* map, size_t key_size, size_t value_size,
+                         CmpFunc cmp_func)
+{
+    return flat_map_create_with_allocator(map, key_size, value_size,
+                                          cmp_func, &heap_allocator);
+}
+
+FlatMap* flat_map_create_with_allocator(FlatMap* map, size_t key_size,
+                                        size_t value_size, CmpFunc cmp_func,
+                                        const Allocator* allocator)
+{
+    assert(cmp_func);
+    vector_create_with_allocator(&map->keys, key_size, NULL, allocator);
+    vector_create_with_allocator(&map->values, value_size, NULL, allocator);
+    map->cmp_func = cmp_func;
+
+    return map;
+}
+
+/*
+ *                                Destruction.
+ */
+
+void flat_map_free(FlatMap* map)
+{
+    vector_free(&map->keys);
+    vector_free(&map->values);
+}
+
+/*
+ *                                   Lookup.
+ */
+
+/*
+ * Position of key, or VECTOR_NOT_FOUND.
+ */
+size_t flat_map_find(const FlatMap* map, const void* key)
+{
+    return vector_binary_search(&map->keys, key, map->cmp_func);
+}
+
+void* flat_map_get(const FlatMap* map, const void* key)
+{
+    size_t pos = flat_map_find(map, key);
+    return (pos == VECTOR_NOT_FOUND) ? NULL : vector_get(&map->values, pos);
+}
+
+bool flat_map_contains(const FlatMap* map, const void* key)
+{
+    return flat_map_find(map, key) != VECTOR_NOT_FOUND;
+}
+
+/*
+ *                                 Insertion.
+ */
+
+/*
+ * Inserts key with value, or overwrites the value of an existing key.
+ * Returns whether key was new.
+ */
+bool flat_map_put(FlatMap* map, const void* key, const void* value)
+{
+    size_t pos = vector_lower_bound(&map->keys, key, map->cmp_func);
+
+    if (pos < flat_map_size(map) &&
+        map->cmp_func(vector_get(&map->keys, pos), key) == 0) {
+        vector_set(&map->values, pos, value);
+        return false;
+    }
+
+    vector_insert(&map->keys, pos, key);
+    vector_insert(&map->values, pos, value);
+    return true;
+}
+
+/*
+ * Replaces the contents with count pairs from the parallel arrays keys
+ * and values, in any order: O(n log n) for the sort, rather than the
+ * O(n^2) of putting them one by one. Where keys repeat, which of their
+ * values is kept is unspecified.
+ */
+FlatMap* flat_map_load(FlatMap* map, const void* keys, const void* values,
+                       size_t count)
+{
+    flat_map_clear(map);
+    return flat_map_insert_n(map, keys, values, count);
+}
+
+/*
+ * Sorts the batch, then merges it with the map in one pass into new
+ * vectors, so that every existing pair moves once however many keys
+ * arrive. A batch value replaces the value of an existing key.
+ */
+FlatMap* flat_map_insert_n(FlatMap* map, const void* keys,
+                           const void* values, size_t count)
+{
+    if (count == 0)
+        return map;
+
+    Vector records;
+    size_t batch = flat_map_sorted_batch(map, &records, keys, values, count);
+
+    const Allocator* allocator = map->keys.allocator;
+    size_t key_size = map->keys.data_size;
+    size_t size = flat_map_size(map);
+
+    Vector new_keys, new_values;
+    vector_create_with_allocator(&new_keys, key_size, NULL, allocator);
+    vector_create_with_allocator(&new_values, map->values.data_size, NULL,
+                                 allocator);
+    vector_reserve(&new_keys, size + batch);
+    vector_reserve(&new_values, size + batch);
+
+    size_t i = 0, j = 0;
+    while (i < size || j < batch) {
+        const char* record = (j < batch) ? vector_get(&records, j) : NULL;
+        int cmp = (i == size) ? 1 :
+                  (j == batch) ? -1 :
+                  map->cmp_func(vector_get(&map->keys, i), record);
+
+        if (cmp < 0) {
+            vector_push_back(&new_keys, vector_get(&map->keys, i));
+            vector_push_back(&new_values, vector_get(&map->values, i));
+            ++i;
+        } else {
+            vector_push_back(&new_keys, record);
+            vector_push_back(&new_values, record + key_size);
+            i += (cmp == 0);
+            ++j;
+        }
+    }
+
+    flat_map_free(map);
+    map->keys = new_keys;
+    map->values = new_values;
+    vector_free(&records);
+
+    return map;
+}
+
+/*
+ *                                  Removal.
+ */
+
+bool flat_map_erase(FlatMap* map, const void* key)
+{
+    size_t pos = flat_map_find(map, key);
+    if (pos == VECTOR_NOT_FOUND)
+        return false;
+
+    vector_erase(&map->keys, pos);
+    vector_erase(&map->values, pos);
+    return true;
+}
+
+FlatMap* flat_map_clear(FlatMap* map)
+{
+    vector_clear(&map->keys);
+    vector_clear(&map->values);
+    return map;
+}
+
+/*
+ *                                  Internal.
+ */
+
+/*
+ * Packs each key with its value into one record, key first, so that
+ * vector_sort() can order the pairs with cmp_func itself, then moves the
+ * first record of every run of equal keys to the front. Returns how many
+ * records that leaves.
+ */
+static size_t flat_map_sorted_batch(const FlatMap* map, Vector* records,
+                                    const void* keys, const void* values,
+                                    size_t count)
+{
+    size_t key_size = map->keys.data_size;
+    size_t value_size = map->values.data_size;
+
+    vector_create_with_allocator(records, record_size(key_size, value_size),
+                                 NULL, map->keys.allocator);
+    vector_reserve(records, count);
+
+    char record[records->data_size];
+    memset(record, 0, records->data_size);
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(record, (const char*) keys + i * key_size, key_size);
+        memcpy(record + key_size, (const char*) values + i * value_size,
+               value_size);
+        vector_push_back(records, record);
+    }
+
+    vector_sort(records, map->cmp_func);
+
+    size_t unique = 1;
+    for (size_t i = 1; i < count; ++i) {
+        void* next = vector_get(records, i);
+        if (map->cmp_func(vector_get(records, unique - 1), next) != 0) {
+            if (unique != i)
+                vector_set(records, unique, next);
+            ++unique;
+        }
+    }
+    return unique;
+}
+
+/*
+ * Records are padded to the alignment of their keys, so that cmp_func
+ * sees every key aligned.
+ */
+static size_t record_size(size_t key_size, size_t value_size)
+{
+    size_t alignment = key_size & -key_size;
+    if (alignment > alignof(max_align_t))
+        alignment = alignof(max_align_t);
+
+    return (key_size + value_size + alignment - 1) & ~(alignment - 1);
+}
@@ -0,0 +1,108 @@
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include "vector.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Sorted map of fixed-size keys and values, kept in two parallel Vectors
+ * ordered by cmp_func on the keys. A lookup is a branchless binary search
+ * over the keys alone, which are packed densely, and touches the values
+ * only for the one it returns. Insertion and erasure in the middle are
+ * O(n); for more than a few keys, build with flat_map_load() or merge
+ * with flat_map_insert_n(). Positions run in key order, so iterating
+ * over 0 ... flat_map_size() - 1 visits the keys sorted.
+ */
+
+typedef struct {
+    Vector keys;
+    Vector values;
+    CmpFunc cmp_func;
+} FlatMap;
+
+/*
+ * Construction.
+ */
+
+FlatMap* flat_map_create(FlatMap* map, size_t key_size, size_t value_size,
+                         CmpFunc);
+
+FlatMap* flat_map_create_with_allocator(FlatMap* map, size_t key_size,
+                                        size_t value_size, CmpFunc,
+                                        const Allocator*);
+
+/*
+ * Destruction.
+ */
+
+void flat_map_free(FlatMap* map);
+
+/*
+ * Size.
+ */
+
+static inline size_t flat_map_size(const FlatMap* map)
+{
+    return vector_size(&map->keys);
+}
+
+static inline bool flat_map_is_empty(const FlatMap* map)
+{
+    return vector_is_empty(&map->keys);
+}
+
+/*
+ * Lookup.
+ */
+
+size_t flat_map_find(const FlatMap* map, const void* key);
+
+void* flat_map_get(const FlatMap* map, const void* key);
+
+bool flat_map_contains(const FlatMap* map, const void* key);
+
+/*
+ * Indexing.
+ */
+
+static inline void* flat_map_key_at(const FlatMap* map, size_t pos)
+{
+    return vector_get(&map->keys, pos);
+}
+
+static inline void* flat_map_value_at(const FlatMap* map, size_t pos)
+{
+    return vector_get(&map->values, pos);
+}
+
+/*
+ * Insertion.
+ */
+
+bool flat_map_put(FlatMap* map, const void* key, const void* value);
+
+FlatMap* flat_map_load(FlatMap* map, const void* keys, const void* values,
+                       size_t count);
+
+FlatMap* flat_map_insert_n(FlatMap* map, const void* keys,
+                           const void* values, size_t count);
+
+/*
+ * Removal.
+ */
+
+bool flat_map_erase(FlatMap* map, const void* key);
+
+FlatMap* flat_map_clear(FlatMap* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FLAT_MAP_H */
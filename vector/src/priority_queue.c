@@ -0,0 +1,226 @@
+#include "priority_queue.h"
+
+#include <assert.h>
+#include <string.h>
+
+static inline void* pq_slot(const PriorityQueue* pq, size_t pos);
+
+static void pq_pad_front(PriorityQueue* pq);
+
+static void pq_sift_up(PriorityQueue* pq, size_t pos, const void* data_ptr);
+
+static void pq_sift_down(PriorityQueue* pq, size_t pos, const void* data_ptr);
+
+static void pq_heapify(PriorityQueue* pq);
+
+/*
+ *                                Construction.
+ */
+
+PriorityQueue* pq_create(PriorityQueue* pq, size_t data_size,
+                         FreeFunc free_func, CmpFunc cmp_func, size_t arity)
+{
+    return pq_create_with_allocator(pq, data_size, free_func, cmp_func,
+                                    arity, &cache_aligned_allocator);
+}
+
+PriorityQueue* pq_create_with_allocator(PriorityQueue* pq, size_t data_size,
+                                        FreeFunc free_func, CmpFunc cmp_func,
+                                        size_t arity,
+                                        const Allocator* allocator)
+{
+    assert(cmp_func);
+    vector_create_with_allocator(&pq->v, data_size, free_func, allocator);
+    pq->cmp_func = cmp_func;
+    pq->arity = arity ? arity : PQ_DEFAULT_ARITY;
+    assert(pq->arity >= 2);
+
+    pq_pad_front(pq);
+    return pq;
+}
+
+/*
+ * Takes over the elements of v and heapifies them, in O(n) rather than
+ * the O(n log n) of pushing them one by one. They are copied once, behind
+ * the unused front slots, into a buffer from v's allocator, or from
+ * cache_aligned_allocator if that is heap_allocator. v is freed and must
+ * not be used afterwards; its free_func passes to pq.
+ */
+PriorityQueue* pq_from_vector(PriorityQueue* pq, Vector* v,
+                              CmpFunc cmp_func, size_t arity)
+{
+    const Allocator* allocator = (v->allocator == &heap_allocator) ?
+                                 &cache_aligned_allocator : v->allocator;
+
+    pq_create_with_allocator(pq, v->data_size, v->free_func, cmp_func,
+                             arity, allocator);
+    vector_append_array(&pq->v, v->buffer_ptr, v->size);
+
+    v->free_func = NULL;
+    vector_free(v);
+
+    pq_heapify(pq);
+    return pq;
+}
+
+/*
+ *                                Destruction.
+ */
+
+/*
+ * free_func must not see the unused front slots.
+ */
+void pq_free(PriorityQueue* pq)
+{
+    if (pq->v.free_func) {
+        for (size_t i = 0; i < pq_size(pq); ++i)
+            pq->v.free_func(pq_slot(pq, i));
+        pq->v.free_func = NULL;
+    }
+    vector_free(&pq->v);
+}
+
+/*
+ *                                 Insertion.
+ */
+
+void pq_push(PriorityQueue* pq, const void* data_ptr)
+{
+    vector_push_back(&pq->v, data_ptr);
+    pq_sift_up(pq, pq_size(pq) - 1, pq_slot(pq, pq_size(pq) - 1));
+}
+
+/*
+ * Appends the whole batch with one copy, then restores the heap either by
+ * sifting each new element up, O(count log n), or, once the batch is at
+ * least as large as the heap it joins, by heapifying everything, O(n).
+ */
+void pq_push_n(PriorityQueue* pq, const void* array, size_t count)
+{
+    size_t old_size = pq_size(pq);
+    vector_append_array(&pq->v, array, count);
+
+    if (count >= old_size) {
+        pq_heapify(pq);
+        return;
+    }
+
+    for (size_t i = old_size; i < pq_size(pq); ++i)
+        pq_sift_up(pq, i, pq_slot(pq, i));
+}
+
+/*
+ *                                  Removal.
+ */
+
+/*
+ * The removed element is moved just past the end of the heap, like
+ * vector_pop_back(), and the returned pointer stays valid until the next
+ * push.
+ */
+void* pq_pop(PriorityQueue* pq)
+{
+    assert(!pq_is_empty(pq));
+
+    size_t last = pq_size(pq) - 1;
+    --pq->v.size;
+    if (last == 0)
+        return pq_slot(pq, 0);
+
+    char temp[pq->v.data_size];
+    memcpy(temp, pq_slot(pq, last), pq->v.data_size);
+    memcpy(pq_slot(pq, last), pq_slot(pq, 0), pq->v.data_size);
+    pq_sift_down(pq, 0, temp);
+
+    return pq_slot(pq, last);
+}
+
+PriorityQueue* pq_clear(PriorityQueue* pq)
+{
+    pq->v.size = pq->arity - 1;
+    return pq;
+}
+
+/*
+ *                                  Internal.
+ */
+
+/*
+ * Address of the element at heap position pos, past the unused slots.
+ */
+static inline void* pq_slot(const PriorityQueue* pq, size_t pos)
+{
+    return (char*) pq->v.buffer_ptr +
+           (pos + pq->arity - 1) * pq->v.data_size;
+}
+
+/*
+ * Fills the arity - 1 unused slots that the heap starts after.
+ */
+static void pq_pad_front(PriorityQueue* pq)
+{
+    vector_reserve(&pq->v, pq->arity - 1);
+    memset(pq->v.buffer_ptr, 0, (pq->arity - 1) * pq->v.data_size);
+    pq->v.size = pq->arity - 1;
+}
+
+/*
+ * Both sifts move a hole rather than swapping: each level costs one copy
+ * instead of three, and *data_ptr is written once, where it belongs.
+ */
+static void pq_sift_up(PriorityQueue* pq, size_t pos, const void* data_ptr)
+{
+    size_t data_size = pq->v.data_size;
+    char temp[data_size];
+    memcpy(temp, data_ptr, data_size);
+
+    while (pos > 0) {
+        size_t parent = (pos - 1) / pq->arity;
+        if (pq->cmp_func(temp, pq_slot(pq, parent)) >= 0)
+            break;
+        memcpy(pq_slot(pq, pos), pq_slot(pq, parent), data_size);
+        pos = parent;
+    }
+    memcpy(pq_slot(pq, pos), temp, data_size);
+}
+
+static void pq_sift_down(PriorityQueue* pq, size_t pos, const void* data_ptr)
+{
+    size_t data_size = pq->v.data_size;
+    size_t size = pq_size(pq);
+    char temp[data_size];
+    memcpy(temp, data_ptr, data_size);
+
+    for (;;) {
+        size_t first = pos * pq->arity + 1;
+        if (first >= size)
+            break;
+
+        size_t end = (size - first > pq->arity) ? first + pq->arity : size;
+        size_t best = first;
+        for (size_t child = first + 1; child < end; ++child) {
+            if (pq->cmp_func(pq_slot(pq, child), pq_slot(pq, best)) < 0)
+                best = child;
+        }
+
+        if (pq->cmp_func(pq_slot(pq, best), temp) >= 0)
+            break;
+        memcpy(pq_slot(pq, pos), pq_slot(pq, best), data_size);
+        pos = best;
+    }
+    memcpy(pq_slot(pq, pos), temp, data_size);
+}
+
+/*
+ * Floyd's bottom-up construction: sifting down every parent from the last
+ * one is O(n), since most elements sit near the leaves.
+ */
+static void pq_heapify(PriorityQueue* pq)
+{
+    size_t size = pq_size(pq);
+    if (size < 2)
+        return;
+
+    for (size_t i = (size - 2) / pq->arity + 1; i-- > 0;)
+        pq_sift_down(pq, i, pq_slot(pq, i));
+}
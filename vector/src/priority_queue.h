@@ -0,0 +1,102 @@
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include "vector.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * With the shifted layout below, a 4-ary heap of 16-byte elements keeps
+ * the children of every node on one 64-byte cache line, and is half as
+ * deep as a binary heap.
+ */
+#define PQ_DEFAULT_ARITY  4
+
+/*
+ * Implicit d-ary min-heap in a Vector. pq_peek() returns the element that
+ * compares smallest under cmp_func, so pass a reversed comparison for a
+ * max-heap. push and pop are O(log n), heapify is O(n).
+ *
+ * The heap starts arity - 1 unused slots into the buffer, so the children
+ * of the k-th element sit in slots arity * (k + 1) ... arity * (k + 1) +
+ * arity - 1: every group of siblings starts at a multiple of arity. The
+ * buffer comes from cache_aligned_allocator unless the caller supplies
+ * another allocator, so when arity * data_size is a multiple of the cache
+ * line, each group of siblings lies within a single line.
+ */
+
+typedef struct {
+    Vector v;
+    CmpFunc cmp_func;
+    size_t arity;
+} PriorityQueue;
+
+/*
+ * Construction. An arity of 0 selects PQ_DEFAULT_ARITY.
+ */
+
+PriorityQueue* pq_create(PriorityQueue* pq, size_t data_size, FreeFunc,
+                         CmpFunc, size_t arity);
+
+PriorityQueue* pq_create_with_allocator(PriorityQueue* pq, size_t data_size,
+                                        FreeFunc, CmpFunc, size_t arity,
+                                        const Allocator*);
+
+PriorityQueue* pq_from_vector(PriorityQueue* pq, Vector* v, CmpFunc,
+                              size_t arity);
+
+/*
+ * Destruction.
+ */
+
+void pq_free(PriorityQueue* pq);
+
+/*
+ * Size.
+ */
+
+static inline size_t pq_size(const PriorityQueue* pq)
+{
+    return vector_size(&pq->v) - (pq->arity - 1);
+}
+
+static inline bool pq_is_empty(const PriorityQueue* pq)
+{
+    return pq_size(pq) == 0;
+}
+
+/*
+ * Access.
+ */
+
+static inline void* pq_peek(const PriorityQueue* pq)
+{
+    return vector_get(&pq->v, pq->arity - 1);
+}
+
+/*
+ * Insertion.
+ */
+
+void pq_push(PriorityQueue* pq, const void* data_ptr);
+
+void pq_push_n(PriorityQueue* pq, const void* array, size_t count);
+
+/*
+ * Removal.
+ */
+
+void* pq_pop(PriorityQueue* pq);
+
+PriorityQueue* pq_clear(PriorityQueue* pq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PRIORITY_QUEUE_H */
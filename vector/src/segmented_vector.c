@@ -0,0 +1,202 @@
+#include "segmented_vector.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#define FIRST_SEGMENT_SIZE  ((size_t) 1 << SEGMENTED_VECTOR_FIRST_SHIFT)
+
+static inline size_t segment_index(size_t pos);
+static inline size_t segment_size(size_t segment);
+static inline size_t segment_offset(size_t pos, size_t segment);
+static inline size_t segment_bytes(const SegmentedVector* sv,
+                                   size_t segment);
+static inline atomic_uchar* segment_ready(const SegmentedVector* sv,
+                                          char* data, size_t segment);
+
+static char* segmented_vector_segment(SegmentedVector* sv, size_t segment);
+static bool segmented_vector_is_ready(const SegmentedVector* sv, size_t pos);
+static void segmented_vector_publish(SegmentedVector* sv);
+
+/*
+ *                                Construction.
+ */
+
+SegmentedVector* segmented_vector_create(SegmentedVector* sv,
+                                         size_t data_size,
+                                         FreeFunc free_func)
+{
+    sv->data_size = data_size;
+    sv->free_func = free_func;
+
+    for (size_t k = 0; k < SEGMENTED_VECTOR_MAX_SEGMENTS; ++k)
+        atomic_init(&sv->segments[k], NULL);
+
+    atomic_init(&sv->reserved, 0);
+    atomic_init(&sv->size, 0);
+
+    return sv;
+}
+
+/*
+ *                                Destruction.
+ */
+
+/*
+ * Not thread-safe: every writer and reader must be done with sv.
+ */
+void segmented_vector_free(SegmentedVector* sv)
+{
+    size_t size = segmented_vector_size(sv);
+
+    if (sv->free_func) {
+        for (size_t i = 0; i < size; ++i)
+            (*sv->free_func)(segmented_vector_get(sv, i));
+    }
+
+    for (size_t k = 0; k < SEGMENTED_VECTOR_MAX_SEGMENTS; ++k) {
+        void* segment = atomic_load_explicit(&sv->segments[k],
+                                             memory_order_relaxed);
+        if (segment)
+            allocator_free(&heap_allocator, segment, segment_bytes(sv, k));
+    }
+}
+
+/*
+ *                                  Indexing.
+ */
+
+void* segmented_vector_get(const SegmentedVector* sv, size_t pos)
+{
+    assert(pos < segmented_vector_size(sv));
+
+    size_t k = segment_index(pos);
+    char* segment = atomic_load_explicit(&sv->segments[k],
+                                         memory_order_acquire);
+
+    return segment + segment_offset(pos, k) * sv->data_size;
+}
+
+/*
+ *                                  Insertion.
+ */
+
+/*
+ * Appends a copy of *data_ptr and returns its index. Safe to call from any
+ * number of threads at once, and never waits for other writers: the index
+ * drops below size once every element before it is written too.
+ */
+size_t segmented_vector_push_back(SegmentedVector* sv, const void* data_ptr)
+{
+    size_t pos = atomic_fetch_add_explicit(&sv->reserved, 1,
+                                           memory_order_relaxed);
+    size_t k = segment_index(pos);
+    char* segment = segmented_vector_segment(sv, k);
+    size_t offset = segment_offset(pos, k);
+
+    memcpy(segment + offset * sv->data_size, data_ptr, sv->data_size);
+    atomic_store(&segment_ready(sv, segment, k)[offset], 1);
+
+    segmented_vector_publish(sv);
+
+    return pos;
+}
+
+/*
+ *                                  Internal.
+ */
+
+static inline size_t segment_index(size_t pos)
+{
+    size_t biased = pos + FIRST_SEGMENT_SIZE;
+    size_t log2 = sizeof(unsigned long long) * 8 - 1 -
+                  __builtin_clzll(biased);
+
+    return log2 - SEGMENTED_VECTOR_FIRST_SHIFT;
+}
+
+static inline size_t segment_size(size_t segment)
+{
+    return FIRST_SEGMENT_SIZE << segment;
+}
+
+static inline size_t segment_offset(size_t pos, size_t segment)
+{
+    return pos + FIRST_SEGMENT_SIZE - segment_size(segment);
+}
+
+/*
+ * A segment holds its elements, then one ready flag per element.
+ */
+static inline size_t segment_bytes(const SegmentedVector* sv,
+                                   size_t segment)
+{
+    return segment_size(segment) * (sv->data_size + sizeof(atomic_uchar));
+}
+
+static inline atomic_uchar* segment_ready(const SegmentedVector* sv,
+                                          char* data, size_t segment)
+{
+    return (atomic_uchar*) (data + segment_size(segment) * sv->data_size);
+}
+
+/*
+ * Returns segment k, allocating it if needed. Threads that race to install
+ * the same segment all allocate one; the CAS loser frees its copy.
+ */
+static char* segmented_vector_segment(SegmentedVector* sv, size_t k)
+{
+    void* segment = atomic_load_explicit(&sv->segments[k],
+                                         memory_order_acquire);
+    if (segment)
+        return segment;
+
+    size_t bytes = segment_bytes(sv, k);
+    char* fresh = allocator_alloc(&heap_allocator, bytes);
+    assert(fresh);
+
+    atomic_uchar* ready = segment_ready(sv, fresh, k);
+    for (size_t i = 0; i < segment_size(k); ++i)
+        atomic_init(&ready[i], 0);
+
+    if (atomic_compare_exchange_strong_explicit(&sv->segments[k], &segment,
+                                                fresh, memory_order_acq_rel,
+                                                memory_order_acquire))
+        return fresh;
+
+    allocator_free(&heap_allocator, fresh, bytes);
+    return segment;
+}
+
+/*
+ * Whether the element at pos is written. Its segment may not be installed
+ * yet if the writer that reserved pos has not got that far.
+ */
+static bool segmented_vector_is_ready(const SegmentedVector* sv, size_t pos)
+{
+    size_t k = segment_index(pos);
+    char* segment = atomic_load_explicit(&sv->segments[k],
+                                         memory_order_acquire);
+
+    return segment &&
+           atomic_load(&segment_ready(sv, segment, k)[segment_offset(pos, k)]);
+}
+
+/*
+ * Advances size over every ready slot past it. A writer that stops short
+ * at a slot still being written leaves the rest to that slot's writer:
+ * the flag stores, the flag loads here and the CAS are all sequentially
+ * consistent, so of two writers racing past each other at least one sees
+ * the other's flag, and no ready slot is left behind the published prefix
+ * for good.
+ */
+static void segmented_vector_publish(SegmentedVector* sv)
+{
+    size_t size = atomic_load(&sv->size);
+
+    while (segmented_vector_is_ready(sv, size)) {
+        /* On failure size is reloaded, and we carry on from there. */
+        if (atomic_compare_exchange_weak(&sv->size, &size, size + 1))
+            ++size;
+    }
+}
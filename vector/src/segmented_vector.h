@@ -0,0 +1,91 @@
+#ifndef SEGMENTED_VECTOR_H
+#define SEGMENTED_VECTOR_H
+
+#include "vector.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * log2 of the number of elements in the first segment. Segment k holds
+ * 2^(SEGMENTED_VECTOR_FIRST_SHIFT + k) elements, so the segments double
+ * in size and cover every index a size_t can address.
+ */
+#ifndef SEGMENTED_VECTOR_FIRST_SHIFT
+#define SEGMENTED_VECTOR_FIRST_SHIFT  5
+#endif
+
+#define SEGMENTED_VECTOR_MAX_SEGMENTS \
+    (sizeof(size_t) * 8 - SEGMENTED_VECTOR_FIRST_SHIFT)
+
+/*
+ * Append-only vector for many concurrent writers and readers. Elements
+ * live in power-of-two segments that are never moved or freed before
+ * segmented_vector_free(), so a pointer from segmented_vector_get() stays
+ * valid while other threads keep appending.
+ *
+ * push_back reserves a slot with one atomic fetch-add, installs a missing
+ * segment with a CAS, and marks the slot ready with a release store once
+ * its element is written; writers never wait on each other. size is the
+ * published prefix, advanced lazily over ready slots by whichever writer
+ * finds them, and readers may index anything below it without locking.
+ */
+
+typedef struct {
+    size_t data_size;
+    FreeFunc free_func;
+    _Atomic(void*) segments[SEGMENTED_VECTOR_MAX_SEGMENTS];
+
+    _Alignas(64) _Atomic size_t reserved;
+    _Alignas(64) _Atomic size_t size;
+} SegmentedVector;
+
+/*
+ * Construction.
+ */
+
+SegmentedVector* segmented_vector_create(SegmentedVector* sv,
+                                         size_t data_size, FreeFunc);
+
+/*
+ * Destruction.
+ */
+
+void segmented_vector_free(SegmentedVector* sv);
+
+/*
+ * Size.
+ */
+
+static inline size_t segmented_vector_size(const SegmentedVector* sv)
+{
+    return atomic_load_explicit(&sv->size, memory_order_acquire);
+}
+
+static inline bool segmented_vector_is_empty(const SegmentedVector* sv)
+{
+    return segmented_vector_size(sv) == 0;
+}
+
+/*
+ * Indexing.
+ */
+
+void* segmented_vector_get(const SegmentedVector* sv, size_t pos);
+
+/*
+ * Insertion.
+ */
+
+size_t segmented_vector_push_back(SegmentedVector* sv, const void* data_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SEGMENTED_VECTOR_H */
@@ -0,0 +1,334 @@
+#include "thread_pool.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+    ThreadPool* pool;
+    size_t worker;
+} WorkerArg;
+
+static void* worker_main(void*);
+
+static void pool_work(ThreadPool*, size_t worker, const PoolJob*);
+
+static void pool_process(ThreadPool*, size_t worker, const PoolJob*,
+                         size_t begin, size_t end);
+
+static bool pool_steal(ThreadPool*, size_t worker, size_t* begin, size_t* end);
+
+static void deque_push(PoolWorker*, size_t begin, size_t end);
+static bool deque_take(PoolWorker*, size_t* begin, size_t* end);
+static bool deque_steal(PoolWorker*, size_t* begin, size_t* end);
+
+static size_t split_point(const PoolJob*, size_t begin, size_t end);
+
+static void default_pool_init(void);
+
+static ThreadPool default_pool;
+static pthread_once_t default_pool_once = PTHREAD_ONCE_INIT;
+
+/*
+ *                                Construction.
+ */
+
+ThreadPool* thread_pool_create(ThreadPool* pool, size_t num_workers)
+{
+    pool->num_workers = num_workers ? num_workers : 1;
+    pool->workers = aligned_alloc(THREAD_POOL_CACHE_LINE,
+                                  pool->num_workers * sizeof(PoolWorker));
+    pool->threads = malloc(pool->num_workers * sizeof(pthread_t));
+    assert(pool->workers && pool->threads);
+
+    for (size_t w = 0; w < pool->num_workers; ++w) {
+        atomic_init(&pool->workers[w].top, 0);
+        atomic_init(&pool->workers[w].bottom, 0);
+        pool->workers[w].rng_state = 0x9E3779B97F4A7C15ull * (w + 1);
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+    pthread_mutex_init(&pool->run_lock, NULL);
+
+    pool->job = NULL;
+    pool->generation = 0;
+    pool->active = 0;
+    pool->stop = false;
+    atomic_init(&pool->remaining, 0);
+
+    /* Worker 0 is whichever thread calls thread_pool_for(). */
+    for (size_t w = 1; w < pool->num_workers; ++w) {
+        WorkerArg* arg = malloc(sizeof(WorkerArg));
+        assert(arg);
+        arg->pool = pool;
+        arg->worker = w;
+        int status = pthread_create(&pool->threads[w], NULL,
+                                    worker_main, arg);
+        assert(status == 0);
+        (void) status;
+    }
+
+    return pool;
+}
+
+/*
+ * Process-wide pool with one worker per online CPU, created on first use
+ * and kept alive until exit.
+ */
+ThreadPool* thread_pool_default(void)
+{
+    pthread_once(&default_pool_once, default_pool_init);
+    return &default_pool;
+}
+
+/*
+ *                                Destruction.
+ */
+
+void thread_pool_free(ThreadPool* pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t w = 1; w < pool->num_workers; ++w)
+        pthread_join(pool->threads[w], NULL);
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->idle);
+    pthread_mutex_destroy(&pool->run_lock);
+
+    free(pool->workers);
+    free(pool->threads);
+}
+
+/*
+ *                                 Execution.
+ */
+
+/*
+ * Runs func over [begin, end) on every worker and returns when all indices
+ * are done. Ranges are split in halves until they are at most grain long;
+ * split points are multiples of align counted from align_base, so chunks
+ * that map to memory can start on cache-line boundaries. Concurrent calls
+ * on the same pool are serialized.
+ */
+void thread_pool_for(ThreadPool* pool, size_t begin, size_t end,
+                     size_t grain, size_t align, size_t align_base,
+                     RangeFunc func, void* ctx)
+{
+    if (begin >= end)
+        return;
+
+    PoolJob job;
+    job.func = func;
+    job.ctx = ctx;
+    job.align = align ? align : 1;
+    job.align_base = align_base;
+    job.grain = grain ? grain : 1;
+
+    pthread_mutex_lock(&pool->run_lock);
+
+    atomic_store(&pool->remaining, end - begin);
+    deque_push(&pool->workers[0], begin, end);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job = &job;
+    ++pool->generation;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    pool_work(pool, 0, &job);
+
+    /* Wait until no worker still holds a pointer to job. */
+    pthread_mutex_lock(&pool->lock);
+    pool->job = NULL;
+    while (pool->active > 0)
+        pthread_cond_wait(&pool->idle, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_unlock(&pool->run_lock);
+}
+
+/*
+ *                                  Internal.
+ */
+
+static void* worker_main(void* arg_ptr)
+{
+    WorkerArg arg = *(WorkerArg*) arg_ptr;
+    ThreadPool* pool = arg.pool;
+    uint64_t seen_generation = 0;
+
+    free(arg_ptr);
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stop &&
+               (pool->job == NULL || pool->generation == seen_generation))
+            pthread_cond_wait(&pool->wake, &pool->lock);
+
+        if (pool->stop) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+
+        const PoolJob* job = pool->job;
+        seen_generation = pool->generation;
+        ++pool->active;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool_work(pool, arg.worker, job);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->active == 0)
+            pthread_cond_signal(&pool->idle);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static void pool_work(ThreadPool* pool, size_t worker, const PoolJob* job)
+{
+    size_t begin, end;
+
+    while (atomic_load_explicit(&pool->remaining, memory_order_acquire)) {
+        if (deque_take(&pool->workers[worker], &begin, &end) ||
+            pool_steal(pool, worker, &begin, &end))
+            pool_process(pool, worker, job, begin, end);
+        else
+            sched_yield();
+    }
+}
+
+/*
+ * Lazy binary splitting: keep the left half, publish the right half for
+ * thieves, and run func once the range is down to the grain size.
+ */
+static void pool_process(ThreadPool* pool, size_t worker, const PoolJob* job,
+                         size_t begin, size_t end)
+{
+    while (end - begin > job->grain) {
+        size_t middle = split_point(job, begin, end);
+        if (middle <= begin || middle >= end)
+            break;
+        deque_push(&pool->workers[worker], middle, end);
+        end = middle;
+    }
+
+    job->func(job->ctx, begin, end, worker);
+    atomic_fetch_sub_explicit(&pool->remaining, end - begin,
+                              memory_order_release);
+}
+
+static bool pool_steal(ThreadPool* pool, size_t worker,
+                       size_t* begin, size_t* end)
+{
+    PoolWorker* self = &pool->workers[worker];
+
+    if (pool->num_workers < 2)
+        return false;
+
+    for (size_t attempt = 0; attempt < pool->num_workers; ++attempt) {
+        self->rng_state ^= self->rng_state << 13;
+        self->rng_state ^= self->rng_state >> 7;
+        self->rng_state ^= self->rng_state << 17;
+
+        size_t victim = self->rng_state % (pool->num_workers - 1);
+        victim += (victim >= worker);
+
+        if (deque_steal(&pool->workers[victim], begin, end))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Chase-Lev deque operations, with the C11 memory orderings of Le et al.,
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP '13).
+ */
+
+static void deque_push(PoolWorker* w, size_t begin, size_t end)
+{
+    int64_t b = atomic_load_explicit(&w->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&w->top, memory_order_acquire);
+    assert(b - t < THREAD_POOL_DEQUE_CAPACITY);
+    (void) t;
+
+    PoolRange* slot = &w->ranges[b % THREAD_POOL_DEQUE_CAPACITY];
+    atomic_store_explicit(&slot->begin, begin, memory_order_relaxed);
+    atomic_store_explicit(&slot->end, end, memory_order_relaxed);
+
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+}
+
+static bool deque_take(PoolWorker* w, size_t* begin, size_t* end)
+{
+    int64_t b = atomic_load_explicit(&w->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&w->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&w->top, memory_order_relaxed);
+
+    if (t > b) {
+        atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+        return false;
+    }
+
+    PoolRange* slot = &w->ranges[b % THREAD_POOL_DEQUE_CAPACITY];
+    *begin = atomic_load_explicit(&slot->begin, memory_order_relaxed);
+    *end = atomic_load_explicit(&slot->end, memory_order_relaxed);
+
+    if (t == b) {
+        /* Last element: race the thieves for it. */
+        bool won = atomic_compare_exchange_strong_explicit(
+            &w->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&w->bottom, b + 1, memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+static bool deque_steal(PoolWorker* w, size_t* begin, size_t* end)
+{
+    int64_t t = atomic_load_explicit(&w->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&w->bottom, memory_order_acquire);
+
+    if (t >= b)
+        return false;
+
+    PoolRange* slot = &w->ranges[t % THREAD_POOL_DEQUE_CAPACITY];
+    *begin = atomic_load_explicit(&slot->begin, memory_order_relaxed);
+    *end = atomic_load_explicit(&slot->end, memory_order_relaxed);
+
+    return atomic_compare_exchange_strong_explicit(
+        &w->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+}
+
+/*
+ * Midpoint of [begin, end) rounded down to the job's alignment grid.
+ */
+static size_t split_point(const PoolJob* job, size_t begin, size_t end)
+{
+    size_t middle = begin + (end - begin) / 2;
+
+    if (middle < job->align_base)
+        return middle;
+
+    return middle - (middle - job->align_base) % job->align;
+}
+
+static void default_pool_init(void)
+{
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    thread_pool_create(&default_pool, (num_cpus > 0) ? (size_t) num_cpus : 1);
+}
@@ -0,0 +1,106 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define THREAD_POOL_DEQUE_CAPACITY  128
+#define THREAD_POOL_CACHE_LINE      64
+
+/*
+ * Processes indices [begin, end) of a parallel loop. worker identifies the
+ * calling worker (0 .. num_workers - 1); the thread that started the loop
+ * is worker 0.
+ */
+typedef void(*RangeFunc)(void* ctx, size_t begin, size_t end, size_t worker);
+
+typedef struct {
+    _Atomic size_t begin;
+    _Atomic size_t end;
+} PoolRange;
+
+/*
+ * Chase-Lev work-stealing deque of index ranges. The owner pushes and takes
+ * at the bottom; thieves steal from the top. Each worker sits on its own
+ * cache lines so that stealing does not false-share with the owner.
+ */
+typedef struct {
+    _Alignas(THREAD_POOL_CACHE_LINE) _Atomic int64_t top;
+    _Alignas(THREAD_POOL_CACHE_LINE) _Atomic int64_t bottom;
+    PoolRange ranges[THREAD_POOL_DEQUE_CAPACITY];
+    uint64_t rng_state;
+} PoolWorker;
+
+typedef struct {
+    RangeFunc func;
+    void* ctx;
+    size_t grain;
+    size_t align;
+    size_t align_base;
+} PoolJob;
+
+/*
+ * Persistent pool of num_workers - 1 threads plus the caller. Threads sleep
+ * between loops, so a loop costs a wake-up rather than a thread start.
+ */
+typedef struct {
+    size_t num_workers;
+    PoolWorker* workers;
+    pthread_t* threads;
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t idle;
+    pthread_mutex_t run_lock;
+
+    const PoolJob* job;
+    uint64_t generation;
+    size_t active;
+    bool stop;
+
+    _Alignas(THREAD_POOL_CACHE_LINE) _Atomic size_t remaining;
+} ThreadPool;
+
+/*
+ * Construction.
+ */
+
+ThreadPool* thread_pool_create(ThreadPool* pool, size_t num_workers);
+
+ThreadPool* thread_pool_default(void);
+
+/*
+ * Destruction.
+ */
+
+void thread_pool_free(ThreadPool* pool);
+
+/*
+ * Size.
+ */
+
+static inline size_t thread_pool_size(const ThreadPool* pool)
+{
+    return pool->num_workers;
+}
+
+/*
+ * Execution.
+ */
+
+void thread_pool_for(ThreadPool* pool, size_t begin, size_t end,
+                     size_t grain, size_t align, size_t align_base,
+                     RangeFunc, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THREAD_POOL_H */
@@ -1,21 +1,76 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include "vector.h"
+#include "../../common/src/hash.h"
+#include "../../common/src/perf.h"
 
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define GROW_FACTOR    2
-#define INIT_CAPACITY  4
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VECTOR_HAVE_MREMAP
+#endif
+
+#define GROW_FACTOR    VECTOR_GROW_FACTOR
+#define INIT_CAPACITY  VECTOR_INIT_CAPACITY
+
+/*
+ * vector_shrink_to_fit() leaves less slack than capacity / SHRINK_SLACK
+ * in place.
+ */
+#define SHRINK_SLACK  8
 #define NOT_FOUND     -1
 
+#define FILE_MAGIC        0x46565344u  /* "DSVF" */
+#define FILE_VERSION      1
+#define FILE_HEADER_SIZE  64
+
+/*
+ * On-disk header of a file-backed vector. The elements follow at
+ * FILE_HEADER_SIZE, so they stay cache-line aligned.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t data_size;
+    uint64_t size;
+    uint64_t capacity;
+} VectorFileHeader;
+
 static void* vector_get_internal(const Vector*, size_t pos);
 static void  vector_set_internal(Vector*, size_t pos, const void*);
 
 static Vector* vector_grow_buffer_by(Vector*, size_t n);
+static Vector* vector_grow_to_fit(Vector*, size_t new_size);
 static Vector* vector_shrink_buffer_by(Vector*, size_t n);
+static Vector* vector_spill_to_heap(Vector*, size_t new_capacity);
+
+#ifdef VECTOR_HAVE_MREMAP
+static Vector* vector_move_to_mapping(Vector*, size_t new_capacity);
+static Vector* vector_remap(Vector*, size_t new_capacity);
+static size_t  vector_mapping_length(const Vector*, size_t capacity);
+
+static Vector* vector_resize_file(Vector*, size_t new_capacity);
+static VectorFileHeader* vector_file_header(const Vector*);
+static size_t  vector_file_length(const Vector*, size_t capacity);
+#endif
+
+static size_t vector_next_capacity(const Vector*, size_t capacity);
 
 static void swap(void*, void*, size_t);
 
@@ -24,18 +79,174 @@ static void swap(void*, void*, size_t);
  */
 
 Vector* vector_create(Vector* v, size_t data_size, FreeFunc free_func)
+{
+    return vector_create_with_allocator(v, data_size, free_func,
+                                        &heap_allocator);
+}
+
+Vector* vector_create_with_allocator(Vector* v, size_t data_size,
+                                     FreeFunc free_func,
+                                     const Allocator* allocator)
 {
     v->data_size = data_size;
     v->size = 0;
     v->capacity = INIT_CAPACITY;
     v->free_func = (*free_func);
-    v->buffer_ptr = malloc(v->data_size * v->capacity);
+    v->allocator = allocator;
+    v->storage = VECTOR_STORAGE_HEAP;
+    v->reserved = 0;
+    v->growth = VECTOR_GROW_DOUBLE;
+    v->mmap_threshold = VECTOR_MMAP_THRESHOLD;
+    v->fd = -1;
+    DS_STATS_RESET(v->stats);
+    v->buffer_ptr = allocator_alloc(allocator, v->data_size * v->capacity);
     memset(v->buffer_ptr, 0, INIT_CAPACITY);
     assert(v->buffer_ptr);
 
     return v;
 }
 
+/*
+ * Uses the caller's storage as the initial buffer; no allocation happens
+ * until more than storage_size bytes are needed. storage must outlive v.
+ */
+Vector* vector_create_inline(Vector* v, size_t data_size, FreeFunc free_func,
+                             void* storage, size_t storage_size)
+{
+    v->data_size = data_size;
+    v->size = 0;
+    v->capacity = storage_size / data_size;
+    v->free_func = (*free_func);
+    v->allocator = &heap_allocator;
+    v->storage = VECTOR_STORAGE_INLINE;
+    v->reserved = 0;
+    v->growth = VECTOR_GROW_DOUBLE;
+    v->mmap_threshold = VECTOR_MMAP_THRESHOLD;
+    v->fd = -1;
+    DS_STATS_RESET(v->stats);
+    v->buffer_ptr = storage;
+
+    return v;
+}
+
+/*
+ * Adopts buffer, which holds size initialized elements and has room for
+ * capacity, without copying it. buffer must come from malloc (or from
+ * allocator) and belongs to v from now on.
+ */
+Vector* vector_from_buffer(Vector* v, void* buffer, size_t size,
+                           size_t capacity, size_t data_size,
+                           FreeFunc free_func)
+{
+    return vector_from_buffer_with_allocator(v, buffer, size, capacity,
+                                             data_size, free_func,
+                                             &heap_allocator);
+}
+
+Vector* vector_from_buffer_with_allocator(Vector* v, void* buffer,
+                                          size_t size, size_t capacity,
+                                          size_t data_size,
+                                          FreeFunc free_func,
+                                          const Allocator* allocator)
+{
+    assert(size <= capacity);
+    assert(buffer || capacity == 0);
+
+    v->data_size = data_size;
+    v->size = size;
+    v->capacity = capacity;
+    v->free_func = (*free_func);
+    v->allocator = allocator;
+    v->storage = VECTOR_STORAGE_HEAP;
+    v->reserved = 0;
+    v->growth = VECTOR_GROW_DOUBLE;
+    v->mmap_threshold = VECTOR_MMAP_THRESHOLD;
+    v->fd = -1;
+    DS_STATS_RESET(v->stats);
+    v->buffer_ptr = buffer;
+
+    return v;
+}
+
+/*
+ * Backs v with a memory-mapped file. An existing file is opened as is; in
+ * VECTOR_MAP_READ_WRITE mode a missing file is created empty. Growth
+ * extends the file. Returns NULL if the file cannot be mapped or was
+ * written with a different data_size or format version.
+ */
+Vector* vector_map_file(Vector* v, const char* path, size_t data_size,
+                        VectorMapMode mode)
+{
+#ifdef VECTOR_HAVE_MREMAP
+    bool writable = (mode == VECTOR_MAP_READ_WRITE);
+    int fd = open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (fd < 0)
+        return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+        goto fail_close;
+
+    v->data_size = data_size;
+    v->size = 0;
+    v->capacity = INIT_CAPACITY;
+    v->free_func = NULL;
+    v->allocator = &heap_allocator;
+    v->storage = VECTOR_STORAGE_FILE;
+    v->reserved = 0;
+    v->growth = VECTOR_GROW_DOUBLE;
+    v->mmap_threshold = VECTOR_MMAP_THRESHOLD;
+    v->fd = fd;
+    DS_STATS_RESET(v->stats);
+
+    bool is_new = (st.st_size == 0);
+    if (is_new) {
+        if (!writable ||
+            ftruncate(fd, vector_file_length(v, v->capacity)) < 0)
+            goto fail_close;
+    } else {
+        if ((size_t) st.st_size < FILE_HEADER_SIZE)
+            goto fail_close;
+        VectorFileHeader header;
+        if (pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+            header.magic != FILE_MAGIC || header.version != FILE_VERSION ||
+            header.data_size != data_size || header.size > header.capacity ||
+            (size_t) st.st_size < vector_file_length(v, header.capacity))
+            goto fail_close;
+        v->size = header.size;
+        v->capacity = header.capacity;
+    }
+
+    void* mapping = mmap(NULL, vector_file_length(v, v->capacity),
+                         writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                         MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+        goto fail_close;
+
+    v->buffer_ptr = (char*) mapping + FILE_HEADER_SIZE;
+
+    if (is_new) {
+        VectorFileHeader* header = vector_file_header(v);
+        header->magic = FILE_MAGIC;
+        header->version = FILE_VERSION;
+        header->data_size = data_size;
+        vector_sync(v);
+    }
+
+    return v;
+
+fail_close:
+    close(fd);
+    return NULL;
+#else
+    (void) v;
+    (void) path;
+    (void) data_size;
+    (void) mode;
+    return NULL;
+#endif
+}
+
 /*
  *                                Destruction.
  */
@@ -46,7 +257,85 @@ void vector_free(Vector* v)
         for (size_t i = 0; i < v->size; ++i)
             v->free_func(vector_get_internal(v, i));
     }
-    free(v->buffer_ptr);
+    switch (v->storage) {
+    case VECTOR_STORAGE_HEAP:
+        allocator_free(v->allocator, v->buffer_ptr,
+                       v->capacity * v->data_size);
+        break;
+#ifdef VECTOR_HAVE_MREMAP
+    case VECTOR_STORAGE_MAPPED:
+        munmap(v->buffer_ptr, vector_mapping_length(v, v->capacity));
+        break;
+    case VECTOR_STORAGE_FILE:
+        vector_sync(v);
+        munmap(vector_file_header(v), vector_file_length(v, v->capacity));
+        close(v->fd);
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+/*
+ * Hands the buffer and the elements in it over to the caller, who must
+ * release it with v's allocator (free() by default); it holds
+ * vector_capacity(v) elements. Heap buffers are returned as they are.
+ * Inline, mapped and file-backed storage cannot be handed over, so their
+ * elements are copied to a fresh buffer first. v is left without a buffer
+ * and must be created again before reuse.
+ */
+void* vector_release(Vector* v, size_t* size)
+{
+    void* buffer = v->buffer_ptr;
+
+    if (v->storage != VECTOR_STORAGE_HEAP) {
+        buffer = allocator_alloc(v->allocator, v->size * v->data_size);
+        assert(buffer || v->size == 0);
+        if (v->size > 0)
+            memcpy(buffer, v->buffer_ptr, v->size * v->data_size);
+
+        /* The elements now live in buffer: unmap without freeing them. */
+        v->free_func = NULL;
+        vector_free(v);
+        v->capacity = v->size;
+    }
+
+    if (size)
+        *size = v->size;
+
+    v->buffer_ptr = NULL;
+    v->size = 0;
+    v->storage = VECTOR_STORAGE_HEAP;
+
+    return buffer;
+}
+
+/*
+ *                                Persistence.
+ */
+
+/*
+ * Writes size and capacity into the header of a file-backed vector and
+ * flushes the mapping to disk. Also called by vector_free().
+ */
+bool vector_sync(Vector* v)
+{
+#ifdef VECTOR_HAVE_MREMAP
+    if (!vector_is_file_backed(v))
+        return false;
+    if ((fcntl(v->fd, F_GETFL) & O_ACCMODE) == O_RDONLY)
+        return true;
+
+    VectorFileHeader* header = vector_file_header(v);
+    header->size = v->size;
+    header->capacity = v->capacity;
+
+    return msync(header, vector_file_length(v, v->capacity), MS_SYNC) == 0;
+#else
+    (void) v;
+    return false;
+#endif
 }
 
 /*
@@ -69,8 +358,11 @@ bool vector_is_sorted(const Vector* v, CmpFunc cmp_func)
 
 void* vector_get(const Vector* v, size_t pos)
 {
+    DS_PERF_BEGIN(probe);
     assert(pos < v->size);
-    return (char*) v->buffer_ptr + pos * v->data_size;
+    void* data_ptr = (char*) v->buffer_ptr + pos * v->data_size;
+    DS_PERF_END(probe, DS_PERF_VECTOR_GET);
+    return data_ptr;
 }
 
 void vector_set(Vector* v, size_t pos, const void* data_ptr)
@@ -85,11 +377,27 @@ void vector_set(Vector* v, size_t pos, const void* data_ptr)
 
 Vector* vector_concat(Vector* dest, const Vector* src)
 {
-    for (size_t i = 0; i < src->size; ++i)
-        vector_push_back(dest, vector_get_internal(src, i));
+    DS_PERF_BEGIN(probe);
+    assert(dest->data_size == src->data_size);
+
+    size_t count = src->size;
+
+    /* src may be dest itself, so only read its buffer after growing. */
+    vector_grow_to_fit(dest, dest->size + count);
+    memcpy(vector_get_internal(dest, dest->size), src->buffer_ptr,
+           count * dest->data_size);
+    dest->size += count;
+
+    DS_PERF_END(probe, DS_PERF_VECTOR_CONCAT);
     return dest;
 }
 
+Vector* vector_append_array(Vector* v, const void* array, size_t count)
+{
+    vector_insert_range(v, v->size, array, count);
+    return v;
+}
+
 /*
  *                                  Equality.
  */
@@ -98,6 +406,13 @@ bool vector_equals(const Vector* v1, const Vector* v2, CmpFunc cmp_func)
 {
     if (v1->size != v2->size) return false;
 
+    if (cmp_func == NULL) {
+        assert(v1->data_size == v2->data_size);
+        return v1->size == 0 ||
+               memcmp(v1->buffer_ptr, v2->buffer_ptr,
+                      v1->size * v1->data_size) == 0;
+    }
+
     for (size_t i = 0; i < v1->size; ++i) {
         if ((*cmp_func)(vector_get_internal(v1, i),
                         vector_get_internal(v2, i)))
@@ -106,30 +421,57 @@ bool vector_equals(const Vector* v1, const Vector* v2, CmpFunc cmp_func)
     return true;
 }
 
+/*
+ *                                  Hashing.
+ */
+
+uint64_t vector_hash(const Vector* v, uint64_t seed)
+{
+    return hash_bytes(v->buffer_ptr, v->size * v->data_size, seed);
+}
+
 /*
  *                                 Insertion.
  */
 
 void vector_push_back(Vector* v, const void* data_ptr)
 {
+    DS_PERF_BEGIN(probe);
+
     if (vector_is_full(v))
-        vector_resize(v, v->capacity * GROW_FACTOR);
+        vector_grow_to_fit(v, v->size + 1);
 
     vector_set_internal(v, v->size++, data_ptr);
+
+    DS_PERF_END(probe, DS_PERF_VECTOR_PUSH_BACK);
 }
 
 void vector_insert(Vector* v, size_t pos, const void* data_ptr)
 {
-    assert(pos < v->size);
+    vector_insert_range(v, pos, data_ptr, 1);
+}
 
-    if (vector_is_full(v))
-        vector_resize(v, v->capacity * GROW_FACTOR);
+/*
+ * Inserts count elements from array before pos, reserving capacity once and
+ * shifting the tail with a single memmove. array must not point into v.
+ */
+void vector_insert_range(Vector* v, size_t pos,
+                         const void* array, size_t count)
+{
+    DS_PERF_BEGIN(probe);
+    assert(pos <= v->size);
+
+    vector_grow_to_fit(v, v->size + count);
+
+    memmove(vector_get_internal(v, pos + count),
+            vector_get_internal(v, pos),
+            (v->size - pos) * v->data_size);
+    DS_STATS_ADD(v->stats.insert_bytes, (v->size - pos) * v->data_size);
+    memcpy(vector_get_internal(v, pos), array, count * v->data_size);
 
-    for (size_t i = v->size - 1; i >= pos; --i)
-        vector_set_internal(v, i + 1, vector_get_internal(v, i));
+    v->size += count;
 
-    vector_set_internal(v, pos, data_ptr);
-    ++v->size;
+    DS_PERF_END(probe, DS_PERF_VECTOR_INSERT);
 }
 
 /*
@@ -144,20 +486,42 @@ void* vector_pop_back(Vector* v)
 
 void vector_erase(Vector* v, size_t pos)
 {
-    assert(pos < v->size);
+    vector_erase_range(v, pos, 1);
+}
+
+/*
+ * Removes count elements starting at pos, closing the gap with a single
+ * memmove. Like vector_erase, it does not call free_func on them.
+ */
+void vector_erase_range(Vector* v, size_t pos, size_t count)
+{
+    DS_PERF_BEGIN(probe);
+    assert(pos <= v->size && count <= v->size - pos);
+
+    memmove(vector_get_internal(v, pos),
+            vector_get_internal(v, pos + count),
+            (v->size - pos - count) * v->data_size);
+    DS_STATS_ADD(v->stats.erase_bytes,
+                 (v->size - pos - count) * v->data_size);
 
-    for (size_t i = pos; i < v->size - 1; ++i)
-        vector_set_internal(v, i, vector_get_internal(v, i + 1));
+    v->size -= count;
 
-    --v->size;
+    DS_PERF_END(probe, DS_PERF_VECTOR_ERASE);
 }
 
 /*
  *                                   Resize.
  */
 
+/*
+ * Sets the capacity exactly, lowering the vector_reserve() floor if it
+ * goes below it.
+ */
 Vector* vector_resize(Vector* v, size_t new_capacity)
 {
+    if (v->reserved > new_capacity)
+        v->reserved = new_capacity;
+
     if (vector_capacity(v) == new_capacity)
         return v;
 
@@ -166,20 +530,42 @@ Vector* vector_resize(Vector* v, size_t new_capacity)
         vector_shrink_buffer_by(v, v->capacity - new_capacity);
 }
 
-Vector* vector_shrink_to_fit(Vector* v)
+/*
+ * Grows the buffer to hold at least min_capacity elements. Never shrinks,
+ * and vector_shrink_to_fit() keeps min_capacity as a floor from then on.
+ */
+Vector* vector_reserve(Vector* v, size_t min_capacity)
 {
-    return (v->size != v->capacity) ? vector_resize(v, v->size) : v;
+    if (min_capacity > v->capacity)
+        vector_resize(v, min_capacity);
+    if (min_capacity > v->reserved)
+        v->reserved = min_capacity;
+    return v;
 }
 
-Vector* vector_clear(Vector* v)
+/*
+ * Shrinks the buffer to the size, but not below the reserved capacity.
+ * Slack under capacity / SHRINK_SLACK is not worth a reallocation, and
+ * the next few insertions would only grow the buffer back, so it stays.
+ * Erasure never shrinks: this is the one place that gives memory back.
+ */
+Vector* vector_shrink_to_fit(Vector* v)
 {
-    if (vector_is_empty(v))
+    size_t target = (v->size > v->reserved) ? v->size : v->reserved;
+
+    if (target == v->capacity ||
+        v->capacity - target < v->capacity / SHRINK_SLACK)
         return v;
+    return vector_resize(v, target);
+}
 
+/*
+ * Keeps the capacity, so a vector that is cleared and refilled does not
+ * reallocate. Use vector_shrink_to_fit() to release the memory.
+ */
+Vector* vector_clear(Vector* v)
+{
     v->size = 0;
-    memset(v->buffer_ptr, 0, INIT_CAPACITY);
-    vector_resize(v, INIT_CAPACITY);
-
     return v;
 }
 
@@ -189,10 +575,12 @@ Vector* vector_clear(Vector* v)
 
 Vector* vector_reverse(Vector* v)
 {
+    DS_PERF_BEGIN(probe);
     for (size_t i = 0; i < v->size / 2; ++i)
         swap(vector_get_internal(v, i),
              vector_get_internal(v, v->size - i - 1),
              v->data_size);
+    DS_PERF_END(probe, DS_PERF_VECTOR_REVERSE);
     return v;
 }
 
@@ -224,6 +612,25 @@ void vector_print(const Vector* v, PrintFunc print_func)
     printf("]\n");
 }
 
+/*
+ * Prints the DS_STATS counters; does nothing in builds without them.
+ */
+void vector_stats_dump(const Vector* v)
+{
+#ifdef DS_STATS
+    const char* format = "%12s - %llu\n";
+    printf(format, "REALLOCS",     (unsigned long long) v->stats.reallocs);
+    printf(format, "GROW_BYTES",   (unsigned long long) v->stats.grow_bytes);
+    printf(format, "SHRINK_BYTES",
+           (unsigned long long) v->stats.shrink_bytes);
+    printf(format, "INSERT_BYTES",
+           (unsigned long long) v->stats.insert_bytes);
+    printf(format, "ERASE_BYTES",  (unsigned long long) v->stats.erase_bytes);
+#else
+    (void) v;
+#endif
+}
+
 /*
  *                                  Internal.
  */
@@ -240,26 +647,217 @@ static void* vector_get_internal(const Vector* v, size_t pos)
 
 static Vector* vector_grow_buffer_by(Vector* v, size_t n)
 {
-    v->capacity += n;
+    DS_STATS_ADD(v->stats.reallocs, 1);
+    DS_STATS_ADD(v->stats.grow_bytes, v->size * v->data_size);
+
+    if (vector_is_inline(v))
+        return vector_spill_to_heap(v, v->capacity + n);
+
+#ifdef VECTOR_HAVE_MREMAP
+    if (vector_is_mapped(v))
+        return vector_remap(v, v->capacity + n);
 
-    v->buffer_ptr = realloc(v->buffer_ptr, v->capacity * v->data_size);
+    if (vector_is_file_backed(v))
+        return vector_resize_file(v, v->capacity + n);
+
+    if ((v->capacity + n) * v->data_size >= v->mmap_threshold &&
+        v->allocator == &heap_allocator)
+        return vector_move_to_mapping(v, v->capacity + n);
+#endif
+
+    v->buffer_ptr = allocator_realloc(v->allocator, v->buffer_ptr,
+                                      v->capacity * v->data_size,
+                                      (v->capacity + n) * v->data_size);
+    v->capacity += n;
     assert(v->buffer_ptr);
     memset(v->buffer_ptr + vector_size(v) * v->data_size, 0, n);
 
     return v;
 }
 
+/*
+ * Grows the buffer geometrically until it holds new_size elements, so a
+ * bulk insertion reallocates at most once.
+ */
+static Vector* vector_grow_to_fit(Vector* v, size_t new_size)
+{
+    if (new_size <= v->capacity)
+        return v;
+
+    size_t new_capacity = v->capacity ? v->capacity : INIT_CAPACITY;
+    while (new_capacity < new_size)
+        new_capacity = vector_next_capacity(v, new_capacity);
+
+    vector_grow_buffer_by(v, new_capacity - v->capacity);
+
+#ifdef __GLIBC__
+    /* Claim the slack malloc rounded the block up to. */
+    if (v->growth == VECTOR_GROW_SIZE_CLASS &&
+        v->storage == VECTOR_STORAGE_HEAP &&
+        v->allocator == &heap_allocator)
+        v->capacity = malloc_usable_size(v->buffer_ptr) / v->data_size;
+#endif
+
+    return v;
+}
+
+static size_t vector_next_capacity(const Vector* v, size_t capacity)
+{
+    switch (v->growth) {
+    case VECTOR_GROW_ONE_AND_HALF:
+        return capacity + (capacity + 1) / 2;
+    case VECTOR_GROW_DOUBLE:
+    case VECTOR_GROW_SIZE_CLASS:
+    default:
+        return capacity * GROW_FACTOR;
+    }
+}
+
 static Vector* vector_shrink_buffer_by(Vector* v, size_t n)
 {
+    DS_STATS_ADD(v->stats.reallocs, 1);
+    DS_STATS_ADD(v->stats.shrink_bytes, v->size * v->data_size);
+
+    if (vector_is_inline(v)) {
+        v->capacity -= n;
+        v->size = (v->size > v->capacity) ? v->capacity : v->size;
+        return v;
+    }
+
+#ifdef VECTOR_HAVE_MREMAP
+    if (vector_is_mapped(v) || vector_is_file_backed(v)) {
+        if (vector_is_mapped(v))
+            vector_remap(v, v->capacity - n);
+        else
+            vector_resize_file(v, v->capacity - n);
+        v->size = (v->size > v->capacity) ? v->capacity : v->size;
+        return v;
+    }
+#endif
+
+    v->buffer_ptr = allocator_realloc(v->allocator, v->buffer_ptr,
+                                      v->capacity * v->data_size,
+                                      (v->capacity - n) * v->data_size);
     v->capacity -= n;
     v->size = (v->size > v->capacity) ? v->capacity : v->size;
 
-    v->buffer_ptr = realloc(v->buffer_ptr, v->capacity * v->data_size);
     assert(v->buffer_ptr);
 
     return v;
 }
 
+/*
+ * Moves an inline buffer to the heap once it outgrows the inline storage.
+ */
+static Vector* vector_spill_to_heap(Vector* v, size_t new_capacity)
+{
+    void* heap_buffer = allocator_alloc(v->allocator,
+                                        new_capacity * v->data_size);
+    assert(heap_buffer);
+
+    memcpy(heap_buffer, v->buffer_ptr, v->size * v->data_size);
+
+    v->buffer_ptr = heap_buffer;
+    v->capacity = new_capacity;
+    v->storage = VECTOR_STORAGE_HEAP;
+
+    return v;
+}
+
+#ifdef VECTOR_HAVE_MREMAP
+
+/*
+ * Large buffers live in an anonymous mapping: growing it remaps pages
+ * instead of copying them, and transparent huge pages cut TLB misses on
+ * long scans. The heap buffer is copied once, when the threshold is crossed.
+ */
+static Vector* vector_move_to_mapping(Vector* v, size_t new_capacity)
+{
+    size_t length = vector_mapping_length(v, new_capacity);
+
+    void* mapping = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(mapping != MAP_FAILED);
+#ifdef MADV_HUGEPAGE
+    madvise(mapping, length, MADV_HUGEPAGE);
+#endif
+
+    memcpy(mapping, v->buffer_ptr, v->size * v->data_size);
+    allocator_free(v->allocator, v->buffer_ptr, v->capacity * v->data_size);
+
+    v->buffer_ptr = mapping;
+    v->capacity = new_capacity;
+    v->storage = VECTOR_STORAGE_MAPPED;
+
+    return v;
+}
+
+static Vector* vector_remap(Vector* v, size_t new_capacity)
+{
+    size_t old_length = vector_mapping_length(v, v->capacity);
+    size_t new_length = vector_mapping_length(v, new_capacity);
+
+    if (old_length != new_length) {
+        void* mapping = mremap(v->buffer_ptr, old_length, new_length,
+                               MREMAP_MAYMOVE);
+        assert(mapping != MAP_FAILED);
+#ifdef MADV_HUGEPAGE
+        madvise(mapping, new_length, MADV_HUGEPAGE);
+#endif
+        v->buffer_ptr = mapping;
+    }
+    v->capacity = new_capacity;
+
+    return v;
+}
+
+/*
+ * Mappings are whole pages; a zero-capacity vector keeps one page mapped.
+ */
+static size_t vector_mapping_length(const Vector* v, size_t capacity)
+{
+    size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    size_t length = capacity * v->data_size;
+
+    length = (length + page_size - 1) / page_size * page_size;
+    return length ? length : page_size;
+}
+
+/*
+ * Resizes the backing file first, then remaps it. The header and elements
+ * move together, so buffer_ptr stays FILE_HEADER_SIZE past the mapping.
+ */
+static Vector* vector_resize_file(Vector* v, size_t new_capacity)
+{
+    size_t old_length = vector_file_length(v, v->capacity);
+    size_t new_length = vector_file_length(v, new_capacity);
+
+    int status = ftruncate(v->fd, new_length);
+    assert(status == 0);
+    (void) status;
+
+    void* mapping = mremap(vector_file_header(v), old_length, new_length,
+                           MREMAP_MAYMOVE);
+    assert(mapping != MAP_FAILED);
+
+    v->buffer_ptr = (char*) mapping + FILE_HEADER_SIZE;
+    v->capacity = new_capacity;
+
+    return v;
+}
+
+static VectorFileHeader* vector_file_header(const Vector* v)
+{
+    return (VectorFileHeader*) ((char*) v->buffer_ptr - FILE_HEADER_SIZE);
+}
+
+static size_t vector_file_length(const Vector* v, size_t capacity)
+{
+    return FILE_HEADER_SIZE + capacity * v->data_size;
+}
+
+#endif /* VECTOR_HAVE_MREMAP */
+
 static void swap(void* a_ptr, void* b_ptr, size_t data_size)
 {
     char temp_buffer[data_size];
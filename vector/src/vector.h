@@ -1,39 +1,182 @@
 #ifndef VECTOR_H
 #define VECTOR_H
 
+#include "../../common/src/allocator.h"
+#include "../../common/src/stats.h"
+
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define VECTOR_INIT_CAPACITY  4
+#define VECTOR_GROW_FACTOR    2
+#define VECTOR_NOT_FOUND      ((size_t) -1)
+
 typedef void(*FreeFunc)(void*);
 
 typedef int(*CmpFunc)(const void*, const void*);
 
 typedef void(*PrintFunc)(const void*);
 
+/*
+ * Callbacks of vector_parallel_for() and vector_parallel_reduce(). first
+ * points at count consecutive elements starting at index pos.
+ */
+typedef void(*ForFunc)(void* first, size_t count, size_t pos, void* ctx);
+
+typedef void(*ReduceFunc)(void* acc, const void* first, size_t count,
+                          void* ctx);
+
+typedef void(*CombineFunc)(void* acc, const void* other, void* ctx);
+
+/*
+ * Buffers at least this large are moved to an anonymous memory mapping and
+ * grown with mremap instead of realloc (Linux, heap allocator only).
+ */
+#ifndef VECTOR_MMAP_THRESHOLD
+#define VECTOR_MMAP_THRESHOLD  ((size_t) 64 * 1024 * 1024)
+#endif
+
+/*
+ * vector_parallel_sort() sorts smaller vectors on the calling thread.
+ */
+#ifndef VECTOR_PARALLEL_SORT_THRESHOLD
+#define VECTOR_PARALLEL_SORT_THRESHOLD  ((size_t) 1 << 16)
+#endif
+
+/*
+ * Default chunk size of vector_parallel_for() and vector_parallel_reduce().
+ */
+#ifndef VECTOR_PARALLEL_GRAIN_BYTES
+#define VECTOR_PARALLEL_GRAIN_BYTES  ((size_t) 16 * 1024)
+#endif
+
+#ifndef SMALL_VECTOR_INLINE_BYTES
+#define SMALL_VECTOR_INLINE_BYTES  64
+#endif
+
+typedef enum {
+    VECTOR_GROW_DOUBLE,
+    VECTOR_GROW_ONE_AND_HALF,
+    VECTOR_GROW_SIZE_CLASS,
+} VectorGrowth;
+
+typedef enum {
+    VECTOR_STORAGE_HEAP,
+    VECTOR_STORAGE_INLINE,
+    VECTOR_STORAGE_MAPPED,
+    VECTOR_STORAGE_FILE,
+} VectorStorage;
+
+typedef enum {
+    VECTOR_MAP_READ,
+    VECTOR_MAP_READ_WRITE,
+} VectorMapMode;
+
+/*
+ * Counters kept with -DDS_STATS. Reallocations are counted whatever the
+ * storage; the byte counters are the live bytes a reallocation had to
+ * carry over and the tail bytes an insertion or erasure shifted.
+ */
+typedef struct {
+    uint64_t reallocs;
+    uint64_t grow_bytes;
+    uint64_t shrink_bytes;
+    uint64_t insert_bytes;
+    uint64_t erase_bytes;
+} VectorStats;
+
 typedef struct {
     size_t data_size;
     size_t size;
     size_t capacity;
+    size_t reserved;
     void*  buffer_ptr;
     FreeFunc free_func;
+    const Allocator* allocator;
+    VectorStorage storage;
+    VectorGrowth growth;
+    size_t mmap_threshold;
+    int fd;
+#ifdef DS_STATS
+    VectorStats stats;
+#endif
 } Vector;
 
+/*
+ * Vector with SMALL_VECTOR_INLINE_BYTES of inline storage. Elements live in
+ * inline_buffer until they no longer fit, and only then move to the heap.
+ * Use &sv.vector with the vector_* functions. A SmallVector must not be
+ * copied or moved while its elements are inline.
+ */
+
+typedef struct {
+    Vector vector;
+    max_align_t inline_buffer[(SMALL_VECTOR_INLINE_BYTES +
+                               sizeof(max_align_t) - 1) / sizeof(max_align_t)];
+} SmallVector;
+
 /*
  * Construction.
  */
 
 Vector* vector_create(Vector* v, size_t data_size, FreeFunc);
 
+Vector* vector_create_with_allocator(Vector* v, size_t data_size, FreeFunc,
+                                     const Allocator*);
+
+Vector* vector_create_inline(Vector* v, size_t data_size, FreeFunc,
+                             void* storage, size_t storage_size);
+
+static inline Vector* small_vector_create(SmallVector* sv, size_t data_size,
+                                          FreeFunc free_func)
+{
+    return vector_create_inline(&sv->vector, data_size, free_func,
+                                sv->inline_buffer, sizeof(sv->inline_buffer));
+}
+
+Vector* vector_map_file(Vector* v, const char* path, size_t data_size,
+                        VectorMapMode);
+
+Vector* vector_from_buffer(Vector* v, void* buffer, size_t size,
+                           size_t capacity, size_t data_size, FreeFunc);
+
+Vector* vector_from_buffer_with_allocator(Vector* v, void* buffer,
+                                          size_t size, size_t capacity,
+                                          size_t data_size, FreeFunc,
+                                          const Allocator*);
+
 /*
  * Destruction.
  */
 
 void vector_free(Vector* v);
 
+void* vector_release(Vector* v, size_t* size);
+
+/*
+ * Persistence.
+ */
+
+bool vector_sync(Vector* v);
+
+/*
+ * Serialization. vector_write() streams the elements to fd in the common
+ * stream format (../common/src/stream.h), optionally followed by their
+ * CRC32C. vector_read() creates v from such a stream and returns NULL on
+ * I/O errors, a foreign header, a different or zero data_size, a count the
+ * stream cannot hold or a bad checksum. Elements are copied bitwise, so
+ * they must not hold pointers.
+ */
+
+bool vector_write(const Vector* v, int fd, bool checksum);
+
+Vector* vector_read(Vector* v, int fd, size_t data_size, FreeFunc);
+
 /*
  * Size/Capacity.
  */
@@ -48,7 +191,14 @@ static inline size_t vector_capacity(const Vector* v)
     return v->capacity;
 }
 
-// TODO add buffer_ptr access (for qsort, lsearch, e.c.).
+/*
+ * Buffer.
+ */
+
+static inline void* vector_data(const Vector* v)
+{
+    return v->buffer_ptr;
+}
 
 /*
  * Emptiness/Fullness.
@@ -64,6 +214,21 @@ static inline bool vector_is_full(const Vector* v)
     return v->size == v->capacity;
 }
 
+static inline bool vector_is_inline(const Vector* v)
+{
+    return v->storage == VECTOR_STORAGE_INLINE;
+}
+
+static inline bool vector_is_mapped(const Vector* v)
+{
+    return v->storage == VECTOR_STORAGE_MAPPED;
+}
+
+static inline bool vector_is_file_backed(const Vector* v)
+{
+    return v->storage == VECTOR_STORAGE_FILE;
+}
+
 bool vector_is_sorted(const Vector* v, CmpFunc);
 
 
@@ -82,12 +247,22 @@ void vector_set(Vector* v, size_t pos, const void* data_ptr);
 
 Vector* vector_concat(Vector* dest, const Vector* src);
 
+Vector* vector_append_array(Vector* v, const void* array, size_t count);
+
 /*
- * Equality.
+ * Equality. A NULL CmpFunc compares the elements byte for byte with one
+ * memcmp, which is only correct for types without padding or floats.
  */
 
 bool vector_equals(const Vector* v1, const Vector* v2, CmpFunc);
 
+/*
+ * Hashing. Hashes the bytes of the elements (wyhash), so vectors that are
+ * equal under a NULL CmpFunc hash equal. Not for untrusted keys.
+ */
+
+uint64_t vector_hash(const Vector* v, uint64_t seed);
+
 /*
  * Insertion.
  */
@@ -96,6 +271,9 @@ void vector_push_back(Vector* v, const void* data_ptr);
 
 void vector_insert(Vector* v, size_t pos, const void* data_ptr);
 
+void vector_insert_range(Vector* v, size_t pos,
+                         const void* array, size_t count);
+
 /*
  * Remove.
  */
@@ -104,16 +282,70 @@ void* vector_pop_back(Vector* v);
 
 void vector_erase(Vector* v, size_t pos);
 
+void vector_erase_range(Vector* v, size_t pos, size_t count);
+
 /*
  * Resize.
  */
 
 Vector* vector_resize(Vector* v, size_t new_capacity);
 
+Vector* vector_reserve(Vector* v, size_t min_capacity);
+
+static inline Vector* vector_set_growth(Vector* v, VectorGrowth growth)
+{
+    v->growth = growth;
+    return v;
+}
+
+static inline Vector* vector_set_mmap_threshold(Vector* v, size_t bytes)
+{
+    v->mmap_threshold = bytes;
+    return v;
+}
+
 Vector* vector_shrink_to_fit(Vector* v);
 
 Vector* vector_clear(Vector* v);
 
+/*
+ * Searching.
+ */
+
+size_t vector_find(const Vector* v, const void* data_ptr);
+
+size_t vector_count(const Vector* v, const void* data_ptr);
+
+bool vector_contains(const Vector* v, const void* data_ptr);
+
+size_t vector_lower_bound(const Vector* v, const void* data_ptr, CmpFunc);
+
+size_t vector_binary_search(const Vector* v, const void* data_ptr, CmpFunc);
+
+/*
+ * Sorting.
+ */
+
+void vector_sort(Vector* v, CmpFunc);
+
+void vector_sort_u32(Vector* v);
+
+void vector_sort_u64(Vector* v);
+
+void vector_sort_i64(Vector* v);
+
+void vector_parallel_sort(Vector* v, CmpFunc, size_t nthreads);
+
+/*
+ * Parallel iteration.
+ */
+
+void vector_parallel_for(Vector* v, ForFunc, void* ctx, size_t grain);
+
+void vector_parallel_reduce(const Vector* v, void* result_ptr,
+                            size_t result_size, ReduceFunc, CombineFunc,
+                            void* ctx, size_t grain);
+
 /*
  * Reversion.
  */
@@ -128,6 +360,8 @@ void vector_print(const Vector* v, PrintFunc);
 
 void vector_info(const Vector* v);
 
+void vector_stats_dump(const Vector* v);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,115 @@
+#include "vector.h"
+#include "../../common/src/stream.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * vector_read() grows the vector by at most this many bytes per read, so
+ * a count the stream cannot back costs no more than one block.
+ */
+#define READ_BLOCK_BYTES  (64 * 1024)
+
+static bool stream_count_fits(int fd, const struct stat* st, size_t count,
+                              size_t data_size);
+
+/*
+ *                               Serialization.
+ */
+
+/*
+ * Header, elements and checksum go out in one writev, however large the
+ * vector is; only short writes cost extra system calls.
+ */
+bool vector_write(const Vector* v, int fd, bool checksum)
+{
+    size_t length = v->size * v->data_size;
+    StreamHeader header;
+    uint32_t crc = checksum ? crc32c(0, v->buffer_ptr, length) : 0;
+
+    stream_header_create(&header, v->data_size, v->size, checksum);
+
+    struct iovec iov[3] = {
+        { &header, sizeof(header) },
+        { v->buffer_ptr, length },
+        { &crc, sizeof(crc) },
+    };
+    return stream_write_all(fd, iov, checksum ? 3 : 2);
+}
+
+/*
+ * Reads the elements straight into the vector's buffer. The header's
+ * count is not trusted: a regular file must be long enough to hold count
+ * elements, and gets its buffer in one go; any other stream grows the
+ * buffer geometrically as the blocks actually arrive.
+ */
+Vector* vector_read(Vector* v, int fd, size_t data_size, FreeFunc free_func)
+{
+    StreamHeader header;
+    if (data_size == 0 || !stream_read_header(fd, &header, data_size) ||
+        header.count > SIZE_MAX / data_size)
+        return NULL;
+
+    struct stat st;
+    bool regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (regular && !stream_count_fits(fd, &st, header.count, data_size))
+        return NULL;
+
+    vector_create(v, data_size, free_func);
+
+    size_t per_block = READ_BLOCK_BYTES / data_size;
+    per_block = per_block ? per_block : 1;
+
+    while (v->size < header.count) {
+        size_t remaining = header.count - v->size;
+        size_t count = (remaining < per_block) ? remaining : per_block;
+
+        if (v->capacity - v->size < count) {
+            size_t needed = v->size + count;
+            size_t doubled = v->capacity * 2;
+            vector_resize(v, regular ? header.count :
+                             (doubled > needed) ? doubled : needed);
+        }
+
+        char* end = (char*) v->buffer_ptr + v->size * data_size;
+        if (!stream_read_all(fd, end, count * data_size))
+            goto fail;
+        v->size += count;
+    }
+
+    if (header.flags & STREAM_FLAG_CRC32C) {
+        uint32_t crc;
+        if (!stream_read_all(fd, &crc, sizeof(crc)) ||
+            crc != crc32c(0, v->buffer_ptr, v->size * data_size))
+            goto fail;
+    }
+
+    return v;
+
+fail:
+    /* A partly read vector holds nothing free_func may look at. */
+    v->free_func = NULL;
+    vector_free(v);
+    return NULL;
+}
+
+/*
+ *                                  Internal.
+ */
+
+/*
+ * Whether the rest of the regular file fd, whose status is st, can hold
+ * count elements.
+ */
+static bool stream_count_fits(int fd, const struct stat* st, size_t count,
+                              size_t data_size)
+{
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset < 0 || offset > st->st_size)
+        return false;
+
+    return count <= (uint64_t) (st->st_size - offset) / data_size;
+}
@@ -0,0 +1,350 @@
+#include "vector.h"
+#include "thread_pool.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_THREADS  256
+#define CACHE_LINE   THREAD_POOL_CACHE_LINE
+
+/*
+ * One unit of work for a sort thread: either sort a run in place, or
+ * produce output[out_begin, out_end) of the merge of runs a and b.
+ */
+typedef struct {
+    const Vector* v;
+    CmpFunc cmp_func;
+    char* a;
+    size_t a_size;
+    char* b;
+    size_t b_size;
+    char* out;
+    size_t out_begin;
+    size_t out_end;
+} SortTask;
+
+typedef struct {
+    Vector* v;
+    ForFunc func;
+    void* ctx;
+} ForJob;
+
+typedef struct {
+    const Vector* v;
+    ReduceFunc func;
+    void* ctx;
+    char* accumulators;
+    size_t stride;
+} ReduceJob;
+
+static void* sort_task_run(void*);
+static void* merge_task_run(void*);
+
+static void run_tasks(void* (*)(void*), SortTask*, size_t num_tasks);
+static void run_tasks_range(void*, size_t begin, size_t end, size_t worker);
+
+static void for_range(void*, size_t begin, size_t end, size_t worker);
+static void reduce_range(void*, size_t begin, size_t end, size_t worker);
+
+static void vector_parallel_run(const Vector* v, size_t grain,
+                                RangeFunc, void* ctx);
+
+static size_t merge_split(const SortTask*, size_t k, size_t data_size);
+
+/*
+ *                                  Sorting.
+ */
+
+/*
+ * Parallel merge sort. The buffer is cut into nthreads runs that are sorted
+ * concurrently with vector_sort, then merged pairwise in log2(nthreads)
+ * rounds. Every round is split into nthreads equal slices of the output
+ * (merge-path partitioning), so all threads stay busy up to the last
+ * round. The tasks run on the default thread pool; nthreads == 0 uses one
+ * run per pool worker. Small vectors are sorted serially.
+ */
+void vector_parallel_sort(Vector* v, CmpFunc cmp_func, size_t nthreads)
+{
+    size_t n = v->size;
+    size_t data_size = v->data_size;
+
+    if (nthreads == 0)
+        nthreads = thread_pool_size(thread_pool_default());
+    nthreads = (nthreads > MAX_THREADS) ? MAX_THREADS : nthreads;
+
+    if (nthreads < 2 || n < VECTOR_PARALLEL_SORT_THRESHOLD) {
+        vector_sort(v, cmp_func);
+        return;
+    }
+
+    SortTask tasks[MAX_THREADS];
+    size_t run_bounds[MAX_THREADS + 1];
+    size_t num_runs = nthreads;
+
+    for (size_t t = 0; t <= num_runs; ++t)
+        run_bounds[t] = n * t / num_runs;
+
+    for (size_t t = 0; t < num_runs; ++t) {
+        tasks[t].v = v;
+        tasks[t].cmp_func = cmp_func;
+        tasks[t].a = (char*) v->buffer_ptr + run_bounds[t] * data_size;
+        tasks[t].a_size = run_bounds[t + 1] - run_bounds[t];
+    }
+    run_tasks(sort_task_run, tasks, num_runs);
+
+    char* scratch = allocator_alloc(v->allocator, n * data_size);
+    assert(scratch);
+
+    char* src = v->buffer_ptr;
+    char* dst = scratch;
+
+    while (num_runs > 1) {
+        size_t num_pairs = (num_runs + 1) / 2;
+        size_t slices = (nthreads > num_pairs) ? nthreads / num_pairs : 1;
+        size_t num_tasks = 0;
+
+        for (size_t p = 0; p < num_pairs; ++p) {
+            size_t begin = run_bounds[2 * p];
+            size_t middle = run_bounds[(2 * p + 1 < num_runs) ? 2 * p + 1 :
+                                                                num_runs];
+            size_t end = run_bounds[(2 * p + 2 < num_runs) ? 2 * p + 2 :
+                                                             num_runs];
+            size_t out_size = end - begin;
+
+            for (size_t s = 0; s < slices; ++s) {
+                SortTask* task = &tasks[num_tasks++];
+                task->v = v;
+                task->cmp_func = cmp_func;
+                task->a = src + begin * data_size;
+                task->a_size = middle - begin;
+                task->b = src + middle * data_size;
+                task->b_size = end - middle;
+                task->out = dst + begin * data_size;
+                task->out_begin = out_size * s / slices;
+                task->out_end = out_size * (s + 1) / slices;
+            }
+            run_bounds[p] = begin;
+        }
+        run_bounds[num_pairs] = n;
+        run_tasks(merge_task_run, tasks, num_tasks);
+
+        num_runs = num_pairs;
+        char* temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    if (src != v->buffer_ptr)
+        memcpy(v->buffer_ptr, src, n * data_size);
+
+    allocator_free(v->allocator, scratch, n * data_size);
+}
+
+/*
+ *                             Parallel iteration.
+ */
+
+/*
+ * Calls func on disjoint chunks of v that together cover every element,
+ * from all workers of the default thread pool. Chunks hold at most grain
+ * elements (0 picks VECTOR_PARALLEL_GRAIN_BYTES worth) and, where the
+ * element size allows, start on cache-line boundaries so that workers
+ * writing neighbouring chunks do not false-share. func must not start
+ * another parallel loop.
+ */
+void vector_parallel_for(Vector* v, ForFunc func, void* ctx, size_t grain)
+{
+    ForJob job = { v, func, ctx };
+    vector_parallel_run(v, grain, for_range, &job);
+}
+
+/*
+ * Folds v into *result_ptr. Every worker starts from a copy of the initial
+ * *result_ptr, which must therefore be an identity of combine_func, folds
+ * its chunks into it with reduce_func, and the partial results are then
+ * combined into *result_ptr on the calling thread in unspecified order:
+ * the reduction has to be associative and commutative. result_size may be
+ * 0 for a reduction that works entirely through ctx.
+ */
+void vector_parallel_reduce(const Vector* v, void* result_ptr,
+                            size_t result_size, ReduceFunc reduce_func,
+                            CombineFunc combine_func, void* ctx, size_t grain)
+{
+    ThreadPool* pool = thread_pool_default();
+    size_t num_workers = thread_pool_size(pool);
+
+    /*
+     * One accumulator per worker, each on its own cache lines; at least
+     * one line, so that even a result_size of 0 has a block to point to.
+     */
+    size_t stride = (result_size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    stride = stride ? stride : CACHE_LINE;
+    char* accumulators = aligned_alloc(CACHE_LINE, num_workers * stride);
+    assert(accumulators);
+
+    for (size_t w = 0; w < num_workers && result_size > 0; ++w)
+        memcpy(accumulators + w * stride, result_ptr, result_size);
+
+    ReduceJob job = { v, reduce_func, ctx, accumulators, stride };
+    vector_parallel_run(v, grain, reduce_range, &job);
+
+    for (size_t w = 0; w < num_workers; ++w)
+        (*combine_func)(result_ptr, accumulators + w * stride, ctx);
+
+    free(accumulators);
+}
+
+/*
+ *                                  Internal.
+ */
+
+static void* sort_task_run(void* arg)
+{
+    SortTask* task = arg;
+
+    /* A view of the run, so vector_sort picks the specialized swaps. */
+    Vector run = *task->v;
+    run.buffer_ptr = task->a;
+    run.size = task->a_size;
+
+    vector_sort(&run, task->cmp_func);
+    return NULL;
+}
+
+static void* merge_task_run(void* arg)
+{
+    SortTask* task = arg;
+    size_t data_size = task->v->data_size;
+    CmpFunc cmp_func = task->cmp_func;
+
+    size_t i = merge_split(task, task->out_begin, data_size);
+    size_t j = task->out_begin - i;
+    size_t i_end = merge_split(task, task->out_end, data_size);
+    size_t j_end = task->out_end - i_end;
+
+    char* out = task->out + task->out_begin * data_size;
+
+    /* Ties take from a first, which keeps the merge stable. */
+    while (i < i_end && j < j_end) {
+        const char* a_ptr = task->a + i * data_size;
+        const char* b_ptr = task->b + j * data_size;
+        if ((*cmp_func)(b_ptr, a_ptr) < 0) {
+            memcpy(out, b_ptr, data_size);
+            ++j;
+        } else {
+            memcpy(out, a_ptr, data_size);
+            ++i;
+        }
+        out += data_size;
+    }
+    memcpy(out, task->a + i * data_size, (i_end - i) * data_size);
+    out += (i_end - i) * data_size;
+    memcpy(out, task->b + j * data_size, (j_end - j) * data_size);
+
+    return NULL;
+}
+
+/*
+ * Number of elements the first k outputs of the merge take from run a:
+ * the largest i with a[i - 1] <= b[k - i], found by binary search.
+ */
+static size_t merge_split(const SortTask* task, size_t k, size_t data_size)
+{
+    size_t low = (k > task->b_size) ? k - task->b_size : 0;
+    size_t high = (k < task->a_size) ? k : task->a_size;
+
+    while (low < high) {
+        size_t i = low + (high - low) / 2;
+        /* Taking i + 1 from a is valid if a[i] <= b[k - i - 1]. */
+        if ((*task->cmp_func)(task->a + i * data_size,
+                              task->b + (k - i - 1) * data_size) <= 0)
+            low = i + 1;
+        else
+            high = i;
+    }
+    return low;
+}
+
+typedef struct {
+    void* (*task_func)(void*);
+    SortTask* tasks;
+} TaskBatch;
+
+/*
+ * Runs the tasks on the default thread pool, one task per grain, so no
+ * threads are started per sort round.
+ */
+static void run_tasks(void* (*task_func)(void*), SortTask* tasks,
+                      size_t num_tasks)
+{
+    TaskBatch batch = { task_func, tasks };
+    thread_pool_for(thread_pool_default(), 0, num_tasks, 1, 1, 0,
+                    run_tasks_range, &batch);
+}
+
+static void run_tasks_range(void* ctx, size_t begin, size_t end,
+                            size_t worker)
+{
+    TaskBatch* batch = ctx;
+    (void) worker;
+
+    for (size_t t = begin; t < end; ++t)
+        batch->task_func(&batch->tasks[t]);
+}
+
+static void for_range(void* ctx, size_t begin, size_t end, size_t worker)
+{
+    ForJob* job = ctx;
+    char* first = (char*) job->v->buffer_ptr + begin * job->v->data_size;
+    (void) worker;
+
+    (*job->func)(first, end - begin, begin, job->ctx);
+}
+
+static void reduce_range(void* ctx, size_t begin, size_t end, size_t worker)
+{
+    ReduceJob* job = ctx;
+    const char* first = (const char*) job->v->buffer_ptr +
+                        begin * job->v->data_size;
+
+    (*job->func)(job->accumulators + worker * job->stride, first,
+                 end - begin, job->ctx);
+}
+
+/*
+ * Splits [0, v->size) on the default pool. Split points are kept on the
+ * smallest element stride that is a whole number of cache lines, counted
+ * from the first element that starts on a cache-line boundary.
+ */
+static void vector_parallel_run(const Vector* v, size_t grain,
+                                RangeFunc func, void* ctx)
+{
+    size_t data_size = v->data_size;
+    size_t align_base = 0;
+
+    /* CACHE_LINE / gcd(data_size, CACHE_LINE) elements span whole lines. */
+    size_t a = data_size, b = CACHE_LINE;
+    while (b != 0) {
+        size_t r = a % b;
+        a = b;
+        b = r;
+    }
+    size_t align = CACHE_LINE / a;
+
+    size_t offset = (uintptr_t) v->buffer_ptr % CACHE_LINE;
+    while (align_base < align &&
+           (offset + align_base * data_size) % CACHE_LINE != 0)
+        ++align_base;
+    if (align_base == align)
+        align_base = 0;
+
+    if (grain == 0)
+        grain = VECTOR_PARALLEL_GRAIN_BYTES / data_size + 1;
+    grain = (grain + align - 1) / align * align;
+
+    thread_pool_for(thread_pool_default(), 0, v->size, grain, align,
+                    align_base, func, ctx);
+}
@@ -0,0 +1,344 @@
+#include "vector.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VECTOR_HAVE_X86_SIMD
+#endif
+
+typedef size_t (*FindKernel)(const char* base, size_t n, const void* key);
+
+typedef size_t (*CountKernel)(const char* base, size_t n, const void* key);
+
+static FindKernel  find_kernel(size_t data_size);
+static CountKernel count_kernel(size_t data_size);
+
+/*
+ * Scalar kernels. The fixed-size versions compare with one integer load;
+ * the generic one handles every other data_size with memcmp.
+ */
+
+#define DEFINE_SCALAR_KERNELS(N, T)                                           \
+                                                                              \
+static size_t find_scalar_##N(const char* base, size_t n, const void* key)    \
+{                                                                             \
+    T k, x;                                                                   \
+    memcpy(&k, key, sizeof(T));                                               \
+    for (size_t i = 0; i < n; ++i) {                                          \
+        memcpy(&x, base + i * sizeof(T), sizeof(T));                          \
+        if (x == k)                                                           \
+            return i;                                                         \
+    }                                                                         \
+    return VECTOR_NOT_FOUND;                                                  \
+}                                                                             \
+                                                                              \
+static size_t count_scalar_##N(const char* base, size_t n, const void* key)   \
+{                                                                             \
+    T k, x;                                                                   \
+    size_t count = 0;                                                         \
+    memcpy(&k, key, sizeof(T));                                               \
+    for (size_t i = 0; i < n; ++i) {                                          \
+        memcpy(&x, base + i * sizeof(T), sizeof(T));                          \
+        count += (x == k);                                                    \
+    }                                                                         \
+    return count;                                                             \
+}
+
+DEFINE_SCALAR_KERNELS(1, uint8_t)
+DEFINE_SCALAR_KERNELS(2, uint16_t)
+DEFINE_SCALAR_KERNELS(4, uint32_t)
+DEFINE_SCALAR_KERNELS(8, uint64_t)
+
+#ifdef VECTOR_HAVE_X86_SIMD
+
+#define DEFINE_LOAD(bits)                                                     \
+static inline int##bits##_t load_i##bits(const void* ptr)                     \
+{                                                                             \
+    int##bits##_t x;                                                          \
+    memcpy(&x, ptr, sizeof(x));                                               \
+    return x;                                                                 \
+}
+
+DEFINE_LOAD(8)
+DEFINE_LOAD(16)
+DEFINE_LOAD(32)
+DEFINE_LOAD(64)
+
+/*
+ * SIMD kernels: compare a whole register of elements per step, turn the
+ * result into a byte mask with movemask, and locate or count the matches
+ * from the mask bits (N bits per matching N-byte element). The remainder
+ * that does not fill a register goes through the scalar kernel.
+ */
+
+#define SSE2_BROADCAST_1(key)  _mm_set1_epi8(load_i8(key))
+#define SSE2_BROADCAST_2(key)  _mm_set1_epi16(load_i16(key))
+#define SSE2_BROADCAST_4(key)  _mm_set1_epi32(load_i32(key))
+#define SSE2_BROADCAST_8(key)  _mm_set1_epi64x(load_i64(key))
+
+#define SSE2_CMPEQ_1(a, b)     _mm_cmpeq_epi8(a, b)
+#define SSE2_CMPEQ_2(a, b)     _mm_cmpeq_epi16(a, b)
+#define SSE2_CMPEQ_4(a, b)     _mm_cmpeq_epi32(a, b)
+#define SSE2_CMPEQ_8(a, b)     sse2_cmpeq_epi64(a, b)
+
+/* SSE2 has no 64-bit compare: both 32-bit halves have to match. */
+__attribute__((target("sse2")))
+static inline __m128i sse2_cmpeq_epi64(__m128i a, __m128i b)
+{
+    __m128i eq32 = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(eq32,
+                         _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+#define DEFINE_SSE2_KERNELS(N)                                                \
+                                                                              \
+__attribute__((target("sse2")))                                               \
+static size_t find_sse2_##N(const char* base, size_t n, const void* key)      \
+{                                                                             \
+    const size_t per_reg = 16 / N;                                            \
+    __m128i k = SSE2_BROADCAST_##N(key);                                      \
+    size_t i = 0;                                                             \
+    for (; i + per_reg <= n; i += per_reg) {                                  \
+        __m128i x = _mm_loadu_si128((const __m128i*) (base + i * N));         \
+        unsigned mask = (unsigned) _mm_movemask_epi8(SSE2_CMPEQ_##N(x, k));   \
+        if (mask)                                                             \
+            return i + (size_t) __builtin_ctz(mask) / N;                      \
+    }                                                                         \
+    size_t pos = find_scalar_##N(base + i * N, n - i, key);                   \
+    return (pos == VECTOR_NOT_FOUND) ? pos : i + pos;                         \
+}                                                                             \
+                                                                              \
+__attribute__((target("sse2")))                                               \
+static size_t count_sse2_##N(const char* base, size_t n, const void* key)     \
+{                                                                             \
+    const size_t per_reg = 16 / N;                                            \
+    __m128i k = SSE2_BROADCAST_##N(key);                                      \
+    size_t count = 0;                                                         \
+    size_t i = 0;                                                             \
+    for (; i + per_reg <= n; i += per_reg) {                                  \
+        __m128i x = _mm_loadu_si128((const __m128i*) (base + i * N));         \
+        unsigned mask = (unsigned) _mm_movemask_epi8(SSE2_CMPEQ_##N(x, k));   \
+        count += (size_t) __builtin_popcount(mask) / N;                       \
+    }                                                                         \
+    return count + count_scalar_##N(base + i * N, n - i, key);                \
+}
+
+DEFINE_SSE2_KERNELS(1)
+DEFINE_SSE2_KERNELS(2)
+DEFINE_SSE2_KERNELS(4)
+DEFINE_SSE2_KERNELS(8)
+
+#define AVX2_BROADCAST_1(key)  _mm256_set1_epi8(load_i8(key))
+#define AVX2_BROADCAST_2(key)  _mm256_set1_epi16(load_i16(key))
+#define AVX2_BROADCAST_4(key)  _mm256_set1_epi32(load_i32(key))
+#define AVX2_BROADCAST_8(key)  _mm256_set1_epi64x(load_i64(key))
+
+#define AVX2_CMPEQ_1(a, b)     _mm256_cmpeq_epi8(a, b)
+#define AVX2_CMPEQ_2(a, b)     _mm256_cmpeq_epi16(a, b)
+#define AVX2_CMPEQ_4(a, b)     _mm256_cmpeq_epi32(a, b)
+#define AVX2_CMPEQ_8(a, b)     _mm256_cmpeq_epi64(a, b)
+
+#define DEFINE_AVX2_KERNELS(N)                                                \
+                                                                              \
+__attribute__((target("avx2")))                                               \
+static size_t find_avx2_##N(const char* base, size_t n, const void* key)      \
+{                                                                             \
+    const size_t per_reg = 32 / N;                                            \
+    __m256i k = AVX2_BROADCAST_##N(key);                                      \
+    size_t i = 0;                                                             \
+    for (; i + per_reg <= n; i += per_reg) {                                  \
+        __m256i x = _mm256_loadu_si256((const __m256i*) (base + i * N));      \
+        unsigned mask =                                                       \
+            (unsigned) _mm256_movemask_epi8(AVX2_CMPEQ_##N(x, k));            \
+        if (mask)                                                             \
+            return i + (size_t) __builtin_ctz(mask) / N;                      \
+    }                                                                         \
+    size_t pos = find_scalar_##N(base + i * N, n - i, key);                   \
+    return (pos == VECTOR_NOT_FOUND) ? pos : i + pos;                         \
+}                                                                             \
+                                                                              \
+__attribute__((target("avx2,popcnt")))                                        \
+static size_t count_avx2_##N(const char* base, size_t n, const void* key)     \
+{                                                                             \
+    const size_t per_reg = 32 / N;                                            \
+    __m256i k = AVX2_BROADCAST_##N(key);                                      \
+    size_t count = 0;                                                         \
+    size_t i = 0;                                                             \
+    for (; i + per_reg <= n; i += per_reg) {                                  \
+        __m256i x = _mm256_loadu_si256((const __m256i*) (base + i * N));      \
+        unsigned mask =                                                       \
+            (unsigned) _mm256_movemask_epi8(AVX2_CMPEQ_##N(x, k));            \
+        count += (size_t) __builtin_popcount(mask) / N;                       \
+    }                                                                         \
+    return count + count_scalar_##N(base + i * N, n - i, key);                \
+}
+
+DEFINE_AVX2_KERNELS(1)
+DEFINE_AVX2_KERNELS(2)
+DEFINE_AVX2_KERNELS(4)
+DEFINE_AVX2_KERNELS(8)
+
+#endif /* VECTOR_HAVE_X86_SIMD */
+
+/*
+ *                                 Searching.
+ */
+
+/*
+ * Position of the first element that is bytewise equal to *data_ptr, or
+ * VECTOR_NOT_FOUND.
+ */
+size_t vector_find(const Vector* v, const void* data_ptr)
+{
+    FindKernel kernel = find_kernel(v->data_size);
+
+    if (kernel)
+        return kernel(v->buffer_ptr, v->size, data_ptr);
+
+    for (size_t i = 0; i < v->size; ++i) {
+        if (!memcmp((const char*) v->buffer_ptr + i * v->data_size,
+                    data_ptr, v->data_size))
+            return i;
+    }
+    return VECTOR_NOT_FOUND;
+}
+
+/*
+ * Number of elements that are bytewise equal to *data_ptr.
+ */
+size_t vector_count(const Vector* v, const void* data_ptr)
+{
+    CountKernel kernel = count_kernel(v->data_size);
+
+    if (kernel)
+        return kernel(v->buffer_ptr, v->size, data_ptr);
+
+    size_t count = 0;
+    for (size_t i = 0; i < v->size; ++i)
+        count += !memcmp((const char*) v->buffer_ptr + i * v->data_size,
+                         data_ptr, v->data_size);
+    return count;
+}
+
+bool vector_contains(const Vector* v, const void* data_ptr)
+{
+    return vector_find(v, data_ptr) != VECTOR_NOT_FOUND;
+}
+
+/*
+ * Position of the first element not less than *data_ptr in a vector sorted
+ * by cmp_func. The loop has no data-dependent branch: each step halves the
+ * range with a conditional move, and both candidate midpoints of the next
+ * step are prefetched.
+ */
+size_t vector_lower_bound(const Vector* v, const void* data_ptr,
+                          CmpFunc cmp_func)
+{
+    const char* first = v->buffer_ptr;
+    const char* base = first;
+    size_t data_size = v->data_size;
+    size_t n = v->size;
+
+    if (n == 0)
+        return 0;
+
+    while (n > 1) {
+        size_t half = n / 2;
+        __builtin_prefetch(base + (half / 2) * data_size);
+        __builtin_prefetch(base + (half + half / 2) * data_size);
+        base = ((*cmp_func)(base + half * data_size, data_ptr) < 0) ?
+               base + half * data_size : base;
+        n -= half;
+    }
+
+    return (size_t) (base - first) / data_size +
+           ((*cmp_func)(base, data_ptr) < 0);
+}
+
+/*
+ * Position of an element equal to *data_ptr in a vector sorted by
+ * cmp_func, or VECTOR_NOT_FOUND.
+ */
+size_t vector_binary_search(const Vector* v, const void* data_ptr,
+                            CmpFunc cmp_func)
+{
+    size_t pos = vector_lower_bound(v, data_ptr, cmp_func);
+
+    if (pos < v->size &&
+        (*cmp_func)((const char*) v->buffer_ptr + pos * v->data_size,
+                    data_ptr) == 0)
+        return pos;
+
+    return VECTOR_NOT_FOUND;
+}
+
+/*
+ *                                  Internal.
+ */
+
+/*
+ * Runtime dispatch: AVX2 or SSE2 when the CPU has them, the scalar
+ * kernels otherwise. SSE2 is only a given on x86-64; a 32-bit x86 build
+ * may run on a CPU without it. Returns NULL for sizes without a kernel.
+ */
+static FindKernel find_kernel(size_t data_size)
+{
+#ifdef VECTOR_HAVE_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        switch (data_size) {
+        case 1: return find_avx2_1;
+        case 2: return find_avx2_2;
+        case 4: return find_avx2_4;
+        case 8: return find_avx2_8;
+        }
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        switch (data_size) {
+        case 1: return find_sse2_1;
+        case 2: return find_sse2_2;
+        case 4: return find_sse2_4;
+        case 8: return find_sse2_8;
+        }
+    }
+#endif
+    switch (data_size) {
+    case 1: return find_scalar_1;
+    case 2: return find_scalar_2;
+    case 4: return find_scalar_4;
+    case 8: return find_scalar_8;
+    }
+    return NULL;
+}
+
+static CountKernel count_kernel(size_t data_size)
+{
+#ifdef VECTOR_HAVE_X86_SIMD
+    if (__builtin_cpu_supports("avx2")) {
+        switch (data_size) {
+        case 1: return count_avx2_1;
+        case 2: return count_avx2_2;
+        case 4: return count_avx2_4;
+        case 8: return count_avx2_8;
+        }
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        switch (data_size) {
+        case 1: return count_sse2_1;
+        case 2: return count_sse2_2;
+        case 4: return count_sse2_4;
+        case 8: return count_sse2_8;
+        }
+    }
+#endif
+    switch (data_size) {
+    case 1: return count_scalar_1;
+    case 2: return count_scalar_2;
+    case 4: return count_scalar_4;
+    case 8: return count_scalar_8;
+    }
+    return NULL;
+}
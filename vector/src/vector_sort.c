@@ -0,0 +1,309 @@
+#include "vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define INSERTION_THRESHOLD  16
+#define RADIX_BITS           8
+#define RADIX_BUCKETS        (1 << RADIX_BITS)
+
+static size_t floor_log2(size_t n);
+
+static void swap_generic(void* a_ptr, void* b_ptr, size_t data_size);
+
+static void radix_sort(Vector* v, size_t key_size, bool is_signed);
+
+/*
+ * Element swaps specialized by size. With the size known at compile time
+ * they become one or two register moves instead of byte-wise memcpys.
+ */
+
+#define SWAP_FIXED(a_ptr, b_ptr, N)                                           \
+    do {                                                                      \
+        unsigned char temp_buffer[N];                                         \
+        memcpy(temp_buffer, (a_ptr), N);                                      \
+        memcpy((a_ptr), (b_ptr), N);                                          \
+        memcpy((b_ptr), temp_buffer, N);                                      \
+    } while (0)
+
+#define SWAP_4(a_ptr, b_ptr, data_size)        SWAP_FIXED(a_ptr, b_ptr, 4)
+#define SWAP_8(a_ptr, b_ptr, data_size)        SWAP_FIXED(a_ptr, b_ptr, 8)
+#define SWAP_16(a_ptr, b_ptr, data_size)       SWAP_FIXED(a_ptr, b_ptr, 16)
+#define SWAP_GENERIC(a_ptr, b_ptr, data_size)  \
+    swap_generic(a_ptr, b_ptr, data_size)
+
+/*
+ * Introsort: median-of-three quicksort that falls back to heapsort once the
+ * recursion depth exceeds 2 * log2(n), and finishes small ranges with
+ * insertion sort. One copy is generated per swap specialization.
+ */
+
+#define DEFINE_INTROSORT(suffix, SWAP)                                        \
+                                                                              \
+static void insertion_sort_##suffix(char* base, size_t n, size_t data_size,   \
+                                    CmpFunc cmp_func)                         \
+{                                                                             \
+    for (size_t i = 1; i < n; ++i) {                                          \
+        for (size_t j = i; j > 0; --j) {                                      \
+            char* a_ptr = base + (j - 1) * data_size;                         \
+            char* b_ptr = base + j * data_size;                               \
+            if ((*cmp_func)(a_ptr, b_ptr) <= 0)                               \
+                break;                                                        \
+            SWAP(a_ptr, b_ptr, data_size);                                    \
+        }                                                                     \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static void sift_down_##suffix(char* base, size_t root, size_t n,             \
+                               size_t data_size, CmpFunc cmp_func)            \
+{                                                                             \
+    for (size_t child = 2 * root + 1; child < n; child = 2 * root + 1) {      \
+        if (child + 1 < n &&                                                  \
+            (*cmp_func)(base + child * data_size,                             \
+                        base + (child + 1) * data_size) < 0)                  \
+            ++child;                                                          \
+        if ((*cmp_func)(base + root * data_size,                              \
+                        base + child * data_size) >= 0)                       \
+            return;                                                           \
+        SWAP(base + root * data_size, base + child * data_size, data_size);   \
+        root = child;                                                         \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static void heap_sort_##suffix(char* base, size_t n, size_t data_size,        \
+                               CmpFunc cmp_func)                              \
+{                                                                             \
+    for (size_t i = n / 2; i > 0; --i)                                        \
+        sift_down_##suffix(base, i - 1, n, data_size, cmp_func);              \
+                                                                              \
+    for (size_t end = n - 1; end > 0; --end) {                                \
+        SWAP(base, base + end * data_size, data_size);                        \
+        sift_down_##suffix(base, 0, end, data_size, cmp_func);                \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static void intro_sort_##suffix(char* base, size_t n, size_t data_size,       \
+                                CmpFunc cmp_func, size_t depth)               \
+{                                                                             \
+    while (n > INSERTION_THRESHOLD) {                                         \
+        if (depth-- == 0) {                                                   \
+            heap_sort_##suffix(base, n, data_size, cmp_func);                 \
+            return;                                                           \
+        }                                                                     \
+                                                                              \
+        /* Median of first, middle and last goes to base[0]. */               \
+        char* first = base;                                                   \
+        char* middle = base + (n / 2) * data_size;                            \
+        char* last = base + (n - 1) * data_size;                              \
+        if ((*cmp_func)(middle, first) < 0)                                   \
+            SWAP(middle, first, data_size);                                   \
+        if ((*cmp_func)(last, middle) < 0) {                                  \
+            SWAP(last, middle, data_size);                                    \
+            if ((*cmp_func)(middle, first) < 0)                               \
+                SWAP(middle, first, data_size);                               \
+        }                                                                     \
+        SWAP(first, middle, data_size);                                       \
+                                                                              \
+        /* Hoare partition around base[0]. */                                 \
+        size_t i = 1, j = n - 1;                                              \
+        for (;;) {                                                            \
+            while (i <= j && (*cmp_func)(base + i * data_size, base) < 0)     \
+                ++i;                                                          \
+            while ((*cmp_func)(base + j * data_size, base) > 0)               \
+                --j;                                                          \
+            if (i >= j)                                                       \
+                break;                                                        \
+            SWAP(base + i * data_size, base + j * data_size, data_size);      \
+            ++i;                                                              \
+            --j;                                                              \
+        }                                                                     \
+        SWAP(base, base + j * data_size, data_size);                          \
+                                                                              \
+        /* Recurse into the smaller side, loop on the larger one. */          \
+        size_t left_n = j;                                                    \
+        size_t right_n = n - j - 1;                                           \
+        char* right = base + (j + 1) * data_size;                             \
+        if (left_n < right_n) {                                               \
+            intro_sort_##suffix(base, left_n, data_size, cmp_func, depth);    \
+            base = right;                                                     \
+            n = right_n;                                                      \
+        } else {                                                              \
+            intro_sort_##suffix(right, right_n, data_size, cmp_func, depth);  \
+            n = left_n;                                                       \
+        }                                                                     \
+    }                                                                         \
+    insertion_sort_##suffix(base, n, data_size, cmp_func);                    \
+}
+
+DEFINE_INTROSORT(4,       SWAP_4)
+DEFINE_INTROSORT(8,       SWAP_8)
+DEFINE_INTROSORT(16,      SWAP_16)
+DEFINE_INTROSORT(generic, SWAP_GENERIC)
+
+/*
+ *                                  Sorting.
+ */
+
+void vector_sort(Vector* v, CmpFunc cmp_func)
+{
+    if (v->size < 2)
+        return;
+
+    size_t depth = 2 * floor_log2(v->size);
+
+    switch (v->data_size) {
+    case 4:
+        intro_sort_4(v->buffer_ptr, v->size, 4, cmp_func, depth);
+        break;
+    case 8:
+        intro_sort_8(v->buffer_ptr, v->size, 8, cmp_func, depth);
+        break;
+    case 16:
+        intro_sort_16(v->buffer_ptr, v->size, 16, cmp_func, depth);
+        break;
+    default:
+        intro_sort_generic(v->buffer_ptr, v->size, v->data_size,
+                           cmp_func, depth);
+        break;
+    }
+}
+
+/*
+ * LSD radix sorts on an unsigned/signed integer key stored in the first
+ * 4 or 8 bytes of each element, so they also sort key-prefixed records.
+ * They are stable and need a scratch buffer of the same size as the data.
+ */
+
+void vector_sort_u32(Vector* v)
+{
+    radix_sort(v, sizeof(uint32_t), false);
+}
+
+void vector_sort_u64(Vector* v)
+{
+    radix_sort(v, sizeof(uint64_t), false);
+}
+
+void vector_sort_i64(Vector* v)
+{
+    radix_sort(v, sizeof(int64_t), true);
+}
+
+/*
+ *                                  Internal.
+ */
+
+static size_t floor_log2(size_t n)
+{
+    size_t log = 0;
+    while (n >>= 1)
+        ++log;
+    return log;
+}
+
+static void swap_generic(void* a_ptr, void* b_ptr, size_t data_size)
+{
+    unsigned char temp_buffer[64];
+    char* a = a_ptr;
+    char* b = b_ptr;
+
+    while (data_size) {
+        size_t chunk = (data_size < sizeof(temp_buffer)) ?
+                       data_size : sizeof(temp_buffer);
+        memcpy(temp_buffer, a, chunk);
+        memcpy(a, b, chunk);
+        memcpy(b, temp_buffer, chunk);
+        a += chunk;
+        b += chunk;
+        data_size -= chunk;
+    }
+}
+
+static inline uint64_t radix_key(const char* elem, size_t key_size,
+                                 bool is_signed)
+{
+    uint64_t key;
+
+    if (key_size == sizeof(uint32_t)) {
+        uint32_t key32;
+        memcpy(&key32, elem, sizeof(key32));
+        key = key32;
+    } else {
+        memcpy(&key, elem, sizeof(key));
+    }
+
+    /* Flipping the sign bit orders two's complement keys as unsigned. */
+    return is_signed ? key ^ ((uint64_t) 1 << 63) : key;
+}
+
+#define RADIX_SCATTER(N)                                                      \
+    for (size_t i = 0; i < n; ++i) {                                          \
+        const char* elem = src + i * (N);                                     \
+        size_t bucket = (radix_key(elem, key_size, is_signed) >> shift) &     \
+                        (RADIX_BUCKETS - 1);                                  \
+        memcpy(dst + offsets[bucket]++ * (N), elem, (N));                     \
+    }
+
+static void radix_sort(Vector* v, size_t key_size, bool is_signed)
+{
+    assert(v->data_size >= key_size);
+
+    size_t n = v->size;
+    size_t data_size = v->data_size;
+    size_t num_passes = key_size * 8 / RADIX_BITS;
+
+    if (n < 2)
+        return;
+
+    /* All histograms come from a single read pass over the data. */
+    size_t counts[8][RADIX_BUCKETS];
+    memset(counts, 0, sizeof(counts));
+
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t key = radix_key((char*) v->buffer_ptr + i * data_size,
+                                 key_size, is_signed);
+        for (size_t pass = 0; pass < num_passes; ++pass)
+            ++counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)];
+    }
+
+    char* scratch = allocator_alloc(v->allocator, n * data_size);
+    assert(scratch);
+
+    char* src = v->buffer_ptr;
+    char* dst = scratch;
+
+    for (size_t pass = 0; pass < num_passes; ++pass) {
+        size_t shift = pass * RADIX_BITS;
+
+        /* Every key has the same digit: this pass would not move anything. */
+        uint64_t digit = (radix_key(src, key_size, is_signed) >> shift) &
+                         (RADIX_BUCKETS - 1);
+        if (counts[pass][digit] == n)
+            continue;
+
+        size_t offsets[RADIX_BUCKETS];
+        size_t sum = 0;
+        for (size_t b = 0; b < RADIX_BUCKETS; ++b) {
+            offsets[b] = sum;
+            sum += counts[pass][b];
+        }
+
+        switch (data_size) {
+        case 4:  RADIX_SCATTER(4);         break;
+        case 8:  RADIX_SCATTER(8);         break;
+        case 16: RADIX_SCATTER(16);        break;
+        default: RADIX_SCATTER(data_size); break;
+        }
+
+        char* temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    if (src != v->buffer_ptr)
+        memcpy(v->buffer_ptr, src, n * data_size);
+
+    allocator_free(v->allocator, scratch, n * data_size);
+}
@@ -0,0 +1,223 @@
+#ifndef VECTOR_TYPED_H
+#define VECTOR_TYPED_H
+
+#include "vector.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Typed vector generator.
+ *
+ * VECTOR_DEFINE(VectorInt, vector_int, int) defines the type VectorInt and
+ * the functions vector_int_create(), vector_int_push_back(), ... with the
+ * same growth and ownership semantics as Vector, but with the element type
+ * known at compile time. Element access is a plain load/store instead of a
+ * runtime multiply and a variable-length memcpy.
+ */
+
+#define VECTOR_DEFINE(Name, prefix, T)                                        \
+                                                                              \
+typedef struct {                                                              \
+    size_t size;                                                              \
+    size_t capacity;                                                          \
+    T*     buffer_ptr;                                                        \
+    FreeFunc free_func;                                                       \
+} Name;                                                                       \
+                                                                              \
+/*                                                                            \
+ * Construction.                                                              \
+ */                                                                           \
+                                                                              \
+static inline Name* prefix##_create(Name* v, FreeFunc free_func)              \
+{                                                                             \
+    v->size = 0;                                                              \
+    v->capacity = VECTOR_INIT_CAPACITY;                                       \
+    v->free_func = free_func;                                                 \
+    v->buffer_ptr = (T*) malloc(sizeof(T) * v->capacity);                     \
+    assert(v->buffer_ptr);                                                    \
+    return v;                                                                 \
+}                                                                             \
+                                                                              \
+/*                                                                            \
+ * Destruction.                                                               \
+ */                                                                           \
+                                                                              \
+static inline void prefix##_free(Name* v)                                     \
+{                                                                             \
+    if (v->free_func) {                                                       \
+        for (size_t i = 0; i < v->size; ++i)                                  \
+            v->free_func(&v->buffer_ptr[i]);                                  \
+    }                                                                         \
+    free(v->buffer_ptr);                                                      \
+}                                                                             \
+                                                                              \
+/*                                                                            \
+ * Size/Capacity.                                                             \
+ */                                                                           \
+                                                                              \
+static inline size_t prefix##_size(const Name* v)                             \
+{                                                                             \
+    return v->size;                                                           \
+}                                                                             \
+                                                                              \
+static inline size_t prefix##_capacity(const Name* v)                         \
+{                                                                             \
+    return v->capacity;                                                       \
+}                                                                             \
+                                                                              \
+/*                                                                            \
+ * Emptiness/Fullness.                                                        \
+ */                                                                           \
+                                                                              \
+static inline bool prefix##_is_empty(const Name* v)                           \
+{                                                                             \
+    return v->size == 0;                                                      \
+}                                                                             \
+                                                                              \
+static inline bool prefix##_is_full(const Name* v)                            \
+{                                                                             \
+    return v->size == v->capacity;                                            \
+}                                                                             \
+                                                                              \
+/*                                                                            \
+ * Resize.                                                                    \
+ */                                                                           \
+                                                                              \
+static inline Name* prefix##_resize(Name* v, size_t new_capacity)             \
+{                                                                             \
+    if (v->capacity == new_capacity)                                          \
+        return v;                                                             \
+                                                                              \
+    v->buffer_ptr = (T*) realloc(v->buffer_ptr, sizeof(T) * new_capacity);    \
+    assert(v->buffer_ptr || new_capacity == 0);                               \
+    v->capacity = new_capacity;                                               \
+    v->size = (v->size > v->capacity) ? v->capacity : v->size;                \
+    return v;                                                                 \
+}                                                                             \
+                                                                              \
+static inline Name* prefix##_reserve(Name* v, size_t min_capacity)            \
+{                                                                             \
+    return (min_capacity > v->capacity) ? prefix##_resize(v, min_capacity) :  \
+                                          v;                                  \
+}                                                                             \
+                                                                              \
+static inline Name* prefix##_shrink_to_fit(Name* v)                           \
+{                                                                             \
+    return prefix##_resize(v, v->size);                                       \
+}                                                                             \
+                                                                              \
+static inline Name* prefix##_clear(Name* v)                                   \
+{                                                                             \
+    v->size = 0;                                                              \
+    return v;                                                                 \
+}                                                                             \
+                                                                              \
+/*                                                                            \
+ * Indexing.                                                                  \
+ */                                                                           \
+                                                                              \
+static inline T prefix##_get(const Name* v, size_t pos)                       \
+{                                                                             \
+    assert(pos < v->size);                                                    \
+    return v->buffer_ptr[pos];                                                \
+}                                                                             \
+                                                                              \
+static inline T* prefix##_at(const Name* v, size_t pos)                       \
+{                                                                             \
+    assert(pos < v->size);                                                    \
+    return &v->buffer_ptr[pos];                                               \
+}                                                                             \
+                                                                              \
+static inline void prefix##_set(Name* v, size_t pos, T data)                  \
+{                                                                             \
+    assert(pos < v->size);                                                    \
+    v->buffer_ptr[pos] = data;                                                \
+}                                                                             \
+                                                                              \
+/*                                                                            \
+ * Insertion.                                                                 \
+ */                                                                           \
+                                                                              \
+static inline void prefix##_push_back(Name* v, T data)                        \
+{                                                                             \
+    if (prefix##_is_full(v))                                                  \
+        prefix##_resize(v, v->capacity ?                                      \
+                           v->capacity * VECTOR_GROW_FACTOR :                 \
+                           VECTOR_INIT_CAPACITY);                             \
+                                                                              \
+    v->buffer_ptr[v->size++] = data;                                          \
+}                                                                             \
+                                                                              \
+static inline void prefix##_insert(Name* v, size_t pos, T data)               \
+{                                                                             \
+    assert(pos <= v->size);                                                   \
+                                                                              \
+    if (prefix##_is_full(v))                                                  \
+        prefix##_resize(v, v->capacity ?                                      \
+                           v->capacity * VECTOR_GROW_FACTOR :                 \
+                           VECTOR_INIT_CAPACITY);                             \
+                                                                              \
+    memmove(&v->buffer_ptr[pos + 1], &v->buffer_ptr[pos],                     \
+            (v->size - pos) * sizeof(T));                                     \
+    v->buffer_ptr[pos] = data;                                                \
+    ++v->size;                                                                \
+}                                                                             \
+                                                                              \
+/*                                                                            \
+ * Removal.                                                                   \
+ */                                                                           \
+                                                                              \
+static inline T prefix##_pop_back(Name* v)                                    \
+{                                                                             \
+    assert(!prefix##_is_empty(v));                                            \
+    return v->buffer_ptr[--v->size];                                          \
+}                                                                             \
+                                                                              \
+static inline void prefix##_erase(Name* v, size_t pos)                        \
+{                                                                             \
+    assert(pos < v->size);                                                    \
+                                                                              \
+    memmove(&v->buffer_ptr[pos], &v->buffer_ptr[pos + 1],                     \
+            (v->size - pos - 1) * sizeof(T));                                 \
+    --v->size;                                                                \
+}                                                                             \
+                                                                              \
+/*                                                                            \
+ * Concatenation.                                                             \
+ */                                                                           \
+                                                                              \
+static inline Name* prefix##_concat(Name* dest, const Name* src)              \
+{                                                                             \
+    size_t new_size = dest->size + src->size;                                 \
+    size_t new_capacity = dest->capacity ? dest->capacity :                   \
+                                           VECTOR_INIT_CAPACITY;              \
+                                                                              \
+    while (new_capacity < new_size)                                           \
+        new_capacity *= VECTOR_GROW_FACTOR;                                   \
+    prefix##_resize(dest, new_capacity);                                      \
+                                                                              \
+    memcpy(&dest->buffer_ptr[dest->size], src->buffer_ptr,                    \
+           src->size * sizeof(T));                                            \
+    dest->size = new_size;                                                    \
+    return dest;                                                              \
+}                                                                             \
+                                                                              \
+/*                                                                            \
+ * Reversion.                                                                 \
+ */                                                                           \
+                                                                              \
+static inline Name* prefix##_reverse(Name* v)                                 \
+{                                                                             \
+    for (size_t i = 0, j = v->size; i + 1 < j; ++i, --j) {                    \
+        T temp = v->buffer_ptr[i];                                            \
+        v->buffer_ptr[i] = v->buffer_ptr[j - 1];                              \
+        v->buffer_ptr[j - 1] = temp;                                          \
+    }                                                                         \
+    return v;                                                                 \
+}
+
+#endif /* VECTOR_TYPED_H */
@@ -0,0 +1,298 @@
+#include "../src/bit_vector.h"
+
+#include <check.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+static void bit_vector_fill_pattern(BitVector* bv, size_t num_bits);
+
+static bool pattern(size_t pos);
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_bit_vector_create)
+{
+    BitVector bv;
+    bit_vector_create(&bv, 100);
+
+    ck_assert_uint_eq(bit_vector_size(&bv), 100);
+    ck_assert_uint_eq(vector_size(&bv.words), 2);
+    ck_assert_uint_eq(bit_vector_popcount(&bv), 0);
+    for (size_t i = 0; i < 100; ++i)
+        ck_assert(!bit_vector_test(&bv, i));
+
+    bit_vector_free(&bv);
+}
+END_TEST
+
+/*
+ *                                 Bit access.
+ */
+
+START_TEST(test_bit_vector_set_clear)
+{
+    BitVector bv;
+    bit_vector_create(&bv, 130);
+
+    bit_vector_set(&bv, 0);
+    bit_vector_set(&bv, 63);
+    bit_vector_set(&bv, 64);
+    bit_vector_set(&bv, 129);
+    ck_assert(bit_vector_test(&bv, 0));
+    ck_assert(bit_vector_test(&bv, 63));
+    ck_assert(bit_vector_test(&bv, 64));
+    ck_assert(bit_vector_test(&bv, 129));
+    ck_assert(!bit_vector_test(&bv, 1));
+    ck_assert_uint_eq(bit_vector_popcount(&bv), 4);
+
+    bit_vector_clear(&bv, 63);
+    bit_vector_assign(&bv, 64, false);
+    bit_vector_assign(&bv, 5, true);
+    ck_assert(!bit_vector_test(&bv, 63));
+    ck_assert(!bit_vector_test(&bv, 64));
+    ck_assert(bit_vector_test(&bv, 5));
+    ck_assert_uint_eq(bit_vector_popcount(&bv), 3);
+
+    bit_vector_free(&bv);
+}
+END_TEST
+
+START_TEST(test_bit_vector_push_back)
+{
+    BitVector bv;
+    bit_vector_create(&bv, 0);
+
+    for (size_t i = 0; i < 1000; ++i)
+        bit_vector_push_back(&bv, pattern(i));
+
+    ck_assert_uint_eq(bit_vector_size(&bv), 1000);
+    ck_assert_uint_eq(vector_size(&bv.words), 16);
+    for (size_t i = 0; i < 1000; ++i)
+        ck_assert_int_eq(bit_vector_test(&bv, i), pattern(i));
+
+    bit_vector_free(&bv);
+}
+END_TEST
+
+START_TEST(test_bit_vector_fill_resize)
+{
+    BitVector bv;
+    bit_vector_create(&bv, 70);
+
+    bit_vector_fill(&bv, true);
+    ck_assert_uint_eq(bit_vector_popcount(&bv), 70);
+
+    /* Bits dropped by a shrink stay clear when the vector grows back. */
+    bit_vector_resize(&bv, 65);
+    ck_assert_uint_eq(bit_vector_popcount(&bv), 65);
+    bit_vector_resize(&bv, 200);
+    ck_assert_uint_eq(bit_vector_popcount(&bv), 65);
+    ck_assert(!bit_vector_test(&bv, 65));
+
+    bit_vector_fill(&bv, false);
+    ck_assert_uint_eq(bit_vector_popcount(&bv), 0);
+
+    bit_vector_free(&bv);
+}
+END_TEST
+
+/*
+ *                              Bulk operations.
+ */
+
+START_TEST(test_bit_vector_bulk)
+{
+    BitVector a, b, c;
+    bit_vector_create(&a, 1000);
+    bit_vector_create(&b, 1000);
+    bit_vector_create(&c, 1000);
+
+    for (size_t i = 0; i < 1000; ++i) {
+        bit_vector_assign(&a, i, i % 2 == 0);
+        bit_vector_assign(&b, i, i % 3 == 0);
+    }
+
+    bit_vector_fill(&c, false);
+    bit_vector_or(&c, &a);
+    bit_vector_and(&c, &b);
+    for (size_t i = 0; i < 1000; ++i)
+        ck_assert_int_eq(bit_vector_test(&c, i), i % 6 == 0);
+
+    bit_vector_fill(&c, false);
+    bit_vector_or(&c, &a);
+    bit_vector_or(&c, &b);
+    for (size_t i = 0; i < 1000; ++i)
+        ck_assert_int_eq(bit_vector_test(&c, i), i % 2 == 0 || i % 3 == 0);
+
+    bit_vector_fill(&c, false);
+    bit_vector_or(&c, &a);
+    bit_vector_xor(&c, &b);
+    for (size_t i = 0; i < 1000; ++i)
+        ck_assert_int_eq(bit_vector_test(&c, i), (i % 2 == 0) != (i % 3 == 0));
+
+    bit_vector_fill(&c, false);
+    bit_vector_or(&c, &a);
+    bit_vector_andnot(&c, &b);
+    for (size_t i = 0; i < 1000; ++i)
+        ck_assert_int_eq(bit_vector_test(&c, i), i % 2 == 0 && i % 3 != 0);
+
+    /* dest may be src. */
+    bit_vector_and(&c, &c);
+    for (size_t i = 0; i < 1000; ++i)
+        ck_assert_int_eq(bit_vector_test(&c, i), i % 2 == 0 && i % 3 != 0);
+    bit_vector_xor(&c, &c);
+    ck_assert_uint_eq(bit_vector_popcount(&c), 0);
+
+    bit_vector_free(&a);
+    bit_vector_free(&b);
+    bit_vector_free(&c);
+}
+END_TEST
+
+/*
+ *                                  Counting.
+ */
+
+START_TEST(test_bit_vector_popcount)
+{
+    BitVector bv;
+    bit_vector_create(&bv, 0);
+
+    /* Enough words for the SIMD loop plus a remainder. */
+    bit_vector_fill_pattern(&bv, 64 * 37 + 11);
+
+    size_t expected = 0;
+    for (size_t i = 0; i < bit_vector_size(&bv); ++i)
+        expected += pattern(i);
+    ck_assert_uint_eq(bit_vector_popcount(&bv), expected);
+
+    bit_vector_free(&bv);
+}
+END_TEST
+
+START_TEST(test_bit_vector_rank)
+{
+    BitVector bv;
+    bit_vector_create(&bv, 0);
+    bit_vector_fill_pattern(&bv, 5000);
+
+    size_t expected[5001];
+    expected[0] = 0;
+    for (size_t i = 0; i < 5000; ++i)
+        expected[i + 1] = expected[i] + pattern(i);
+
+    /* Without the index, then with it. */
+    for (size_t i = 0; i <= 5000; i += 7)
+        ck_assert_uint_eq(bit_vector_rank(&bv, i), expected[i]);
+
+    bit_vector_build_rank(&bv);
+    ck_assert(bv.rank_valid);
+    for (size_t i = 0; i <= 5000; ++i)
+        ck_assert_uint_eq(bit_vector_rank(&bv, i), expected[i]);
+
+    /* Any modification drops the index. */
+    bit_vector_set(&bv, 0);
+    ck_assert(!bv.rank_valid);
+    ck_assert_uint_eq(bit_vector_rank(&bv, 5000),
+                      expected[5000] + !pattern(0));
+
+    bit_vector_free(&bv);
+}
+END_TEST
+
+START_TEST(test_bit_vector_select)
+{
+    BitVector bv;
+    bit_vector_create(&bv, 0);
+    bit_vector_fill_pattern(&bv, 5000);
+
+    size_t positions[5000], count = 0;
+    for (size_t i = 0; i < 5000; ++i)
+        if (pattern(i))
+            positions[count++] = i;
+
+    for (size_t k = 0; k < count; k += 5)
+        ck_assert_uint_eq(bit_vector_select(&bv, k), positions[k]);
+    ck_assert_uint_eq(bit_vector_select(&bv, count), VECTOR_NOT_FOUND);
+
+    bit_vector_build_rank(&bv);
+    for (size_t k = 0; k < count; ++k)
+        ck_assert_uint_eq(bit_vector_select(&bv, k), positions[k]);
+    ck_assert_uint_eq(bit_vector_select(&bv, count), VECTOR_NOT_FOUND);
+
+    bit_vector_free(&bv);
+}
+END_TEST
+
+START_TEST(test_bit_vector_select_sparse)
+{
+    BitVector bv;
+    bit_vector_create(&bv, 10000);
+
+    /* Long runs of empty rank blocks between the set bits. */
+    bit_vector_set(&bv, 3);
+    bit_vector_set(&bv, 4000);
+    bit_vector_set(&bv, 9999);
+    bit_vector_build_rank(&bv);
+
+    ck_assert_uint_eq(bit_vector_select(&bv, 0), 3);
+    ck_assert_uint_eq(bit_vector_select(&bv, 1), 4000);
+    ck_assert_uint_eq(bit_vector_select(&bv, 2), 9999);
+    ck_assert_uint_eq(bit_vector_select(&bv, 3), VECTOR_NOT_FOUND);
+
+    bit_vector_free(&bv);
+}
+END_TEST
+
+Suite* bit_vector_suite(void)
+{
+    Suite* s = suite_create("BitVector");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_bit_vector_create);
+
+    /* Bit access. */
+    tcase_add_test(tc_core, test_bit_vector_set_clear);
+    tcase_add_test(tc_core, test_bit_vector_push_back);
+    tcase_add_test(tc_core, test_bit_vector_fill_resize);
+
+    /* Bulk operations. */
+    tcase_add_test(tc_core, test_bit_vector_bulk);
+
+    /* Counting. */
+    tcase_add_test(tc_core, test_bit_vector_popcount);
+    tcase_add_test(tc_core, test_bit_vector_rank);
+    tcase_add_test(tc_core, test_bit_vector_select);
+    tcase_add_test(tc_core, test_bit_vector_select_sparse);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = bit_vector_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+static void bit_vector_fill_pattern(BitVector* bv, size_t num_bits)
+{
+    for (size_t i = 0; i < num_bits; ++i)
+        bit_vector_push_back(bv, pattern(i));
+}
+
+/* An irregular mix of dense and sparse stretches. */
+static bool pattern(size_t pos)
+{
+    return (pos * 2654435761u) % 7 < 3 || (pos / 300) % 4 == 0;
+}
@@ -0,0 +1,270 @@
+#include "../src/column_vector.h"
+#include "../../common/src/arena.h"
+
+#include <check.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct {
+    uint64_t id;
+    int64_t ts;
+    double price;
+    uint32_t qty;
+} Trade;
+
+enum { COL_ID, COL_TS, COL_PRICE, COL_QTY, NUM_COLS };
+
+static void trade_columns(ColumnField fields[NUM_COLS]);
+
+static Trade make_trade(uint64_t i);
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_column_vector_create)
+{
+    ColumnField fields[NUM_COLS];
+    trade_columns(fields);
+
+    ColumnVector cv;
+    column_vector_create(&cv, sizeof(Trade), fields, NUM_COLS);
+
+    ck_assert_uint_eq(cv.row_size, sizeof(Trade));
+    ck_assert_uint_eq(cv.num_columns, NUM_COLS);
+    ck_assert_uint_eq(cv.fields[COL_QTY].offset, offsetof(Trade, qty));
+    ck_assert_uint_eq(cv.fields[COL_QTY].size, sizeof(uint32_t));
+    ck_assert_uint_eq(column_vector_size(&cv), 0);
+    ck_assert_uint_eq(column_vector_capacity(&cv), VECTOR_INIT_CAPACITY);
+    ck_assert(column_vector_is_empty(&cv));
+
+    column_vector_free(&cv);
+}
+END_TEST
+
+START_TEST(test_column_vector_create_with_allocator)
+{
+    Arena arena;
+    arena_create(&arena, 0);
+
+    ColumnField fields[NUM_COLS];
+    trade_columns(fields);
+
+    ColumnVector cv;
+    column_vector_create_with_allocator(&cv, sizeof(Trade), fields, NUM_COLS,
+                                        arena_allocator(&arena));
+
+    for (uint64_t i = 0; i < 1000; ++i) {
+        Trade trade = make_trade(i);
+        column_vector_push_back(&cv, &trade);
+    }
+    ck_assert_uint_eq(*(uint64_t*) column_vector_get(&cv, 999, COL_ID), 999);
+
+    column_vector_free(&cv);
+    arena_free(&arena);
+}
+END_TEST
+
+/*
+ *                                  Insertion.
+ */
+
+START_TEST(test_column_vector_push_back)
+{
+    ColumnField fields[NUM_COLS];
+    trade_columns(fields);
+
+    ColumnVector cv;
+    column_vector_create(&cv, sizeof(Trade), fields, NUM_COLS);
+
+    for (uint64_t i = 0; i < 1000; ++i) {
+        Trade trade = make_trade(i);
+        column_vector_push_back(&cv, &trade);
+    }
+    ck_assert_uint_eq(column_vector_size(&cv), 1000);
+
+    for (uint64_t i = 0; i < 1000; ++i) {
+        Trade expected = make_trade(i), trade;
+        memset(&trade, 0, sizeof(trade));
+        column_vector_get_row(&cv, i, &trade);
+
+        ck_assert_uint_eq(trade.id, expected.id);
+        ck_assert_int_eq(trade.ts, expected.ts);
+        ck_assert(trade.price == expected.price);
+        ck_assert_uint_eq(trade.qty, expected.qty);
+    }
+
+    column_vector_free(&cv);
+}
+END_TEST
+
+/*
+ *                                   Columns.
+ */
+
+START_TEST(test_column_vector_column)
+{
+    ColumnField fields[NUM_COLS];
+    trade_columns(fields);
+
+    ColumnVector cv;
+    column_vector_create(&cv, sizeof(Trade), fields, NUM_COLS);
+
+    for (uint64_t i = 0; i < 1000; ++i) {
+        Trade trade = make_trade(i);
+        column_vector_push_back(&cv, &trade);
+    }
+
+    /* Columns are plain arrays of the field type. */
+    const uint32_t* qty = column_vector_column(&cv, COL_QTY);
+    const double* price = column_vector_column(&cv, COL_PRICE);
+    uint64_t total_qty = 0;
+    double total_price = 0;
+
+    for (size_t i = 0; i < column_vector_size(&cv); ++i) {
+        total_qty += qty[i];
+        total_price += price[i];
+    }
+    ck_assert_uint_eq(total_qty, 1000 * 999 / 2);
+    ck_assert(total_price == 0.5 * 1000 * 999 / 2);
+
+    ck_assert_ptr_eq(column_vector_get(&cv, 10, COL_QTY), &qty[10]);
+
+    column_vector_free(&cv);
+}
+END_TEST
+
+START_TEST(test_column_vector_set)
+{
+    ColumnField fields[NUM_COLS];
+    trade_columns(fields);
+
+    ColumnVector cv;
+    column_vector_create(&cv, sizeof(Trade), fields, NUM_COLS);
+
+    for (uint64_t i = 0; i < 10; ++i) {
+        Trade trade = make_trade(i);
+        column_vector_push_back(&cv, &trade);
+    }
+
+    uint32_t qty = 12345;
+    column_vector_set(&cv, 3, COL_QTY, &qty);
+    ck_assert_uint_eq(*(uint32_t*) column_vector_get(&cv, 3, COL_QTY), 12345);
+
+    Trade trade = make_trade(77);
+    column_vector_set_row(&cv, 4, &trade);
+    ck_assert_uint_eq(*(uint64_t*) column_vector_get(&cv, 4, COL_ID), 77);
+    ck_assert_uint_eq(*(uint64_t*) column_vector_get(&cv, 5, COL_ID), 5);
+
+    column_vector_free(&cv);
+}
+END_TEST
+
+/*
+ *                                   Removal.
+ */
+
+START_TEST(test_column_vector_pop_back_clear)
+{
+    ColumnField fields[NUM_COLS];
+    trade_columns(fields);
+
+    ColumnVector cv;
+    column_vector_create(&cv, sizeof(Trade), fields, NUM_COLS);
+
+    for (uint64_t i = 0; i < 10; ++i) {
+        Trade trade = make_trade(i);
+        column_vector_push_back(&cv, &trade);
+    }
+
+    column_vector_pop_back(&cv);
+    ck_assert_uint_eq(column_vector_size(&cv), 9);
+
+    size_t capacity = column_vector_capacity(&cv);
+    column_vector_clear(&cv);
+    ck_assert(column_vector_is_empty(&cv));
+    ck_assert_uint_eq(column_vector_capacity(&cv), capacity);
+
+    column_vector_free(&cv);
+}
+END_TEST
+
+/*
+ *                                   Resize.
+ */
+
+START_TEST(test_column_vector_reserve)
+{
+    ColumnField fields[NUM_COLS];
+    trade_columns(fields);
+
+    ColumnVector cv;
+    column_vector_create(&cv, sizeof(Trade), fields, NUM_COLS);
+
+    Trade trade = make_trade(1);
+    column_vector_push_back(&cv, &trade);
+
+    column_vector_reserve(&cv, 500);
+    ck_assert_uint_eq(column_vector_capacity(&cv), 500);
+    ck_assert_uint_eq(*(uint64_t*) column_vector_get(&cv, 0, COL_ID), 1);
+
+    column_vector_reserve(&cv, 10);
+    ck_assert_uint_eq(column_vector_capacity(&cv), 500);
+
+    column_vector_free(&cv);
+}
+END_TEST
+
+Suite* column_vector_suite(void)
+{
+    Suite* s = suite_create("ColumnVector");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_column_vector_create);
+    tcase_add_test(tc_core, test_column_vector_create_with_allocator);
+
+    /* Insertion. */
+    tcase_add_test(tc_core, test_column_vector_push_back);
+
+    /* Columns. */
+    tcase_add_test(tc_core, test_column_vector_column);
+    tcase_add_test(tc_core, test_column_vector_set);
+
+    /* Removal. */
+    tcase_add_test(tc_core, test_column_vector_pop_back_clear);
+
+    /* Resize. */
+    tcase_add_test(tc_core, test_column_vector_reserve);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = column_vector_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+static void trade_columns(ColumnField fields[NUM_COLS])
+{
+    fields[COL_ID] = COLUMN_FIELD(Trade, id);
+    fields[COL_TS] = COLUMN_FIELD(Trade, ts);
+    fields[COL_PRICE] = COLUMN_FIELD(Trade, price);
+    fields[COL_QTY] = COLUMN_FIELD(Trade, qty);
+}
+
+static Trade make_trade(uint64_t i)
+{
+    Trade trade = { i, -(int64_t) i, 0.5 * i, (uint32_t) i };
+    return trade;
+}
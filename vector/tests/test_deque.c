@@ -0,0 +1,260 @@
+#include "../src/deque.h"
+#include "../../common/src/arena.h"
+
+#include <check.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+static void ptr_free(void*);
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_deque_create)
+{
+    Deque d;
+    deque_create(&d, sizeof(int), NULL);
+
+    ck_assert_uint_eq(d.data_size, sizeof(int));
+    ck_assert_uint_eq(deque_size(&d), 0);
+    ck_assert_uint_eq(deque_capacity(&d), DEQUE_INIT_CAPACITY);
+    ck_assert(deque_is_empty(&d));
+
+    deque_free(&d);
+}
+END_TEST
+
+START_TEST(test_deque_create_with_allocator)
+{
+    Arena arena;
+    arena_create(&arena, 0);
+
+    Deque d;
+    deque_create_with_allocator(&d, sizeof(int), NULL,
+                                arena_allocator(&arena));
+
+    for (int i = 0; i < 100; ++i)
+        deque_push_front(&d, &i);
+    ck_assert_int_eq(*(int*) deque_back(&d), 0);
+
+    deque_free(&d);
+    arena_free(&arena);
+}
+END_TEST
+
+/*
+ *                                  Insertion.
+ */
+
+START_TEST(test_deque_push_back)
+{
+    Deque d;
+    deque_create(&d, sizeof(int), NULL);
+
+    for (int i = 0; i < 100; ++i)
+        deque_push_back(&d, &i);
+
+    ck_assert_uint_eq(deque_size(&d), 100);
+    ck_assert_uint_eq(deque_capacity(&d), 128);
+    for (int i = 0; i < 100; ++i)
+        ck_assert_int_eq(*(int*) deque_get(&d, i), i);
+
+    deque_free(&d);
+}
+END_TEST
+
+START_TEST(test_deque_push_front)
+{
+    Deque d;
+    deque_create(&d, sizeof(int), NULL);
+
+    for (int i = 0; i < 100; ++i)
+        deque_push_front(&d, &i);
+
+    ck_assert_uint_eq(deque_size(&d), 100);
+    ck_assert_int_eq(*(int*) deque_front(&d), 99);
+    ck_assert_int_eq(*(int*) deque_back(&d), 0);
+    for (int i = 0; i < 100; ++i)
+        ck_assert_int_eq(*(int*) deque_get(&d, i), 99 - i);
+
+    deque_free(&d);
+}
+END_TEST
+
+START_TEST(test_deque_grow_wrapped)
+{
+    Deque d;
+    deque_create(&d, sizeof(int), NULL);
+
+    /* Leave the buffer wrapped around its end, then force a grow. */
+    for (int i = 0; i < 3; ++i)
+        deque_push_back(&d, &i);
+    int value = -1;
+    deque_push_front(&d, &value);
+    ck_assert(deque_is_full(&d));
+
+    value = 3;
+    deque_push_back(&d, &value);
+    ck_assert_uint_eq(deque_capacity(&d), 2 * DEQUE_INIT_CAPACITY);
+
+    for (int i = 0; i < 5; ++i)
+        ck_assert_int_eq(*(int*) deque_get(&d, i), i - 1);
+
+    deque_free(&d);
+}
+END_TEST
+
+/*
+ *                                   Removal.
+ */
+
+START_TEST(test_deque_fifo)
+{
+    Deque d;
+    deque_create(&d, sizeof(int), NULL);
+
+    /* A steady-state queue stays at its capacity while head wraps. */
+    int next_in = 0, next_out = 0;
+    for (int round = 0; round < 1000; ++round) {
+        deque_push_back(&d, &next_in);
+        ++next_in;
+        deque_push_back(&d, &next_in);
+        ++next_in;
+        ck_assert_int_eq(*(int*) deque_pop_front(&d), next_out++);
+        if (deque_size(&d) > 5)
+            ck_assert_int_eq(*(int*) deque_pop_front(&d), next_out++);
+    }
+    ck_assert_uint_le(deque_capacity(&d), 8);
+
+    while (!deque_is_empty(&d))
+        ck_assert_int_eq(*(int*) deque_pop_front(&d), next_out++);
+    ck_assert_int_eq(next_out, next_in);
+
+    deque_free(&d);
+}
+END_TEST
+
+START_TEST(test_deque_pop_back)
+{
+    Deque d;
+    deque_create(&d, sizeof(int), NULL);
+
+    for (int i = 0; i < 10; ++i)
+        deque_push_front(&d, &i);
+    for (int i = 0; i < 10; ++i)
+        ck_assert_int_eq(*(int*) deque_pop_back(&d), i);
+    ck_assert(deque_is_empty(&d));
+
+    deque_free(&d);
+}
+END_TEST
+
+START_TEST(test_deque_set_clear)
+{
+    Deque d;
+    deque_create(&d, sizeof(int), NULL);
+
+    for (int i = 0; i < 10; ++i)
+        deque_push_front(&d, &i);
+
+    int value = 42;
+    deque_set(&d, 3, &value);
+    ck_assert_int_eq(*(int*) deque_get(&d, 3), 42);
+
+    size_t capacity = deque_capacity(&d);
+    deque_clear(&d);
+    ck_assert(deque_is_empty(&d));
+    ck_assert_uint_eq(deque_capacity(&d), capacity);
+
+    deque_free(&d);
+}
+END_TEST
+
+START_TEST(test_deque_free_func)
+{
+    Deque d;
+    deque_create(&d, sizeof(int*), ptr_free);
+
+    for (int i = 0; i < 20; ++i) {
+        int* p = malloc(sizeof(int));
+        *p = i;
+        if (i % 2)
+            deque_push_back(&d, &p);
+        else
+            deque_push_front(&d, &p);
+    }
+
+    /* Leak checkers flag any element free_func missed. */
+    deque_free(&d);
+}
+END_TEST
+
+/*
+ *                                   Resize.
+ */
+
+START_TEST(test_deque_reserve)
+{
+    Deque d;
+    deque_create(&d, sizeof(int), NULL);
+
+    for (int i = 0; i < 3; ++i)
+        deque_push_front(&d, &i);
+
+    deque_reserve(&d, 100);
+    ck_assert_uint_eq(deque_capacity(&d), 128);
+    for (int i = 0; i < 3; ++i)
+        ck_assert_int_eq(*(int*) deque_get(&d, i), 2 - i);
+
+    deque_reserve(&d, 10);
+    ck_assert_uint_eq(deque_capacity(&d), 128);
+
+    deque_free(&d);
+}
+END_TEST
+
+Suite* deque_suite(void)
+{
+    Suite* s = suite_create("Deque");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_deque_create);
+    tcase_add_test(tc_core, test_deque_create_with_allocator);
+
+    /* Insertion. */
+    tcase_add_test(tc_core, test_deque_push_back);
+    tcase_add_test(tc_core, test_deque_push_front);
+    tcase_add_test(tc_core, test_deque_grow_wrapped);
+
+    /* Removal. */
+    tcase_add_test(tc_core, test_deque_fifo);
+    tcase_add_test(tc_core, test_deque_pop_back);
+    tcase_add_test(tc_core, test_deque_set_clear);
+    tcase_add_test(tc_core, test_deque_free_func);
+
+    /* Resize. */
+    tcase_add_test(tc_core, test_deque_reserve);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = deque_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+static void ptr_free(void* p)
+{
+    free(*(void**) p);
+}
@@ -0,0 +1,286 @@
+#include "../src/flat_map.h"
+#include "../../common/src/arena.h"
+
+#include <check.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define NUM_KEYS  1000
+
+static int int_cmp(const void*, const void*);
+static int u64_cmp(const void*, const void*);
+
+static bool is_sorted_map(const FlatMap* map);
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_flat_map_create)
+{
+    FlatMap map;
+    flat_map_create(&map, sizeof(int), sizeof(double), int_cmp);
+
+    ck_assert_uint_eq(map.keys.data_size, sizeof(int));
+    ck_assert_uint_eq(map.values.data_size, sizeof(double));
+    ck_assert_uint_eq(flat_map_size(&map), 0);
+    ck_assert(flat_map_is_empty(&map));
+
+    int key = 1;
+    ck_assert_ptr_eq(flat_map_get(&map, &key), NULL);
+
+    flat_map_free(&map);
+}
+END_TEST
+
+START_TEST(test_flat_map_create_with_allocator)
+{
+    Arena arena;
+    arena_create(&arena, 0);
+
+    FlatMap map;
+    flat_map_create_with_allocator(&map, sizeof(int), sizeof(int), int_cmp,
+                                   arena_allocator(&arena));
+
+    for (int i = 99; i >= 0; --i)
+        flat_map_put(&map, &i, &i);
+    ck_assert_uint_eq(flat_map_size(&map), 100);
+    ck_assert_int_eq(*(int*) flat_map_key_at(&map, 0), 0);
+
+    flat_map_free(&map);
+    arena_free(&arena);
+}
+END_TEST
+
+/*
+ *                                 Insertion.
+ */
+
+START_TEST(test_flat_map_put_get)
+{
+    FlatMap map;
+    flat_map_create(&map, sizeof(int), sizeof(int), int_cmp);
+
+    /* Every key in [0, NUM_KEYS), scattered. */
+    for (int i = 0; i < NUM_KEYS; ++i) {
+        int key = (i * 7919) % NUM_KEYS, value = key * 2;
+        ck_assert(flat_map_put(&map, &key, &value));
+    }
+    ck_assert_uint_eq(flat_map_size(&map), NUM_KEYS);
+    ck_assert(is_sorted_map(&map));
+
+    for (int key = 0; key < NUM_KEYS; ++key) {
+        int* value = flat_map_get(&map, &key);
+        ck_assert_ptr_ne(value, NULL);
+        ck_assert_int_eq(*value, key * 2);
+        ck_assert_uint_eq(flat_map_find(&map, &key), (size_t) key);
+    }
+
+    int key = NUM_KEYS, minus = -1;
+    ck_assert(!flat_map_contains(&map, &key));
+    ck_assert(!flat_map_contains(&map, &minus));
+
+    /* Overwrite. */
+    int value = -5;
+    key = 10;
+    ck_assert(!flat_map_put(&map, &key, &value));
+    ck_assert_int_eq(*(int*) flat_map_get(&map, &key), -5);
+    ck_assert_uint_eq(flat_map_size(&map), NUM_KEYS);
+
+    flat_map_free(&map);
+}
+END_TEST
+
+START_TEST(test_flat_map_load)
+{
+    static const int keys[]   = { 5, 3, 9, 3, 1, 7, 9, 0 };
+    static const int values[] = { 50, 30, 90, 30, 10, 70, 90, 0 };
+    static const int sorted[] = { 0, 1, 3, 5, 7, 9 };
+
+    FlatMap map;
+    flat_map_create(&map, sizeof(int), sizeof(int), int_cmp);
+
+    int key = 100;
+    flat_map_put(&map, &key, &key);
+    flat_map_load(&map, keys, values, sizeof(keys) / sizeof(keys[0]));
+
+    /* Loading replaces the contents and drops duplicate keys. */
+    ck_assert_uint_eq(flat_map_size(&map), 6);
+    ck_assert(!flat_map_contains(&map, &key));
+    for (size_t i = 0; i < 6; ++i) {
+        ck_assert_int_eq(*(int*) flat_map_key_at(&map, i), sorted[i]);
+        ck_assert_int_eq(*(int*) flat_map_value_at(&map, i), sorted[i] * 10);
+    }
+
+    flat_map_free(&map);
+}
+END_TEST
+
+START_TEST(test_flat_map_load_large)
+{
+    static uint64_t keys[NUM_KEYS];
+    static uint32_t values[NUM_KEYS];
+
+    srand(1);
+    for (size_t i = 0; i < NUM_KEYS; ++i) {
+        keys[i] = (uint64_t) rand() % (NUM_KEYS / 2);
+        values[i] = (uint32_t) keys[i] + 1;
+    }
+
+    /* 12-byte pairs: records are padded to keep the keys aligned. */
+    FlatMap map;
+    flat_map_create(&map, sizeof(uint64_t), sizeof(uint32_t), u64_cmp);
+    flat_map_load(&map, keys, values, NUM_KEYS);
+
+    ck_assert(is_sorted_map(&map));
+    for (size_t i = 0; i < NUM_KEYS; ++i)
+        ck_assert_uint_eq(*(uint32_t*) flat_map_get(&map, &keys[i]),
+                          keys[i] + 1);
+    for (size_t i = 0; i < flat_map_size(&map); ++i)
+        ck_assert_uint_eq(*(uint32_t*) flat_map_value_at(&map, i),
+                          *(uint64_t*) flat_map_key_at(&map, i) + 1);
+
+    flat_map_free(&map);
+}
+END_TEST
+
+START_TEST(test_flat_map_insert_n)
+{
+    FlatMap map;
+    flat_map_create(&map, sizeof(int), sizeof(int), int_cmp);
+
+    /* Even keys first, then a batch of every third key over them. */
+    int keys[NUM_KEYS], values[NUM_KEYS];
+    size_t count = 0;
+    for (int i = 0; i < NUM_KEYS; i += 2) {
+        keys[count] = i;
+        values[count++] = 0;
+    }
+    flat_map_load(&map, keys, values, count);
+
+    count = 0;
+    for (int i = NUM_KEYS - 1; i >= 0; --i) {
+        if (i % 3 == 0) {
+            keys[count] = i;
+            values[count++] = 1;
+        }
+    }
+    flat_map_insert_n(&map, keys, values, count);
+    ck_assert(is_sorted_map(&map));
+
+    size_t expected = 0;
+    for (int key = 0; key < NUM_KEYS; ++key) {
+        int* value = flat_map_get(&map, &key);
+        if (key % 3 == 0) {
+            /* The batch wins over existing keys. */
+            ck_assert_ptr_ne(value, NULL);
+            ck_assert_int_eq(*value, 1);
+        } else if (key % 2 == 0) {
+            ck_assert_ptr_ne(value, NULL);
+            ck_assert_int_eq(*value, 0);
+        } else {
+            ck_assert_ptr_eq(value, NULL);
+        }
+        expected += (key % 2 == 0 || key % 3 == 0);
+    }
+    ck_assert_uint_eq(flat_map_size(&map), expected);
+
+    /* An empty batch changes nothing. */
+    flat_map_insert_n(&map, keys, values, 0);
+    ck_assert_uint_eq(flat_map_size(&map), expected);
+
+    flat_map_free(&map);
+}
+END_TEST
+
+/*
+ *                                  Removal.
+ */
+
+START_TEST(test_flat_map_erase)
+{
+    FlatMap map;
+    flat_map_create(&map, sizeof(int), sizeof(int), int_cmp);
+
+    for (int i = 0; i < 100; ++i)
+        flat_map_put(&map, &i, &i);
+    for (int i = 0; i < 100; i += 2)
+        ck_assert(flat_map_erase(&map, &i));
+
+    int key = 0;
+    ck_assert(!flat_map_erase(&map, &key));
+    ck_assert_uint_eq(flat_map_size(&map), 50);
+    ck_assert(is_sorted_map(&map));
+    for (int i = 0; i < 100; ++i)
+        ck_assert(flat_map_contains(&map, &i) == (i % 2 == 1));
+
+    flat_map_clear(&map);
+    ck_assert(flat_map_is_empty(&map));
+
+    flat_map_free(&map);
+}
+END_TEST
+
+Suite* flat_map_suite(void)
+{
+    Suite* s = suite_create("FlatMap");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_flat_map_create);
+    tcase_add_test(tc_core, test_flat_map_create_with_allocator);
+
+    /* Insertion. */
+    tcase_add_test(tc_core, test_flat_map_put_get);
+    tcase_add_test(tc_core, test_flat_map_load);
+    tcase_add_test(tc_core, test_flat_map_load_large);
+    tcase_add_test(tc_core, test_flat_map_insert_n);
+
+    /* Removal. */
+    tcase_add_test(tc_core, test_flat_map_erase);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = flat_map_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+static int int_cmp(const void* a, const void* b)
+{
+    int x = *(const int*) a, y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+static int u64_cmp(const void* a, const void* b)
+{
+    uint64_t x = *(const uint64_t*) a, y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Keys strictly increasing, and as many values as keys.
+ */
+static bool is_sorted_map(const FlatMap* map)
+{
+    if (vector_size(&map->values) != flat_map_size(map))
+        return false;
+
+    for (size_t i = 1; i < flat_map_size(map); ++i) {
+        if (map->cmp_func(flat_map_key_at(map, i - 1),
+                          flat_map_key_at(map, i)) >= 0)
+            return false;
+    }
+    return true;
+}
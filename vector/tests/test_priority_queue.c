@@ -0,0 +1,310 @@
+#include "../src/priority_queue.h"
+#include "../../common/src/arena.h"
+
+#include <check.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define NUM_ELEMS  1000
+
+typedef struct {
+    int64_t key;
+    int64_t payload;
+} Pair;
+
+static int int_cmp(const void*, const void*);
+static int int_cmp_reverse(const void*, const void*);
+static int pair_cmp(const void*, const void*);
+
+static void random_ints(int* array, size_t count, unsigned seed);
+
+static bool pops_sorted(PriorityQueue* pq, int* sorted, size_t count);
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_pq_create)
+{
+    PriorityQueue pq;
+    pq_create(&pq, sizeof(int), NULL, int_cmp, 0);
+
+    ck_assert_uint_eq(pq.v.data_size, sizeof(int));
+    ck_assert_uint_eq(pq.arity, PQ_DEFAULT_ARITY);
+    ck_assert_uint_eq(pq_size(&pq), 0);
+    ck_assert(pq_is_empty(&pq));
+
+    pq_free(&pq);
+}
+END_TEST
+
+START_TEST(test_pq_create_with_allocator)
+{
+    Arena arena;
+    arena_create(&arena, 0);
+
+    PriorityQueue pq;
+    pq_create_with_allocator(&pq, sizeof(int), NULL, int_cmp, 0,
+                             arena_allocator(&arena));
+
+    for (int i = 99; i >= 0; --i)
+        pq_push(&pq, &i);
+    ck_assert_int_eq(*(int*) pq_peek(&pq), 0);
+
+    pq_free(&pq);
+    arena_free(&arena);
+}
+END_TEST
+
+START_TEST(test_pq_from_vector)
+{
+    int array[NUM_ELEMS];
+    random_ints(array, NUM_ELEMS, 1);
+
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+    vector_append_array(&v, array, NUM_ELEMS);
+
+    PriorityQueue pq;
+    pq_from_vector(&pq, &v, int_cmp, 0);
+    ck_assert_uint_eq(pq_size(&pq), NUM_ELEMS);
+
+    qsort(array, NUM_ELEMS, sizeof(int), int_cmp);
+    ck_assert(pops_sorted(&pq, array, NUM_ELEMS));
+
+    pq_free(&pq);
+}
+END_TEST
+
+/*
+ *                                 Insertion.
+ */
+
+START_TEST(test_pq_push_peek)
+{
+    static const int values[] = { 5, 3, 8, 1, 9, 1, 0, 7 };
+    static const int mins[]   = { 5, 3, 3, 1, 1, 1, 0, 0 };
+
+    PriorityQueue pq;
+    pq_create(&pq, sizeof(int), NULL, int_cmp, 0);
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        pq_push(&pq, &values[i]);
+        ck_assert_int_eq(*(int*) pq_peek(&pq), mins[i]);
+    }
+    ck_assert_uint_eq(pq_size(&pq), 8);
+
+    pq_free(&pq);
+}
+END_TEST
+
+START_TEST(test_pq_push_n)
+{
+    int array[NUM_ELEMS];
+    random_ints(array, NUM_ELEMS, 2);
+
+    PriorityQueue pq;
+    pq_create(&pq, sizeof(int), NULL, int_cmp, 0);
+
+    /* A large batch heapifies, a small one sifts each element up. */
+    pq_push_n(&pq, array, NUM_ELEMS - 10);
+    pq_push_n(&pq, array + NUM_ELEMS - 10, 10);
+    ck_assert_uint_eq(pq_size(&pq), NUM_ELEMS);
+
+    qsort(array, NUM_ELEMS, sizeof(int), int_cmp);
+    ck_assert(pops_sorted(&pq, array, NUM_ELEMS));
+
+    pq_free(&pq);
+}
+END_TEST
+
+/*
+ *                                  Removal.
+ */
+
+START_TEST(test_pq_pop)
+{
+    int array[NUM_ELEMS];
+    random_ints(array, NUM_ELEMS, 3);
+
+    PriorityQueue pq;
+    pq_create(&pq, sizeof(int), NULL, int_cmp, 0);
+
+    for (size_t i = 0; i < NUM_ELEMS; ++i)
+        pq_push(&pq, &array[i]);
+
+    qsort(array, NUM_ELEMS, sizeof(int), int_cmp);
+    ck_assert(pops_sorted(&pq, array, NUM_ELEMS));
+    ck_assert(pq_is_empty(&pq));
+
+    pq_free(&pq);
+}
+END_TEST
+
+START_TEST(test_pq_pop_interleaved)
+{
+    PriorityQueue pq;
+    pq_create(&pq, sizeof(int), NULL, int_cmp, 0);
+
+    for (int i = 0; i < 100; ++i) {
+        int a = 2 * i + 1, b = 2 * i;
+        pq_push(&pq, &a);
+        pq_push(&pq, &b);
+        ck_assert_int_eq(*(int*) pq_pop(&pq), i);
+    }
+    for (int i = 100; i < 200; ++i)
+        ck_assert_int_eq(*(int*) pq_pop(&pq), i);
+
+    pq_clear(&pq);
+    ck_assert(pq_is_empty(&pq));
+
+    pq_free(&pq);
+}
+END_TEST
+
+START_TEST(test_pq_max_heap)
+{
+    int array[NUM_ELEMS];
+    random_ints(array, NUM_ELEMS, 4);
+
+    PriorityQueue pq;
+    pq_create(&pq, sizeof(int), NULL, int_cmp_reverse, 0);
+    pq_push_n(&pq, array, NUM_ELEMS);
+
+    qsort(array, NUM_ELEMS, sizeof(int), int_cmp_reverse);
+    ck_assert(pops_sorted(&pq, array, NUM_ELEMS));
+
+    pq_free(&pq);
+}
+END_TEST
+
+/*
+ *                                   Arity.
+ */
+
+START_TEST(test_pq_arity)
+{
+    static const size_t arities[] = { 2, 3, 8, 16 };
+    int array[NUM_ELEMS];
+
+    for (size_t a = 0; a < sizeof(arities) / sizeof(arities[0]); ++a) {
+        random_ints(array, NUM_ELEMS, 5 + a);
+
+        PriorityQueue pq;
+        pq_create(&pq, sizeof(int), NULL, int_cmp, arities[a]);
+        ck_assert_uint_eq(pq.arity, arities[a]);
+
+        for (size_t i = 0; i < NUM_ELEMS / 2; ++i)
+            pq_push(&pq, &array[i]);
+        pq_push_n(&pq, array + NUM_ELEMS / 2, NUM_ELEMS / 2);
+
+        qsort(array, NUM_ELEMS, sizeof(int), int_cmp);
+        ck_assert(pops_sorted(&pq, array, NUM_ELEMS));
+
+        pq_free(&pq);
+    }
+}
+END_TEST
+
+START_TEST(test_pq_cache_lines)
+{
+    PriorityQueue pq;
+    pq_create(&pq, sizeof(Pair), NULL, pair_cmp, 4);
+
+    for (int64_t i = 0; i < NUM_ELEMS; ++i) {
+        Pair pair = { (i * 7919) % NUM_ELEMS, i };
+        pq_push(&pq, &pair);
+    }
+
+    /* The children of each element share one 64-byte line. */
+    uintptr_t root = (uintptr_t) pq_peek(&pq);
+    for (size_t k = 0; 4 * k + 1 < pq_size(&pq); ++k) {
+        uintptr_t first = root + (4 * k + 1) * sizeof(Pair);
+        uintptr_t last = root + (4 * k + 4) * sizeof(Pair) - 1;
+        ck_assert_uint_eq(first % 64, 0);
+        ck_assert_uint_eq(first / 64, last / 64);
+    }
+
+    for (int64_t i = 0; i < NUM_ELEMS; ++i)
+        ck_assert_int_eq(((Pair*) pq_pop(&pq))->key, i);
+
+    pq_free(&pq);
+}
+END_TEST
+
+Suite* priority_queue_suite(void)
+{
+    Suite* s = suite_create("PriorityQueue");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_pq_create);
+    tcase_add_test(tc_core, test_pq_create_with_allocator);
+    tcase_add_test(tc_core, test_pq_from_vector);
+
+    /* Insertion. */
+    tcase_add_test(tc_core, test_pq_push_peek);
+    tcase_add_test(tc_core, test_pq_push_n);
+
+    /* Removal. */
+    tcase_add_test(tc_core, test_pq_pop);
+    tcase_add_test(tc_core, test_pq_pop_interleaved);
+    tcase_add_test(tc_core, test_pq_max_heap);
+
+    /* Arity. */
+    tcase_add_test(tc_core, test_pq_arity);
+    tcase_add_test(tc_core, test_pq_cache_lines);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = priority_queue_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+static int int_cmp(const void* a, const void* b)
+{
+    int x = *(const int*) a, y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+static int int_cmp_reverse(const void* a, const void* b)
+{
+    return int_cmp(b, a);
+}
+
+static int pair_cmp(const void* a, const void* b)
+{
+    int64_t x = ((const Pair*) a)->key, y = ((const Pair*) b)->key;
+    return (x > y) - (x < y);
+}
+
+static void random_ints(int* array, size_t count, unsigned seed)
+{
+    srand(seed);
+    for (size_t i = 0; i < count; ++i)
+        array[i] = rand() % (int) count;
+}
+
+/*
+ * Pops count elements and checks them against sorted.
+ */
+static bool pops_sorted(PriorityQueue* pq, int* sorted, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (*(int*) pq_pop(pq) != sorted[i])
+            return false;
+    }
+    return true;
+}
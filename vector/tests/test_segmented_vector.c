@@ -0,0 +1,224 @@
+#include "../src/segmented_vector.h"
+
+#include <check.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define NUM_WRITERS       4
+#define ITEMS_PER_WRITER  50000
+
+typedef struct {
+    uint32_t writer;
+    uint32_t seq;
+} Entry;
+
+typedef struct {
+    SegmentedVector* sv;
+    uint32_t writer;
+} WriterArg;
+
+typedef struct {
+    SegmentedVector* sv;
+    size_t max_seen;
+    bool valid;
+} ReaderArg;
+
+static void* writer_main(void*);
+static void* reader_main(void*);
+
+static void ptr_free(void*);
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_segmented_vector_create)
+{
+    SegmentedVector sv;
+    segmented_vector_create(&sv, sizeof(int), NULL);
+
+    ck_assert_uint_eq(sv.data_size, sizeof(int));
+    ck_assert_uint_eq(segmented_vector_size(&sv), 0);
+    ck_assert(segmented_vector_is_empty(&sv));
+
+    segmented_vector_free(&sv);
+}
+END_TEST
+
+/*
+ *                                  Insertion.
+ */
+
+START_TEST(test_segmented_vector_push_back)
+{
+    SegmentedVector sv;
+    segmented_vector_create(&sv, sizeof(int), NULL);
+
+    /* Crosses the first several segment boundaries (32, 96, 224, ...). */
+    for (int i = 0; i < 5000; ++i)
+        ck_assert_uint_eq(segmented_vector_push_back(&sv, &i), i);
+
+    ck_assert_uint_eq(segmented_vector_size(&sv), 5000);
+    for (int i = 0; i < 5000; ++i)
+        ck_assert_int_eq(*(int*) segmented_vector_get(&sv, i), i);
+
+    segmented_vector_free(&sv);
+}
+END_TEST
+
+START_TEST(test_segmented_vector_stable_addresses)
+{
+    SegmentedVector sv;
+    segmented_vector_create(&sv, sizeof(int), NULL);
+
+    int* pointers[100];
+    for (int i = 0; i < 100; ++i) {
+        segmented_vector_push_back(&sv, &i);
+        pointers[i] = segmented_vector_get(&sv, i);
+    }
+
+    for (int i = 100; i < 100000; ++i)
+        segmented_vector_push_back(&sv, &i);
+
+    for (int i = 0; i < 100; ++i) {
+        ck_assert_ptr_eq(segmented_vector_get(&sv, i), pointers[i]);
+        ck_assert_int_eq(*pointers[i], i);
+    }
+
+    segmented_vector_free(&sv);
+}
+END_TEST
+
+START_TEST(test_segmented_vector_free_func)
+{
+    SegmentedVector sv;
+    segmented_vector_create(&sv, sizeof(int*), ptr_free);
+
+    for (int i = 0; i < 100; ++i) {
+        int* p = malloc(sizeof(int));
+        *p = i;
+        segmented_vector_push_back(&sv, &p);
+    }
+    ck_assert_int_eq(**(int**) segmented_vector_get(&sv, 99), 99);
+
+    /* Leak checkers flag any element free_func missed. */
+    segmented_vector_free(&sv);
+}
+END_TEST
+
+/*
+ *                                 Concurrency.
+ */
+
+START_TEST(test_segmented_vector_concurrent)
+{
+    SegmentedVector sv;
+    segmented_vector_create(&sv, sizeof(Entry), NULL);
+
+    pthread_t writers[NUM_WRITERS], reader;
+    WriterArg writer_args[NUM_WRITERS];
+    ReaderArg reader_arg = { &sv, 0, true };
+
+    pthread_create(&reader, NULL, reader_main, &reader_arg);
+    for (uint32_t w = 0; w < NUM_WRITERS; ++w) {
+        writer_args[w] = (WriterArg) { &sv, w };
+        pthread_create(&writers[w], NULL, writer_main, &writer_args[w]);
+    }
+    for (size_t w = 0; w < NUM_WRITERS; ++w)
+        pthread_join(writers[w], NULL);
+    pthread_join(reader, NULL);
+
+    size_t total = (size_t) NUM_WRITERS * ITEMS_PER_WRITER;
+    ck_assert_uint_eq(segmented_vector_size(&sv), total);
+    ck_assert(reader_arg.valid);
+
+    /* Every writer's entries are all present, in the order it wrote them. */
+    uint32_t next[NUM_WRITERS] = { 0 };
+    for (size_t i = 0; i < total; ++i) {
+        const Entry* entry = segmented_vector_get(&sv, i);
+        ck_assert_uint_lt(entry->writer, NUM_WRITERS);
+        ck_assert_uint_eq(entry->seq, next[entry->writer]);
+        ++next[entry->writer];
+    }
+    for (size_t w = 0; w < NUM_WRITERS; ++w)
+        ck_assert_uint_eq(next[w], ITEMS_PER_WRITER);
+
+    segmented_vector_free(&sv);
+}
+END_TEST
+
+Suite* segmented_vector_suite(void)
+{
+    Suite* s = suite_create("SegmentedVector");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_segmented_vector_create);
+
+    /* Insertion. */
+    tcase_add_test(tc_core, test_segmented_vector_push_back);
+    tcase_add_test(tc_core, test_segmented_vector_stable_addresses);
+    tcase_add_test(tc_core, test_segmented_vector_free_func);
+
+    /* Concurrency. */
+    tcase_add_test(tc_core, test_segmented_vector_concurrent);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = segmented_vector_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+static void* writer_main(void* arg_ptr)
+{
+    WriterArg* arg = arg_ptr;
+
+    for (uint32_t seq = 0; seq < ITEMS_PER_WRITER; ++seq) {
+        Entry entry = { arg->writer, seq };
+        segmented_vector_push_back(arg->sv, &entry);
+    }
+    return NULL;
+}
+
+/*
+ * Scans the published prefix while writers append, checking that every
+ * visible entry is fully written.
+ */
+static void* reader_main(void* arg_ptr)
+{
+    ReaderArg* arg = arg_ptr;
+    size_t total = (size_t) NUM_WRITERS * ITEMS_PER_WRITER;
+
+    while (arg->max_seen < total) {
+        size_t size = segmented_vector_size(arg->sv);
+        if (size == arg->max_seen)
+            sched_yield();
+        for (size_t i = arg->max_seen; i < size; ++i) {
+            const Entry* entry = segmented_vector_get(arg->sv, i);
+            if (entry->writer >= NUM_WRITERS ||
+                entry->seq >= ITEMS_PER_WRITER)
+                arg->valid = false;
+        }
+        arg->max_seen = size;
+    }
+    return NULL;
+}
+
+static void ptr_free(void* p)
+{
+    free(*(void**) p);
+}
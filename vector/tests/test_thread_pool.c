@@ -0,0 +1,228 @@
+#include "../src/thread_pool.h"
+
+#include <check.h>
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define NUM_WORKERS  4
+#define RANGE_SIZE   10000
+
+typedef struct {
+    _Atomic int* visits;
+    size_t grain;
+    size_t align;
+    size_t align_base;
+    size_t num_workers;
+    _Atomic size_t calls;
+    _Atomic size_t bad_ranges;
+} Visits;
+
+static void visit_range(void* ctx, size_t begin, size_t end, size_t worker);
+
+static void visits_create(Visits* visits, size_t grain, size_t align,
+                          size_t align_base, size_t num_workers);
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_thread_pool_create)
+{
+    ThreadPool pool;
+    thread_pool_create(&pool, NUM_WORKERS);
+
+    ck_assert_uint_eq(thread_pool_size(&pool), NUM_WORKERS);
+
+    thread_pool_free(&pool);
+}
+END_TEST
+
+START_TEST(test_thread_pool_create_zero)
+{
+    ThreadPool pool;
+    thread_pool_create(&pool, 0);
+
+    ck_assert_uint_eq(thread_pool_size(&pool), 1);
+
+    thread_pool_free(&pool);
+}
+END_TEST
+
+START_TEST(test_thread_pool_default)
+{
+    ThreadPool* pool = thread_pool_default();
+
+    ck_assert_ptr_ne(pool, NULL);
+    ck_assert_ptr_eq(pool, thread_pool_default());
+    ck_assert_uint_ge(thread_pool_size(pool), 1);
+}
+END_TEST
+
+/*
+ *                                 Execution.
+ */
+
+START_TEST(test_thread_pool_for)
+{
+    ThreadPool pool;
+    thread_pool_create(&pool, NUM_WORKERS);
+
+    Visits visits;
+    visits_create(&visits, 16, 1, 0, NUM_WORKERS);
+
+    thread_pool_for(&pool, 0, RANGE_SIZE, 16, 1, 0, visit_range, &visits);
+
+    for (size_t i = 0; i < RANGE_SIZE; ++i)
+        ck_assert_int_eq(visits.visits[i], 1);
+    ck_assert_uint_eq(visits.bad_ranges, 0);
+    ck_assert_uint_ge(visits.calls, RANGE_SIZE / 16);
+
+    free(visits.visits);
+    thread_pool_free(&pool);
+}
+END_TEST
+
+START_TEST(test_thread_pool_for_aligned)
+{
+    ThreadPool pool;
+    thread_pool_create(&pool, NUM_WORKERS);
+
+    Visits visits;
+    visits_create(&visits, 100, 16, 3, NUM_WORKERS);
+
+    thread_pool_for(&pool, 0, RANGE_SIZE, 100, 16, 3, visit_range, &visits);
+
+    for (size_t i = 0; i < RANGE_SIZE; ++i)
+        ck_assert_int_eq(visits.visits[i], 1);
+    ck_assert_uint_eq(visits.bad_ranges, 0);
+
+    free(visits.visits);
+    thread_pool_free(&pool);
+}
+END_TEST
+
+START_TEST(test_thread_pool_for_repeated)
+{
+    ThreadPool pool;
+    thread_pool_create(&pool, NUM_WORKERS);
+
+    Visits visits;
+    visits_create(&visits, 1, 1, 0, NUM_WORKERS);
+
+    for (int round = 0; round < 100; ++round)
+        thread_pool_for(&pool, 0, 64, 1, 1, 0, visit_range, &visits);
+
+    for (size_t i = 0; i < 64; ++i)
+        ck_assert_int_eq(visits.visits[i], 100);
+    ck_assert_uint_eq(visits.calls, 6400);
+    ck_assert_uint_eq(visits.bad_ranges, 0);
+
+    free(visits.visits);
+    thread_pool_free(&pool);
+}
+END_TEST
+
+START_TEST(test_thread_pool_for_empty)
+{
+    ThreadPool pool;
+    thread_pool_create(&pool, NUM_WORKERS);
+
+    Visits visits;
+    visits_create(&visits, 1, 1, 0, NUM_WORKERS);
+
+    thread_pool_for(&pool, 10, 10, 1, 1, 0, visit_range, &visits);
+    ck_assert_uint_eq(visits.calls, 0);
+
+    free(visits.visits);
+    thread_pool_free(&pool);
+}
+END_TEST
+
+START_TEST(test_thread_pool_for_single_worker)
+{
+    ThreadPool pool;
+    thread_pool_create(&pool, 1);
+
+    Visits visits;
+    visits_create(&visits, 7, 1, 0, 1);
+
+    thread_pool_for(&pool, 5, RANGE_SIZE, 7, 1, 0, visit_range, &visits);
+
+    for (size_t i = 0; i < RANGE_SIZE; ++i)
+        ck_assert_int_eq(visits.visits[i], i >= 5);
+    ck_assert_uint_eq(visits.bad_ranges, 0);
+
+    free(visits.visits);
+    thread_pool_free(&pool);
+}
+END_TEST
+
+Suite* thread_pool_suite(void)
+{
+    Suite* s = suite_create("ThreadPool");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_thread_pool_create);
+    tcase_add_test(tc_core, test_thread_pool_create_zero);
+    tcase_add_test(tc_core, test_thread_pool_default);
+
+    /* Execution. */
+    tcase_add_test(tc_core, test_thread_pool_for);
+    tcase_add_test(tc_core, test_thread_pool_for_aligned);
+    tcase_add_test(tc_core, test_thread_pool_for_repeated);
+    tcase_add_test(tc_core, test_thread_pool_for_empty);
+    tcase_add_test(tc_core, test_thread_pool_for_single_worker);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = thread_pool_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+/*
+ * Marks each index as visited and counts ranges that break the loop's
+ * grain or split alignment. Runs on pool threads, so it does not assert.
+ */
+static void visit_range(void* ctx, size_t begin, size_t end, size_t worker)
+{
+    Visits* visits = ctx;
+    bool bad = begin >= end || worker >= visits->num_workers;
+
+    /* Only an unsplittable range may exceed the grain. */
+    if (end - begin > visits->grain && visits->align == 1)
+        bad = true;
+    if (begin > visits->align_base &&
+        (begin - visits->align_base) % visits->align != 0)
+        bad = true;
+
+    if (bad)
+        atomic_fetch_add(&visits->bad_ranges, 1);
+    for (size_t i = begin; i < end; ++i)
+        atomic_fetch_add(&visits->visits[i], 1);
+    atomic_fetch_add(&visits->calls, 1);
+}
+
+static void visits_create(Visits* visits, size_t grain, size_t align,
+                          size_t align_base, size_t num_workers)
+{
+    visits->visits = calloc(RANGE_SIZE, sizeof(*visits->visits));
+    visits->grain = grain;
+    visits->align = align;
+    visits->align_base = align_base;
+    visits->num_workers = num_workers;
+    atomic_init(&visits->calls, 0);
+    atomic_init(&visits->bad_ranges, 0);
+}
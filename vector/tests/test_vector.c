@@ -1,13 +1,72 @@
 #include "../src/vector.h"
+#include "../../common/src/arena.h"
+#include "../../common/src/stream.h"
 
 #include <check.h>
 
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 #define INIT_CAPACITY  4
 
+/* Squares each element modulo 1000, or writes -1 if pos was wrong. */
+static void int_square(void* first, size_t count, size_t pos, void* ctx)
+{
+    int* values = first;
+    (void) ctx;
+
+    for (size_t i = 0; i < count; ++i) {
+        int m = values[i] % 1000;
+        values[i] = (values[i] == (int) (pos + i)) ? m * m : -1;
+    }
+}
+
+static void int_sum(void* acc, const void* first, size_t count, void* ctx)
+{
+    const int* values = first;
+    (void) ctx;
+
+    for (size_t i = 0; i < count; ++i)
+        *(int64_t*) acc += values[i];
+}
+
+static void int64_add(void* acc, const void* other, void* ctx)
+{
+    (void) ctx;
+    *(int64_t*) acc += *(const int64_t*) other;
+}
+
+static void count_in_ctx(void* acc, const void* first, size_t count,
+                         void* ctx)
+{
+    (void) acc;
+    (void) first;
+    atomic_fetch_add((_Atomic size_t*) ctx, count);
+}
+
+static void combine_nothing(void* acc, const void* other, void* ctx)
+{
+    (void) acc;
+    (void) other;
+    (void) ctx;
+}
+
 static void vector_fill_up_to(Vector* v, int limit);
 static int int_cmp(const void*, const void*);
+static int record_cmp(const void*, const void*);
+static int byte_cmp(const void*, const void*);
+static void int_square(void* first, size_t count, size_t pos, void* ctx);
+static void int_sum(void* acc, const void* first, size_t count, void* ctx);
+static void int64_add(void* acc, const void* other, void* ctx);
+
+typedef struct {
+    int64_t key;
+    int64_t payload;
+} Record;
 
 /*
  *                                Construction.
@@ -27,6 +86,294 @@ START_TEST(test_vector_create)
 }
 END_TEST
 
+START_TEST(test_vector_create_with_allocator)
+{
+    Arena arena;
+    arena_create(&arena, 0);
+
+    Vector v;
+    vector_create_with_allocator(&v, sizeof(int), NULL,
+                                 arena_allocator(&arena));
+
+    ck_assert_ptr_eq(v.allocator, arena_allocator(&arena));
+
+    vector_fill_up_to(&v, 1000);
+    for (int i = 0; i < 1000; ++i)
+        ck_assert_int_eq(*(int*) vector_get(&v, i), i);
+
+    vector_free(&v);
+    arena_free(&arena);
+}
+END_TEST
+
+START_TEST(test_small_vector_create)
+{
+    SmallVector sv;
+    Vector* v = small_vector_create(&sv, sizeof(int), NULL);
+
+    ck_assert_uint_eq(vector_is_inline(v), true);
+    ck_assert_ptr_eq(v->buffer_ptr, sv.inline_buffer);
+    ck_assert_uint_eq(vector_capacity(v),
+                      SMALL_VECTOR_INLINE_BYTES / sizeof(int));
+
+    vector_fill_up_to(v, vector_capacity(v));
+    ck_assert_uint_eq(vector_is_inline(v), true);
+
+    /* One more element spills the buffer to the heap. */
+    vector_fill_up_to(v, 100);
+    ck_assert_uint_eq(vector_is_inline(v), false);
+    ck_assert_ptr_ne(v->buffer_ptr, sv.inline_buffer);
+    ck_assert_int_eq(*(int*) vector_get(v, 0), 0);
+
+    vector_free(v);
+}
+END_TEST
+
+START_TEST(test_vector_create_inline)
+{
+    int storage[3];
+
+    Vector v;
+    vector_create_inline(&v, sizeof(int), NULL, storage, sizeof(storage));
+
+    ck_assert_uint_eq(vector_capacity(&v), 3);
+
+    for (int i = 0; i < 10; ++i)
+        vector_push_back(&v, &i);
+
+    ck_assert_uint_eq(vector_is_inline(&v), false);
+    for (int i = 0; i < 10; ++i)
+        ck_assert_int_eq(*(int*) vector_get(&v, i), i);
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_mmap_threshold)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+    vector_set_mmap_threshold(&v, 4096);
+
+    vector_fill_up_to(&v, 100000);
+#ifdef __linux__
+    ck_assert_uint_eq(vector_is_mapped(&v), true);
+#endif
+    for (int i = 0; i < 100000; ++i)
+        ck_assert_int_eq(*(int*) vector_get(&v, i), i);
+
+    vector_resize(&v, 10);
+    ck_assert_uint_eq(vector_size(&v), 10);
+    ck_assert_int_eq(*(int*) vector_get(&v, 9), 9);
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_map_file)
+{
+#ifdef __linux__
+    char path[] = "/tmp/test_vector_XXXXXX";
+    close(mkstemp(path));
+
+    Vector v;
+    ck_assert_ptr_eq(vector_map_file(&v, path, sizeof(int),
+                                     VECTOR_MAP_READ_WRITE), &v);
+    ck_assert_uint_eq(vector_is_file_backed(&v), true);
+    ck_assert_uint_eq(vector_size(&v), 0);
+
+    vector_fill_up_to(&v, 1000);
+    vector_free(&v);
+
+    /* Reopening restores the contents without replaying the pushes. */
+    ck_assert_ptr_eq(vector_map_file(&v, path, sizeof(int), VECTOR_MAP_READ),
+                     &v);
+    ck_assert_uint_eq(vector_size(&v), 1000);
+    for (int i = 0; i < 1000; ++i)
+        ck_assert_int_eq(*(int*) vector_get(&v, i), i);
+    vector_free(&v);
+
+    /* A different element size is rejected. */
+    ck_assert_ptr_eq(vector_map_file(&v, path, sizeof(double),
+                                     VECTOR_MAP_READ_WRITE), NULL);
+
+    unlink(path);
+#endif
+}
+END_TEST
+
+START_TEST(test_vector_from_buffer)
+{
+    int* buffer = malloc(10 * sizeof(int));
+    for (int i = 0; i < 8; ++i)
+        buffer[i] = i;
+
+    Vector v;
+    vector_from_buffer(&v, buffer, 8, 10, sizeof(int), NULL);
+
+    ck_assert_ptr_eq(vector_data(&v), buffer);
+    ck_assert_uint_eq(vector_size(&v), 8);
+    ck_assert_uint_eq(vector_capacity(&v), 10);
+
+    /* The adopted buffer grows like any other. */
+    for (int i = 8; i < 100; ++i)
+        vector_push_back(&v, &i);
+    for (int i = 0; i < 100; ++i)
+        ck_assert_int_eq(*(int*) vector_get(&v, i), i);
+
+    vector_free(&v);
+}
+END_TEST
+
+/*
+ *                                Destruction.
+ */
+
+START_TEST(test_vector_release)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+    vector_fill_up_to(&v, 100);
+
+    void* data = vector_data(&v);
+    size_t size = 0;
+    int* buffer = vector_release(&v, &size);
+
+    ck_assert_ptr_eq(buffer, data);
+    ck_assert_uint_eq(size, 100);
+    ck_assert_ptr_eq(vector_data(&v), NULL);
+    for (int i = 0; i < 100; ++i)
+        ck_assert_int_eq(buffer[i], i);
+
+    /* Round trip through another vector without copying. */
+    Vector w;
+    vector_from_buffer(&w, buffer, size, size, sizeof(int), NULL);
+    ck_assert_ptr_eq(vector_data(&w), data);
+    vector_free(&w);
+}
+END_TEST
+
+START_TEST(test_vector_release_inline)
+{
+    SmallVector sv;
+    Vector* v = small_vector_create(&sv, sizeof(int), NULL);
+    vector_fill_up_to(v, 5);
+
+    size_t size = 0;
+    int* buffer = vector_release(v, &size);
+
+    /* Inline storage cannot be handed over, so it is copied. */
+    ck_assert_ptr_ne(buffer, sv.inline_buffer);
+    ck_assert_uint_eq(size, 5);
+    for (int i = 0; i < 5; ++i)
+        ck_assert_int_eq(buffer[i], i);
+
+    free(buffer);
+}
+END_TEST
+
+/*
+ *                               Serialization.
+ */
+
+START_TEST(test_vector_write_read)
+{
+    char path[] = "/tmp/test_vector_XXXXXX";
+    int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+    vector_fill_up_to(&v, 100000);
+
+    ck_assert(vector_write(&v, fd, true));
+    ck_assert(vector_write(&v, fd, false));
+    vector_free(&v);
+
+    lseek(fd, 0, SEEK_SET);
+    for (int round = 0; round < 2; ++round) {
+        ck_assert_ptr_eq(vector_read(&v, fd, sizeof(int), NULL), &v);
+        ck_assert_uint_eq(vector_size(&v), 100000);
+        for (int i = 0; i < 100000; ++i)
+            ck_assert_int_eq(*(int*) vector_get(&v, i), i);
+        vector_free(&v);
+    }
+
+    /* End of file. */
+    ck_assert_ptr_eq(vector_read(&v, fd, sizeof(int), NULL), NULL);
+
+    close(fd);
+    unlink(path);
+}
+END_TEST
+
+START_TEST(test_vector_read_corrupt)
+{
+    char path[] = "/tmp/test_vector_XXXXXX";
+    int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+    vector_fill_up_to(&v, 100);
+    ck_assert(vector_write(&v, fd, true));
+    vector_free(&v);
+
+    /* Wrong element size. */
+    lseek(fd, 0, SEEK_SET);
+    ck_assert_ptr_eq(vector_read(&v, fd, sizeof(double), NULL), NULL);
+
+    /* Overwrite one element: the checksum no longer matches. */
+    int bad = -1;
+    off_t offset = lseek(fd, 0, SEEK_END) - sizeof(uint32_t) - sizeof(int);
+    ck_assert_int_eq(pwrite(fd, &bad, sizeof(bad), offset), sizeof(bad));
+    lseek(fd, 0, SEEK_SET);
+    ck_assert_ptr_eq(vector_read(&v, fd, sizeof(int), NULL), NULL);
+
+    close(fd);
+    unlink(path);
+}
+END_TEST
+
+START_TEST(test_vector_read_hostile)
+{
+    StreamHeader header;
+    stream_header_create(&header, sizeof(int), SIZE_MAX / sizeof(int),
+                         false);
+    int elements[2] = { 1, 2 };
+    struct iovec iov[2] = {
+        { &header, sizeof(header) },
+        { elements, sizeof(elements) },
+    };
+    Vector v;
+
+    /* A count longer than the rest of the file. */
+    char path[] = "/tmp/test_vector_XXXXXX";
+    int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+    ck_assert(stream_write_all(fd, iov, 2));
+    lseek(fd, 0, SEEK_SET);
+    ck_assert_ptr_eq(vector_read(&v, fd, sizeof(int), NULL), NULL);
+
+    /* No element size to divide by. */
+    lseek(fd, 0, SEEK_SET);
+    ck_assert_ptr_eq(vector_read(&v, fd, 0, NULL), NULL);
+
+    close(fd);
+    unlink(path);
+
+    /* A pipe has no length: the stream runs dry long before the count. */
+    int fds[2];
+    ck_assert_int_eq(pipe(fds), 0);
+    iov[0] = (struct iovec) { &header, sizeof(header) };
+    iov[1] = (struct iovec) { elements, sizeof(elements) };
+    ck_assert(stream_write_all(fds[1], iov, 2));
+    close(fds[1]);
+    ck_assert_ptr_eq(vector_read(&v, fds[0], sizeof(int), NULL), NULL);
+    close(fds[0]);
+}
+END_TEST
+
 /*
  *                               Size/Capacity.
  */
@@ -153,6 +500,43 @@ START_TEST(test_vector_concat)
 }
 END_TEST
 
+START_TEST(test_vector_concat_self)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    vector_fill_up_to(&v, 100);
+
+    vector_concat(&v, &v);
+    ck_assert_uint_eq(vector_size(&v), 200);
+
+    for (int i = 0; i < 200; ++i)
+        ck_assert_int_eq(*(int*) vector_get(&v, i), i % 100);
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_append_array)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    int array[1000];
+    for (int i = 0; i < 1000; ++i)
+        array[i] = i;
+
+    vector_append_array(&v, array, 1000);
+    ck_assert_uint_eq(vector_size(&v), 1000);
+    ck_assert_uint_eq(vector_capacity(&v), 1024);
+
+    for (int i = 0; i < 1000; ++i)
+        ck_assert_int_eq(*(int*) vector_get(&v, i), i);
+
+    vector_free(&v);
+}
+END_TEST
+
 /*
  *                                  Equality.
  */
@@ -178,6 +562,72 @@ START_TEST(test_vector_equals)
 }
 END_TEST
 
+START_TEST(test_vector_equals_bytes)
+{
+    Vector v1, v2;
+    vector_create(&v1, sizeof(int), NULL);
+    vector_create(&v2, sizeof(int), NULL);
+
+    ck_assert_int_eq(vector_equals(&v1, &v2, NULL), true);
+
+    vector_fill_up_to(&v1, 100);
+    vector_fill_up_to(&v2, 100);
+
+    ck_assert_int_eq(vector_equals(&v1, &v2, NULL), true);
+
+    int data = 24;
+    vector_set(&v2, 99, &data);
+
+    ck_assert_int_eq(vector_equals(&v1, &v2, NULL), false);
+
+    vector_free(&v1);
+    vector_free(&v2);
+}
+END_TEST
+
+/*
+ *                                  Hashing.
+ */
+
+START_TEST(test_vector_hash)
+{
+    Vector v1, v2;
+    vector_create(&v1, sizeof(int), NULL);
+    vector_create(&v2, sizeof(int), NULL);
+
+    ck_assert_uint_eq(vector_hash(&v1, 0), vector_hash(&v2, 0));
+
+    /* Every length class: empty, 1-3, 4-16, 17-48 and striped bytes. */
+    for (int i = 0; i < 100; ++i) {
+        vector_push_back(&v1, &i);
+        vector_push_back(&v2, &i);
+        ck_assert_uint_eq(vector_hash(&v1, 7), vector_hash(&v2, 7));
+        ck_assert_uint_ne(vector_hash(&v1, 7), vector_hash(&v1, 8));
+    }
+
+    uint64_t hash = vector_hash(&v1, 0);
+    int data = 1000;
+    vector_set(&v2, 50, &data);
+    ck_assert_uint_ne(vector_hash(&v2, 0), hash);
+
+    vector_pop_back(&v1);
+    ck_assert_uint_ne(vector_hash(&v1, 0), hash);
+
+    Vector bytes;
+    vector_create(&bytes, 1, NULL);
+    uint64_t previous = vector_hash(&bytes, 0);
+    for (char c = 0; c < 3; ++c) {
+        vector_push_back(&bytes, &c);
+        ck_assert_uint_ne(vector_hash(&bytes, 0), previous);
+        previous = vector_hash(&bytes, 0);
+    }
+
+    vector_free(&v1);
+    vector_free(&v2);
+    vector_free(&bytes);
+}
+END_TEST
+
 /*
  *                                 Insertion.
  */
@@ -214,6 +664,49 @@ START_TEST(test_vector_insert)
 }
 END_TEST
 
+START_TEST(test_vector_insert_front)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    vector_fill_up_to(&v, 10);
+
+    int data = 24;
+    vector_insert(&v, 0, &data);
+
+    ck_assert_uint_eq(vector_size(&v), 11);
+    ck_assert_int_eq(*(int*) vector_get(&v, 0), data);
+    ck_assert_int_eq(*(int*) vector_get(&v, 1), 0);
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_insert_range)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    vector_fill_up_to(&v, 10);
+
+    int array[] = { -1, -2, -3 };
+    vector_insert_range(&v, 5, array, 3);
+
+    ck_assert_uint_eq(vector_size(&v), 13);
+    ck_assert_int_eq(*(int*) vector_get(&v, 4), 4);
+    ck_assert_int_eq(*(int*) vector_get(&v, 5), -1);
+    ck_assert_int_eq(*(int*) vector_get(&v, 7), -3);
+    ck_assert_int_eq(*(int*) vector_get(&v, 8), 5);
+    ck_assert_int_eq(*(int*) vector_get(&v, 12), 9);
+
+    vector_insert_range(&v, vector_size(&v), array, 3);
+    ck_assert_uint_eq(vector_size(&v), 16);
+    ck_assert_int_eq(*(int*) vector_get(&v, 15), -3);
+
+    vector_free(&v);
+}
+END_TEST
+
 /*
  *                                  Removal.
  */
@@ -250,6 +743,25 @@ START_TEST(test_vector_erase)
 }
 END_TEST
 
+START_TEST(test_vector_erase_range)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    vector_fill_up_to(&v, 100);
+
+    vector_erase_range(&v, 10, 80);
+    ck_assert_uint_eq(vector_size(&v), 20);
+    ck_assert_int_eq(*(int*) vector_get(&v, 9), 9);
+    ck_assert_int_eq(*(int*) vector_get(&v, 10), 90);
+
+    vector_erase_range(&v, 0, vector_size(&v));
+    ck_assert_uint_eq(vector_is_empty(&v), true);
+
+    vector_free(&v);
+}
+END_TEST
+
 /*
  *                                   Resize.
  */
@@ -273,6 +785,91 @@ START_TEST(test_vector_resize)
 }
 END_TEST
 
+START_TEST(test_vector_reserve)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    vector_reserve(&v, 1000);
+    ck_assert_uint_eq(vector_capacity(&v), 1000);
+
+    vector_fill_up_to(&v, 1000);
+    ck_assert_uint_eq(vector_capacity(&v), 1000);
+
+    vector_reserve(&v, 10);
+    ck_assert_uint_eq(vector_capacity(&v), 1000);
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_growth)
+{
+    Vector v;
+
+    vector_create(&v, sizeof(int), NULL);
+    vector_set_growth(&v, VECTOR_GROW_ONE_AND_HALF);
+    vector_fill_up_to(&v, INIT_CAPACITY + 1);
+    ck_assert_uint_eq(vector_capacity(&v), INIT_CAPACITY + INIT_CAPACITY / 2);
+    vector_free(&v);
+
+    vector_create(&v, sizeof(int), NULL);
+    vector_set_growth(&v, VECTOR_GROW_SIZE_CLASS);
+    vector_fill_up_to(&v, 1000);
+    ck_assert_uint_ge(vector_capacity(&v), 1024);
+    for (int i = 0; i < 1000; ++i)
+        ck_assert_int_eq(*(int*) vector_get(&v, i), i);
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_shrink_hysteresis)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    vector_fill_up_to(&v, 128);
+    ck_assert_uint_eq(vector_capacity(&v), 128);
+
+    /* Erasure never shrinks. */
+    vector_erase_range(&v, 0, 128);
+    ck_assert_uint_eq(vector_capacity(&v), 128);
+
+    /* Under an eighth of slack stays; more is given back. */
+    vector_fill_up_to(&v, 120);
+    vector_shrink_to_fit(&v);
+    ck_assert_uint_eq(vector_capacity(&v), 128);
+    vector_erase_range(&v, 0, 20);
+    vector_shrink_to_fit(&v);
+    ck_assert_uint_eq(vector_capacity(&v), 100);
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_shrink_reserved)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    vector_reserve(&v, 1000);
+    vector_fill_up_to(&v, 10);
+    vector_erase(&v, 0);
+    ck_assert_uint_eq(vector_capacity(&v), 1000);
+
+    /* The reserved capacity is a floor... */
+    vector_shrink_to_fit(&v);
+    ck_assert_uint_eq(vector_capacity(&v), 1000);
+
+    /* ...which an explicit resize lowers. */
+    vector_resize(&v, 500);
+    vector_shrink_to_fit(&v);
+    ck_assert_uint_eq(vector_capacity(&v), 500);
+
+    vector_free(&v);
+}
+END_TEST
+
 START_TEST(test_vector_shrink_to_fit)
 {
 
@@ -296,9 +893,311 @@ START_TEST(test_vector_clear)
 
     vector_fill_up_to(&v, 100);
 
+    size_t capacity = vector_capacity(&v);
+    void* buffer_ptr = v.buffer_ptr;
+
     vector_clear(&v);
     ck_assert_uint_eq(vector_size(&v), 0);
-    ck_assert_uint_eq(vector_capacity(&v), INIT_CAPACITY);
+    ck_assert_uint_eq(vector_capacity(&v), capacity);
+
+    /* Refilling reuses the buffer. */
+    vector_fill_up_to(&v, 100);
+    ck_assert_ptr_eq(v.buffer_ptr, buffer_ptr);
+
+    vector_free(&v);
+}
+END_TEST
+
+/*
+ *                                 Searching.
+ */
+
+START_TEST(test_vector_find)
+{
+    /* Element sizes with a SIMD kernel, and one without. */
+    static const size_t data_sizes[] = { 1, 2, 4, 8, 3 };
+
+    for (size_t k = 0; k < sizeof(data_sizes) / sizeof(data_sizes[0]); ++k) {
+        size_t data_size = data_sizes[k];
+        unsigned char elem[8] = { 0 };
+
+        Vector v;
+        vector_create(&v, data_size, NULL);
+
+        for (int i = 0; i < 101; ++i) {
+            elem[0] = (unsigned char) (i % 50);
+            if (data_size > 1)
+                elem[data_size - 1] = 0x80;
+            vector_push_back(&v, elem);
+        }
+
+        elem[0] = 49;
+        ck_assert_uint_eq(vector_find(&v, elem), 49);
+        ck_assert_uint_eq(vector_count(&v, elem), 2);
+        ck_assert_uint_eq(vector_contains(&v, elem), true);
+
+        /* The match sits in the scalar tail. */
+        elem[0] = 0;
+        ck_assert_uint_eq(vector_count(&v, elem), 3);
+
+        elem[0] = 77;
+        ck_assert_uint_eq(vector_find(&v, elem), VECTOR_NOT_FOUND);
+        ck_assert_uint_eq(vector_count(&v, elem), 0);
+        ck_assert_uint_eq(vector_contains(&v, elem), false);
+
+        vector_free(&v);
+    }
+}
+END_TEST
+
+START_TEST(test_vector_lower_bound)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    for (int i = 0; i < 100; ++i) {
+        int data = i * 2;
+        vector_push_back(&v, &data);
+    }
+
+    int data = 50;
+    ck_assert_uint_eq(vector_lower_bound(&v, &data, int_cmp), 25);
+    ck_assert_uint_eq(vector_binary_search(&v, &data, int_cmp), 25);
+
+    data = 51;
+    ck_assert_uint_eq(vector_lower_bound(&v, &data, int_cmp), 26);
+    ck_assert_uint_eq(vector_binary_search(&v, &data, int_cmp),
+                      VECTOR_NOT_FOUND);
+
+    data = -1;
+    ck_assert_uint_eq(vector_lower_bound(&v, &data, int_cmp), 0);
+
+    data = 1000;
+    ck_assert_uint_eq(vector_lower_bound(&v, &data, int_cmp), 100);
+    ck_assert_uint_eq(vector_binary_search(&v, &data, int_cmp),
+                      VECTOR_NOT_FOUND);
+
+    vector_free(&v);
+}
+END_TEST
+
+/*
+ *                                  Sorting.
+ */
+
+START_TEST(test_vector_sort)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    srand(1);
+    for (int i = 0; i < 10000; ++i) {
+        int data = rand() % 100;
+        vector_push_back(&v, &data);
+    }
+
+    vector_sort(&v, int_cmp);
+    ck_assert_uint_eq(vector_size(&v), 10000);
+    ck_assert_uint_eq(vector_is_sorted(&v, int_cmp), true);
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_sort_records)
+{
+    Vector v;
+    vector_create(&v, sizeof(Record), NULL);
+
+    for (int i = 0; i < 1000; ++i) {
+        Record record = { (i * 7919) % 1000, i };
+        vector_push_back(&v, &record);
+    }
+
+    vector_sort(&v, record_cmp);
+    ck_assert_uint_eq(vector_is_sorted(&v, record_cmp), true);
+    for (int i = 0; i < 1000; ++i)
+        ck_assert_int_eq(((Record*) vector_get(&v, i))->key, i);
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_sort_odd_size)
+{
+    Vector v;
+    vector_create(&v, 3, NULL);
+
+    for (int i = 0; i < 500; ++i) {
+        unsigned char data[3] = { (unsigned char) (255 - i % 256), 0, 0 };
+        vector_push_back(&v, data);
+    }
+
+    vector_sort(&v, byte_cmp);
+    for (size_t i = 1; i < vector_size(&v); ++i)
+        ck_assert_int_le(*(unsigned char*) vector_get(&v, i - 1),
+                         *(unsigned char*) vector_get(&v, i));
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_sort_u32)
+{
+    Vector v;
+    vector_create(&v, sizeof(uint32_t), NULL);
+
+    srand(2);
+    for (int i = 0; i < 10000; ++i) {
+        uint32_t data = (uint32_t) rand() * 2654435761u;
+        vector_push_back(&v, &data);
+    }
+
+    vector_sort_u32(&v);
+    for (size_t i = 1; i < vector_size(&v); ++i)
+        ck_assert_uint_le(*(uint32_t*) vector_get(&v, i - 1),
+                          *(uint32_t*) vector_get(&v, i));
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_sort_u64)
+{
+    Vector v;
+    vector_create(&v, sizeof(uint64_t), NULL);
+
+    for (uint64_t i = 0; i < 10000; ++i) {
+        uint64_t data = i * 0x9E3779B97F4A7C15ull;
+        vector_push_back(&v, &data);
+    }
+
+    vector_sort_u64(&v);
+    for (size_t i = 1; i < vector_size(&v); ++i)
+        ck_assert_uint_le(*(uint64_t*) vector_get(&v, i - 1),
+                          *(uint64_t*) vector_get(&v, i));
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_sort_i64_records)
+{
+    Vector v;
+    vector_create(&v, sizeof(Record), NULL);
+
+    /* Keys repeat, so the payload order also checks stability. */
+    for (int i = 0; i < 1000; ++i) {
+        Record record = { (i % 10) - 5, i };
+        vector_push_back(&v, &record);
+    }
+
+    vector_sort_i64(&v);
+    for (size_t i = 1; i < vector_size(&v); ++i) {
+        Record* a = vector_get(&v, i - 1);
+        Record* b = vector_get(&v, i);
+        ck_assert_int_le(a->key, b->key);
+        if (a->key == b->key)
+            ck_assert_int_lt(a->payload, b->payload);
+    }
+    ck_assert_int_eq(((Record*) vector_get(&v, 0))->key, -5);
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_parallel_sort)
+{
+    static const size_t thread_counts[] = { 1, 2, 3, 4, 8 };
+
+    for (size_t k = 0; k < sizeof(thread_counts) / sizeof(thread_counts[0]);
+         ++k) {
+        Vector v;
+        vector_create(&v, sizeof(Record), NULL);
+
+        /* Many equal keys exercise the merge splits on ties. */
+        int n = (int) VECTOR_PARALLEL_SORT_THRESHOLD * 2 + 7;
+        for (int i = 0; i < n; ++i) {
+            Record record = { (i * 7919) % 1000, 0 };
+            vector_push_back(&v, &record);
+        }
+
+        vector_parallel_sort(&v, record_cmp, thread_counts[k]);
+
+        ck_assert_uint_eq(vector_size(&v), (size_t) n);
+        ck_assert_uint_eq(vector_is_sorted(&v, record_cmp), true);
+
+        vector_free(&v);
+    }
+}
+END_TEST
+
+START_TEST(test_vector_parallel_sort_small)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    for (int i = 100; i > 0; --i)
+        vector_push_back(&v, &i);
+
+    vector_parallel_sort(&v, int_cmp, 0);
+    ck_assert_uint_eq(vector_is_sorted(&v, int_cmp), true);
+
+    vector_free(&v);
+}
+END_TEST
+
+/*
+ *                             Parallel iteration.
+ */
+
+START_TEST(test_vector_parallel_for)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+    vector_fill_up_to(&v, 100000);
+
+    vector_parallel_for(&v, int_square, NULL, 1000);
+
+    for (int i = 0; i < 100000; ++i)
+        ck_assert_int_eq(*(int*) vector_get(&v, i), (i % 1000) * (i % 1000));
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_parallel_for_empty)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    vector_parallel_for(&v, int_square, NULL, 0);
+    ck_assert_uint_eq(v.size, 0);
+
+    vector_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_parallel_reduce)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+    vector_fill_up_to(&v, 100000);
+
+    int64_t sum = 0;
+    vector_parallel_reduce(&v, &sum, sizeof(sum), int_sum, int64_add, NULL, 0);
+    ck_assert_int_eq(sum, (int64_t) 99999 * 100000 / 2);
+
+    /* Repeated loops reuse the same pool. */
+    sum = 0;
+    vector_parallel_reduce(&v, &sum, sizeof(sum), int_sum, int64_add, NULL, 7);
+    ck_assert_int_eq(sum, (int64_t) 99999 * 100000 / 2);
+
+    /* No result at all: the reduction works through ctx. */
+    _Atomic size_t count = 0;
+    vector_parallel_reduce(&v, NULL, 0, count_in_ctx, combine_nothing,
+                           &count, 0);
+    ck_assert_uint_eq(count, 100000);
 
     vector_free(&v);
 }
@@ -329,6 +1228,35 @@ START_TEST(test_vector_reverse)
 }
 END_TEST
 
+/*
+ *                                   Stats.
+ */
+
+START_TEST(test_vector_stats)
+{
+    Vector v;
+    vector_create(&v, sizeof(int), NULL);
+
+    vector_fill_up_to(&v, 100);
+    int data = 24;
+    vector_insert(&v, 90, &data);
+    vector_erase(&v, 0);
+    vector_resize(&v, 20);
+
+#ifdef DS_STATS
+    /* 4 -> 8 -> ... -> 128 is 5 grows, then one shrink. */
+    ck_assert_uint_eq(v.stats.reallocs, 6);
+    ck_assert_uint_eq(v.stats.grow_bytes, (4 + 8 + 16 + 32 + 64) * 4);
+    ck_assert_uint_eq(v.stats.shrink_bytes, 100 * 4);
+    ck_assert_uint_eq(v.stats.insert_bytes, 10 * 4);
+    ck_assert_uint_eq(v.stats.erase_bytes, 100 * 4);
+#endif
+    vector_stats_dump(&v);
+
+    vector_free(&v);
+}
+END_TEST
+
 Suite *vector_suite(void)
 {
     Suite* s = suite_create("Vector");
@@ -336,6 +1264,21 @@ Suite *vector_suite(void)
 
     /* Construction. */
     tcase_add_test(tc_core, test_vector_create);
+    tcase_add_test(tc_core, test_vector_create_with_allocator);
+    tcase_add_test(tc_core, test_small_vector_create);
+    tcase_add_test(tc_core, test_vector_create_inline);
+    tcase_add_test(tc_core, test_vector_mmap_threshold);
+    tcase_add_test(tc_core, test_vector_map_file);
+    tcase_add_test(tc_core, test_vector_from_buffer);
+
+    /* Destruction. */
+    tcase_add_test(tc_core, test_vector_release);
+    tcase_add_test(tc_core, test_vector_release_inline);
+
+    /* Serialization. */
+    tcase_add_test(tc_core, test_vector_write_read);
+    tcase_add_test(tc_core, test_vector_read_corrupt);
+    tcase_add_test(tc_core, test_vector_read_hostile);
 
     /* Field accessing. */
     tcase_add_test(tc_core, test_vector_size);
@@ -352,26 +1295,61 @@ Suite *vector_suite(void)
 
     /* Concatenation. */
     tcase_add_test(tc_core, test_vector_concat);
+    tcase_add_test(tc_core, test_vector_concat_self);
+    tcase_add_test(tc_core, test_vector_append_array);
 
     /* Equality. */
     tcase_add_test(tc_core, test_vector_equals);
+    tcase_add_test(tc_core, test_vector_equals_bytes);
+
+    /* Hashing. */
+    tcase_add_test(tc_core, test_vector_hash);
 
     /* Insertion. */
     tcase_add_test(tc_core, test_vector_push_back);
     tcase_add_test(tc_core, test_vector_insert);
+    tcase_add_test(tc_core, test_vector_insert_front);
+    tcase_add_test(tc_core, test_vector_insert_range);
 
     /* Removal. */
     tcase_add_test(tc_core, test_vector_pop_back);
     tcase_add_test(tc_core, test_vector_erase);
+    tcase_add_test(tc_core, test_vector_erase_range);
 
     /* Resize. */
     tcase_add_test(tc_core, test_vector_resize);
+    tcase_add_test(tc_core, test_vector_reserve);
+    tcase_add_test(tc_core, test_vector_growth);
+    tcase_add_test(tc_core, test_vector_shrink_hysteresis);
+    tcase_add_test(tc_core, test_vector_shrink_reserved);
     tcase_add_test(tc_core, test_vector_shrink_to_fit);
     tcase_add_test(tc_core, test_vector_clear);
 
+    /* Searching. */
+    tcase_add_test(tc_core, test_vector_find);
+    tcase_add_test(tc_core, test_vector_lower_bound);
+
+    /* Sorting. */
+    tcase_add_test(tc_core, test_vector_sort);
+    tcase_add_test(tc_core, test_vector_sort_records);
+    tcase_add_test(tc_core, test_vector_sort_odd_size);
+    tcase_add_test(tc_core, test_vector_sort_u32);
+    tcase_add_test(tc_core, test_vector_sort_u64);
+    tcase_add_test(tc_core, test_vector_sort_i64_records);
+    tcase_add_test(tc_core, test_vector_parallel_sort);
+    tcase_add_test(tc_core, test_vector_parallel_sort_small);
+
+    /* Parallel iteration. */
+    tcase_add_test(tc_core, test_vector_parallel_for);
+    tcase_add_test(tc_core, test_vector_parallel_for_empty);
+    tcase_add_test(tc_core, test_vector_parallel_reduce);
+
     /* Reversion. */
     tcase_add_test(tc_core, test_vector_reverse);
 
+    /* Stats. */
+    tcase_add_test(tc_core, test_vector_stats);
+
     suite_add_tcase(s, tc_core);
 
     return s;
@@ -398,6 +1376,19 @@ static int int_cmp(const void* a_ptr, const void* b_ptr)
     else return 0;
 }
 
+static int record_cmp(const void* a_ptr, const void* b_ptr)
+{
+    int64_t a_key = ((const Record*) a_ptr)->key;
+    int64_t b_key = ((const Record*) b_ptr)->key;
+
+    return (a_key > b_key) - (a_key < b_key);
+}
+
+static int byte_cmp(const void* a_ptr, const void* b_ptr)
+{
+    return *(const unsigned char*) a_ptr - *(const unsigned char*) b_ptr;
+}
+
 static void vector_fill_up_to(Vector* v, int limit)
 {
     for (int i = 0; i < limit; ++i)
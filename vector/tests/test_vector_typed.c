@@ -0,0 +1,233 @@
+#include "../src/vector_typed.h"
+
+#include <check.h>
+
+#include <stdbool.h>
+
+VECTOR_DEFINE(VectorInt, vector_int, int)
+
+static void vector_int_fill_up_to(VectorInt* v, int limit);
+
+/*
+ *                                Construction.
+ */
+
+START_TEST(test_vector_int_create)
+{
+    VectorInt v;
+    vector_int_create(&v, NULL);
+
+    ck_assert_uint_eq(v.size, 0);
+    ck_assert_uint_eq(v.capacity, VECTOR_INIT_CAPACITY);
+    ck_assert_ptr_eq(v.free_func, NULL);
+
+    vector_int_free(&v);
+}
+END_TEST
+
+/*
+ *                                  Indexing.
+ */
+
+START_TEST(test_vector_int_get_set)
+{
+    VectorInt v;
+    vector_int_create(&v, NULL);
+
+    vector_int_push_back(&v, 24);
+    ck_assert_int_eq(vector_int_get(&v, 0), 24);
+
+    vector_int_set(&v, 0, 25);
+    ck_assert_int_eq(*vector_int_at(&v, 0), 25);
+
+    vector_int_free(&v);
+}
+END_TEST
+
+/*
+ *                               Concatenation.
+ */
+
+START_TEST(test_vector_int_concat)
+{
+    VectorInt v1, v2;
+    vector_int_create(&v1, NULL);
+    vector_int_create(&v2, NULL);
+
+    vector_int_fill_up_to(&v1, 100);
+    vector_int_fill_up_to(&v2, 100);
+
+    vector_int_concat(&v1, &v2);
+    ck_assert_uint_eq(vector_int_size(&v1), 200);
+
+    for (int i = 0; i < 100; ++i)
+        ck_assert_int_eq(vector_int_get(&v1, 100 + i), i);
+
+    vector_int_free(&v1);
+    vector_int_free(&v2);
+}
+END_TEST
+
+/*
+ *                                 Insertion.
+ */
+
+START_TEST(test_vector_int_push_back)
+{
+    VectorInt v;
+    vector_int_create(&v, NULL);
+
+    vector_int_fill_up_to(&v, 100);
+
+    ck_assert_uint_eq(vector_int_size(&v), 100);
+    ck_assert_uint_eq(vector_int_capacity(&v), 128);
+    for (int i = 0; i < 100; ++i)
+        ck_assert_int_eq(vector_int_get(&v, i), i);
+
+    vector_int_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_int_insert)
+{
+    VectorInt v;
+    vector_int_create(&v, NULL);
+
+    vector_int_fill_up_to(&v, 100);
+
+    vector_int_insert(&v, 0, -1);
+    vector_int_insert(&v, 5, 24);
+
+    ck_assert_uint_eq(vector_int_size(&v), 102);
+    ck_assert_int_eq(vector_int_get(&v, 0), -1);
+    ck_assert_int_eq(vector_int_get(&v, 5), 24);
+    ck_assert_int_eq(vector_int_get(&v, 6), 4);
+
+    vector_int_free(&v);
+}
+END_TEST
+
+/*
+ *                                  Removal.
+ */
+
+START_TEST(test_vector_int_pop_back)
+{
+    VectorInt v;
+    vector_int_create(&v, NULL);
+
+    vector_int_fill_up_to(&v, 100);
+
+    ck_assert_int_eq(vector_int_pop_back(&v), 99);
+    ck_assert_uint_eq(vector_int_size(&v), 99);
+
+    vector_int_free(&v);
+}
+END_TEST
+
+START_TEST(test_vector_int_erase)
+{
+    VectorInt v;
+    vector_int_create(&v, NULL);
+
+    vector_int_fill_up_to(&v, 100);
+
+    vector_int_erase(&v, 2);
+
+    ck_assert_uint_eq(vector_int_size(&v), 99);
+    ck_assert_int_eq(vector_int_get(&v, 2), 3);
+
+    vector_int_free(&v);
+}
+END_TEST
+
+/*
+ *                                   Resize.
+ */
+
+START_TEST(test_vector_int_resize)
+{
+    VectorInt v;
+    vector_int_create(&v, NULL);
+
+    vector_int_fill_up_to(&v, 100);
+
+    vector_int_resize(&v, 1000);
+    ck_assert_uint_eq(vector_int_capacity(&v), 1000);
+
+    vector_int_resize(&v, 10);
+    ck_assert_uint_eq(vector_int_capacity(&v), 10);
+    ck_assert_uint_eq(vector_int_size(&v), 10);
+
+    vector_int_free(&v);
+}
+END_TEST
+
+/*
+ *                                 Reversion.
+ */
+
+START_TEST(test_vector_int_reverse)
+{
+    VectorInt v;
+    vector_int_create(&v, NULL);
+
+    vector_int_fill_up_to(&v, 101);
+    vector_int_reverse(&v);
+
+    for (int i = 0; i <= 100; ++i)
+        ck_assert_int_eq(vector_int_get(&v, i), 100 - i);
+
+    vector_int_free(&v);
+}
+END_TEST
+
+Suite *vector_typed_suite(void)
+{
+    Suite* s = suite_create("VectorTyped");
+    TCase* tc_core = tcase_create("Core");
+
+    /* Construction. */
+    tcase_add_test(tc_core, test_vector_int_create);
+
+    /* Indexing. */
+    tcase_add_test(tc_core, test_vector_int_get_set);
+
+    /* Concatenation. */
+    tcase_add_test(tc_core, test_vector_int_concat);
+
+    /* Insertion. */
+    tcase_add_test(tc_core, test_vector_int_push_back);
+    tcase_add_test(tc_core, test_vector_int_insert);
+
+    /* Removal. */
+    tcase_add_test(tc_core, test_vector_int_pop_back);
+    tcase_add_test(tc_core, test_vector_int_erase);
+
+    /* Resize. */
+    tcase_add_test(tc_core, test_vector_int_resize);
+
+    /* Reversion. */
+    tcase_add_test(tc_core, test_vector_int_reverse);
+
+    suite_add_tcase(s, tc_core);
+
+    return s;
+}
+
+int main(void)
+{
+    Suite* s = vector_typed_suite();
+    SRunner* runner = srunner_create(s);
+
+    srunner_run_all(runner, CK_NORMAL);
+    srunner_free(runner);
+
+    return 0;
+}
+
+static void vector_int_fill_up_to(VectorInt* v, int limit)
+{
+    for (int i = 0; i < limit; ++i)
+        vector_int_push_back(v, i);
+}